@@ -11,7 +11,7 @@ workspace "CppUtilities"
 	location "local" -- where to place obj + sln-files etc
 	targetdir "bin/%{cfg.buildcfg}" -- output directory
 	
-	configurations { "Debug", "Final" }
+	configurations { "Debug", "Final", "FinalAVX2", "FinalAVX512", "FinalAVX512VBMI2" }
 	platforms { "Static", "DLL" }
 	
 	filter { "platforms:Static" }
@@ -26,10 +26,30 @@ workspace "CppUtilities"
 		defines { "DD_DEBUG", "DEBUG" }
 		symbols "On"
 
-	filter {"configurations:Final"}
+	filter {"configurations:Final*"}
 		defines { "DD_FINAL", "FINAL", "NDEBUG" }
 		optimize "On"
 		symbols "Off"
+
+	-- SIMD paths are selected at compile time [__AVX2__ / __AVX512*__], these configurations build and test them
+	filter { "configurations:FinalAVX2" }
+		vectorextensions "AVX2"
+
+	filter { "configurations:FinalAVX512*", "toolset:msc*" }
+		buildoptions { "/arch:AVX512" }
+
+	filter { "configurations:FinalAVX512*", "toolset:not msc*" }
+		buildoptions { "-mavx512f", "-mavx512cd", "-mavx512bw", "-mavx512dq", "-mavx512vl" }
+
+	-- ice lake and later, FinalAVX512 keeps covering the avx512 paths without it
+	-- msvc has no /arch for vbmi2 and never defines __AVX512VBMI2__, its intrinsics are available regardless
+	filter { "configurations:FinalAVX512VBMI2", "toolset:msc*" }
+		defines { "__AVX512VBMI2__" }
+
+	filter { "configurations:FinalAVX512VBMI2", "toolset:not msc*" }
+		buildoptions { "-mavx512vbmi2" }
+
+	filter {}
 -- </Workspace Settings>
 
 -- <UtilityFunctions>
@@ -48,6 +68,11 @@ function DeclareTestProject(identifier)
 	files { "source/" .. identifier .. "/**" }
 	includedirs { "source/" .. identifier, "ExternalLibs/googletest/include" }		
 	links { "GoogleTest" }
+
+	-- vector configurations run the tests as part of the build, the scalar fallbacks are covered by Debug/Final
+	filter { "configurations:FinalAVX*" }
+		postbuildcommands { "\"%{cfg.buildtarget.abspath}\"" }
+	filter {}
 end
 
 function AddOneDependency(name)
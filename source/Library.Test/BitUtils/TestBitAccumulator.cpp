@@ -0,0 +1,126 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitAccumulator.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/Memory/BumpArena.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitAccumulatorFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	// worker w marks every bit where (bit * 7 + w) % stride == 0
+	static void markInParallel(BitAccumulator& accumulator, u32 stride)
+	{
+		std::vector<std::thread> threads;
+		for (u32 worker = 0; worker < accumulator.numWorkers(); ++worker)
+		{
+			threads.emplace_back([&accumulator, worker, stride]() {
+				BitAccumulator::Local& local = accumulator.local(worker);
+				for (u32 bit = 0; bit < accumulator.numBits(); ++bit)
+				{
+					if ((bit * 7 + worker) % stride == 0)
+						local.setBit(bit);
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	static void expectMarked(const BitSpan& result, u32 numWorkers, u32 stride)
+	{
+		for (u32 bit = 0; bit < result.numBits(); ++bit)
+		{
+			bool expected = false;
+			for (u32 worker = 0; worker < numWorkers; ++worker)
+				expected = expected || (bit * 7 + worker) % stride == 0;
+			ASSERT_EQ(result.getBit(bit), expected) << bit;
+		}
+	}
+};
+
+TEST_F(BitAccumulatorFixture, merge_denseAndSparseLocals)
+{
+	for (u32 numWorkers : { 1u, 3u, 5u })
+	{
+		for (u32 stride : { 5u, 4000u })
+		{
+			BitAccumulatorOptions options;
+			options.blockWords = 4;
+			BitAccumulator accumulator(20000, numWorkers, options);
+			markInParallel(accumulator, stride);
+
+			BitBuffer buffer(BitBuffer::ZeroInit, 20000);
+			BitSpan result = buffer.span();
+			accumulator.merge(result);
+			expectMarked(result, numWorkers, stride);
+		}
+	}
+}
+
+TEST_F(BitAccumulatorFixture, merge_onlyTouchedBlocksAndLocalsAreReusable)
+{
+	BitAccumulatorOptions options;
+	options.maxSparseBits = 2;
+	options.blockWords = 1;
+	BitAccumulator accumulator(64 * 100, 2, options);
+
+	for (u32 bit : { 0u, 1u, 2u, 64u * 50 })
+		accumulator.local(0).setBit(bit);
+	EXPECT_TRUE(accumulator.local(0).isDense());
+	EXPECT_EQ(accumulator.local(0).numDirtyBlocks(), 2u);
+	accumulator.local(1).setBit(64 * 99 + 5);
+
+	BitBuffer buffer(BitBuffer::ZeroInit, 64 * 100);
+	BitSpan result = buffer.span();
+	accumulator.merge(result);
+	EXPECT_EQ(result.countSetBits(), 5u);
+	EXPECT_TRUE(result.getBit(64 * 99 + 5));
+
+	// a second round must not see bits of the first one
+	accumulator.local(1).setBit(64 * 10);
+	result.clearAll();
+	accumulator.merge(result);
+	EXPECT_EQ(result.countSetBits(), 1u);
+	EXPECT_TRUE(result.getBit(64 * 10));
+}
+
+TEST_F(BitAccumulatorFixture, merge_sparseLocalsTurningDenseWithArena)
+{
+	// every local stays sparse while marking, the merge tree pushes the targets past maxSparseBits
+	BumpArena arena;
+	BitAccumulatorOptions options;
+	options.maxSparseBits = 40;
+	options.numThreads = 4;
+	const u32 numWorkers = 16;
+	BitAccumulator accumulator(64 * 100, numWorkers, options, &arena);
+
+	for (u32 worker = 0; worker < numWorkers; ++worker)
+	{
+		for (u32 i = 0; i < 30; ++i)
+			accumulator.local(worker).setBit((worker * 30 + i) * 13 % (64 * 100));
+		EXPECT_FALSE(accumulator.local(worker).isDense());
+	}
+
+	BitBuffer buffer(BitBuffer::ZeroInit, 64 * 100);
+	BitSpan result = buffer.span();
+	accumulator.merge(result);
+
+	EXPECT_EQ(result.countSetBits(), numWorkers * 30);
+	for (u32 i = 0; i < numWorkers * 30; ++i)
+		ASSERT_TRUE(result.getBit(i * 13 % (64 * 100)));
+}
+
+}
@@ -0,0 +1,133 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitArray.h>
+#include <Library/BitUtils/EnumBitSet.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+
+namespace ddahlkvist
+{
+
+// compile time validation, everything below has to be evaluated by the compiler
+static_assert(BitArray<130>::NumWords == 3);
+static_assert(BitArray<130>::DanglingMask == 0b11);
+static_assert(BitArray<128>::DanglingMask == bitword::Ones);
+static_assert(BitArray<70>{ 1, 5, 69 }.getBit(69));
+static_assert(!BitArray<70>{ 1, 5, 69 }.getBit(68));
+static_assert((BitArray<70>{ 1, 2 } | BitArray<70>{ 3 }) == BitArray<70>{ 1, 2, 3 });
+static_assert((BitArray<70>{ 1, 2 } & BitArray<70>{ 2, 3 }) == BitArray<70>{ 2 });
+static_assert((BitArray<70>{ 1, 2 } ^ BitArray<70>{ 2, 3 }) == BitArray<70>{ 1, 3 });
+static_assert((~BitArray<70>{}) == BitArray<70>::ones());
+static_assert((~BitArray<70>{}).getWord(1) == bitword::getDanglingPart(70));
+static_assert(BitArray<70>{ 1, 2, 65 }.containsAll(BitArray<70>{ 2, 65 }));
+static_assert(!BitArray<70>{ 1, 2 }.containsAll(BitArray<70>{ 2, 65 }));
+static_assert(BitArray<70>{ 1, 2 }.intersects(BitArray<70>{ 2, 65 }));
+static_assert(BitArray<70>{}.none() && BitArray<70>::ones().all());
+static_assert(sizeof(BitArray<64>) == sizeof(BitWordType));
+static_assert(sizeof(BitArray<256>) == 4 * sizeof(BitWordType));
+
+class BitArrayFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+};
+
+TEST_F(BitArrayFixture, countSetBits_ignoresNothingOutsideArray)
+{
+	BitArray<200> bits = BitArray<200>::ones();
+	ASSERT_EQ(bits.countSetBits(), 200u);
+
+	bits.clearBit(199);
+	bits.clearBit(0);
+	ASSERT_EQ(bits.countSetBits(), 198u);
+}
+
+TEST_F(BitArrayFixture, foreachSetBit_correctIndexProvided)
+{
+	BitArray<300> bits{ 3, 64, 250, 299 };
+
+	u32 counter = 0;
+	u32 indexes[8];
+	bits.foreachSetBit([&counter, &indexes](u32 bit) { indexes[counter++] = bit; });
+
+	ASSERT_EQ(counter, 4u);
+	ASSERT_EQ(indexes[0], 3u);
+	ASSERT_EQ(indexes[1], 64u);
+	ASSERT_EQ(indexes[2], 250u);
+	ASSERT_EQ(indexes[3], 299u);
+}
+
+TEST_F(BitArrayFixture, span_sharesStorage)
+{
+	BitArray<100> bits{ 7 };
+
+	BitSpan span = bits.span();
+	span.setBit(99);
+
+	ASSERT_TRUE(bits.getBit(99));
+	ASSERT_EQ(bits.constSpan().countSetBits(), 2u);
+	ASSERT_EQ(span.numBits(), 100u);
+}
+
+TEST_F(BitArrayFixture, spanOperations_matchArrayOperations)
+{
+	BitArray<150> lhs{ 1, 70, 149 };
+	BitArray<150> rhs{ 2, 70, 100 };
+	BitArray<150> viaSpan = lhs;
+
+	BitSpan span = viaSpan.span();
+	BitSpan other = rhs.span();
+	span |= other;
+
+	ASSERT_TRUE(viaSpan == (lhs | rhs));
+}
+
+enum class Component : u8
+{
+	Position,
+	Velocity,
+	Render,
+	Physics,
+	Count,
+};
+
+using ComponentSet = EnumBitSet<Component>;
+
+static_assert(ComponentSet{ Component::Position, Component::Render }.test(Component::Render));
+static_assert(!ComponentSet{ Component::Position }.test(Component::Velocity));
+static_assert(ComponentSet::all().containsAll(ComponentSet{ Component::Physics }));
+static_assert((~ComponentSet{ Component::Position }) == ComponentSet{ Component::Velocity, Component::Render, Component::Physics });
+static_assert(sizeof(ComponentSet) == sizeof(BitWordType));
+
+TEST_F(BitArrayFixture, enumBitSet_foreachValue)
+{
+	ComponentSet set{ Component::Velocity, Component::Physics };
+
+	u32 counter = 0;
+	Component values[4];
+	set.foreachValue([&counter, &values](Component value) { values[counter++] = value; });
+
+	ASSERT_EQ(counter, 2u);
+	ASSERT_EQ(set.count(), 2u);
+	ASSERT_EQ(values[0], Component::Velocity);
+	ASSERT_EQ(values[1], Component::Physics);
+}
+
+TEST_F(BitArrayFixture, enumBitSet_setAndReset)
+{
+	ComponentSet set;
+	ASSERT_TRUE(set.none());
+
+	set.set(Component::Render);
+	ASSERT_TRUE(set.test(Component::Render));
+	ASSERT_TRUE(set.intersects(ComponentSet{ Component::Render, Component::Position }));
+
+	set.reset(Component::Render);
+	ASSERT_TRUE(set.none());
+}
+
+}
@@ -1,6 +1,7 @@
 // copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
 #include <Library/BitUtils/BitBuffer.h>
 
+#include <Library/Memory/BumpArena.h>
 #include <Core/Meta/Meta.h>
 #include <Core/Types.h>
 #include <gtest/gtest.h>
@@ -106,4 +107,72 @@ TEST_F(BitBufferFixture, size_reflectsAllocatedWordCount)
 	}
 }
 
-}
\ No newline at end of file
+TEST_F(BitBufferFixture, alignment_storageIsCacheLineAligned)
+{
+	for (u32 numBits : { 1u, 65u, 1000u, 12345u })
+	{
+		BitBuffer buffer(BitBuffer::NoInit, numBits);
+		ASSERT_EQ(reinterpret_cast<uptr>(buffer.data()) % BitBuffer::Alignment, 0u);
+	}
+}
+
+TEST_F(BitBufferFixture, noInit_memoryIsNotWritten)
+{
+	const BitWordType Default = 0xBEBEBEBEBEBEBEBE;
+	alignas(64) BitWordType storage[16];
+	meta::fill_container(storage, Default);
+
+	std::pmr::monotonic_buffer_resource resource(storage, sizeof(storage), std::pmr::null_memory_resource());
+	BitBuffer buffer(BitBuffer::NoInit, 10 * NumBitsInWord, &resource);
+
+	ASSERT_EQ(buffer.data(), storage);
+	for (auto word : buffer)
+		ASSERT_EQ(word, Default);
+}
+
+TEST_F(BitBufferFixture, resource_allocationsComeFromProvidedResource)
+{
+	BumpArena arena(4096);
+	{
+		BitBuffer a(BitBuffer::ZeroInit, 1000, &arena);
+		BitBuffer b(BitBuffer::OneInit, 1000, &arena);
+
+		ASSERT_EQ(a.resource(), &arena);
+		ASSERT_GT(arena.bytesAllocated(), 0u);
+
+		for (auto word : a)
+			ASSERT_EQ(word, bitword::Zero);
+		for (auto word : b)
+			ASSERT_EQ(word, bitword::Ones);
+	}
+	arena.reset();
+	ASSERT_EQ(arena.bytesAllocated(), 0u);
+}
+
+TEST_F(BitBufferFixture, move_transfersStorage)
+{
+	BitBuffer a(BitBuffer::ZeroInit, 200);
+	BitWordType* data = a.data();
+
+	BitBuffer b = std::move(a);
+	ASSERT_EQ(b.data(), data);
+	ASSERT_EQ(b.numBits(), 200u);
+	ASSERT_EQ(a.data(), nullptr);
+	ASSERT_EQ(a.size(), 0u);
+
+	BitBuffer c(BitBuffer::ZeroInit, 10);
+	c = std::move(b);
+	ASSERT_EQ(c.data(), data);
+}
+
+TEST_F(BitBufferFixture, span_coversAllBits)
+{
+	BitBuffer buffer(BitBuffer::ZeroInit, 130);
+	BitSpan span = buffer.span();
+	span.setAll();
+
+	ASSERT_EQ(span.numBits(), 130u);
+	ASSERT_EQ(buffer.constSpan().countSetBits(), 130u);
+}
+
+}
@@ -0,0 +1,90 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitCounters.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <initializer_list>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitCountersFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	void makeInputs(u32 numInputs, u32 numBits)
+	{
+		_sets.make(numInputs, numBits, numInputs * 31 + numBits, 1, 3);
+
+		// dangling bits of an input must not be counted
+		if (bitword::hasDanglingPart(numBits))
+		{
+			for (BitBuffer& buffer : _sets.buffers)
+				*(buffer.end() - 1) |= ~bitword::getDanglingPart(numBits);
+		}
+	}
+
+	u32 naiveCount(u32 bit) const
+	{
+		u32 count = 0;
+		for (const ConstBitSpan& input : _sets.spans)
+			count += input.getBit(bit) ? 1 : 0;
+		return count;
+	}
+
+	TestRandomBitSets _sets;
+};
+
+TEST_F(BitCountersFixture, atLeast_matchesNaiveCount)
+{
+	for (u32 numInputs : { 1u, 2u, 7u, 64u })
+	{
+		for (u32 numBits : { 1u, 64u, 200u, 5000u })
+		{
+			makeInputs(numInputs, numBits);
+			BitBuffer buffer(BitBuffer::ZeroInit, numBits);
+			BitSpan result = buffer.span();
+			std::vector<u16> counts(numBits);
+
+			for (u32 k : std::initializer_list<u32>{ 0, 1, numInputs / 2, numInputs, numInputs + 1 })
+			{
+				bitcounter::atLeast(_sets.spans.data(), numInputs, k, result, counts.data());
+				for (u32 bit = 0; bit < numBits; ++bit)
+				{
+					const u32 expected = naiveCount(bit);
+					ASSERT_EQ(counts[bit], expected);
+					ASSERT_EQ(result.getBit(bit), expected >= k) << "k " << k << " bit " << bit;
+				}
+			}
+		}
+	}
+}
+
+TEST_F(BitCountersFixture, countPerPosition_splitAcrossThreads)
+{
+	makeInputs(365, 10000);
+	BitCounterOptions options;
+	options.numThreads = 4;
+	options.minWordsPerThread = 16;
+
+	std::vector<u16> counts(10000);
+	bitcounter::countPerPosition(_sets.spans.data(), 365, 10000, counts.data(), options);
+	for (u32 bit = 0; bit < 10000; ++bit)
+		ASSERT_EQ(counts[bit], naiveCount(bit));
+
+	BitBuffer buffer(BitBuffer::ZeroInit, 10000);
+	BitSpan result = buffer.span();
+	bitcounter::atLeast(_sets.spans.data(), 365, 130, result, options);
+	for (u32 bit = 0; bit < 10000; ++bit)
+		ASSERT_EQ(result.getBit(bit), counts[bit] >= 130);
+}
+
+}
@@ -0,0 +1,125 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitFileChunks.h>
+
+#include <Library/BitUtils/MappedBitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+namespace ddahlkvist
+{
+
+class BitFileChunksFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+		_pathA = testing::TempDir() + "BitFileChunksFixtureA.bits";
+		_pathB = testing::TempDir() + "BitFileChunksFixtureB.bits";
+	}
+
+	void TearDown() override {
+		std::remove(_pathA.c_str());
+		std::remove(_pathB.c_str());
+	}
+
+	static void createFile(const std::string& path, u32 numBits, u32 everyNthBit) {
+		MappedBitBuffer buffer = MappedBitBuffer::create(path.c_str(), numBits);
+		BitSpan span = buffer.span();
+		for (u32 bit = 0; bit < numBits; bit += everyNthBit)
+			span.setBit(bit);
+		buffer.flush();
+	}
+
+	std::string _pathA;
+	std::string _pathB;
+};
+
+TEST_F(BitFileChunksFixture, reader_chunksCoverAllWordsInOrder)
+{
+	const u32 NumBits = 37 * NumBitsInWord + 5;
+	createFile(_pathA, NumBits, 3);
+
+	const char* paths[] = { _pathA.c_str() };
+	BitFileChunkReader reader;
+	ASSERT_TRUE(reader.open(paths, 1, 8));
+	ASSERT_EQ(reader.numBits(), NumBits);
+	ASSERT_EQ(reader.numChunks(), 5u);
+
+	MappedBitBuffer source = MappedBitBuffer::open(_pathA.c_str(), MappedBitBuffer::Access::ReadOnly);
+
+	u32 expectedChunk = 0;
+	u32 expectedBit = 0;
+	BitFileChunk chunk;
+	while (reader.nextChunk(chunk))
+	{
+		ASSERT_EQ(chunk.chunkIndex, expectedChunk);
+		ASSERT_EQ(chunk.firstBit, expectedBit);
+
+		for (u32 i = 0; i < chunk.numWords; ++i)
+			ASSERT_EQ(chunk.words(0)[i], source.data()[chunk.firstBit / NumBitsInWord + i]);
+
+		expectedChunk++;
+		expectedBit += chunk.numBits;
+	}
+
+	ASSERT_FALSE(reader.failed());
+	ASSERT_EQ(expectedChunk, 5u);
+	ASSERT_EQ(expectedBit, NumBits);
+}
+
+TEST_F(BitFileChunksFixture, reader_rejectsMismatchingBitCounts)
+{
+	createFile(_pathA, 100, 3);
+	createFile(_pathB, 101, 3);
+
+	const char* paths[] = { _pathA.c_str(), _pathB.c_str() };
+	BitFileChunkReader reader;
+	ASSERT_FALSE(reader.open(paths, 2, 8));
+}
+
+TEST_F(BitFileChunksFixture, reader_closeBeforeConsumingAllChunks)
+{
+	createFile(_pathA, 100 * NumBitsInWord, 5);
+
+	const char* paths[] = { _pathA.c_str() };
+	BitFileChunkReader reader;
+	ASSERT_TRUE(reader.open(paths, 1, 4));
+
+	BitFileChunk chunk;
+	ASSERT_TRUE(reader.nextChunk(chunk));
+	reader.close();
+}
+
+TEST_F(BitFileChunksFixture, writer_producesMappableFile)
+{
+	const u32 NumBits = 3 * NumBitsInWord + 1;
+	BitWordType words[4] = { 1, 2, 3, bitword::Ones };
+
+	BitFileChunkWriter writer;
+	ASSERT_TRUE(writer.open(_pathA.c_str(), NumBits));
+	ASSERT_TRUE(writer.append(words, 1));
+	ASSERT_TRUE(writer.append(words + 1, 3));
+	ASSERT_TRUE(writer.finish());
+
+	MappedBitBuffer buffer = MappedBitBuffer::open(_pathA.c_str(), MappedBitBuffer::Access::ReadOnly);
+	ASSERT_TRUE(buffer.isValid());
+	ASSERT_TRUE(buffer.verifyChecksum());
+	ASSERT_EQ(buffer.data()[2], 3u);
+	ASSERT_EQ(buffer.data()[3], 1u);
+}
+
+TEST_F(BitFileChunksFixture, writer_incompleteFileIsRejected)
+{
+	BitWordType words[2] = { 1, 2 };
+
+	BitFileChunkWriter writer;
+	ASSERT_TRUE(writer.open(_pathA.c_str(), 3 * NumBitsInWord));
+	ASSERT_TRUE(writer.append(words, 2));
+	ASSERT_FALSE(writer.finish());
+
+	MappedBitBuffer buffer = MappedBitBuffer::open(_pathA.c_str(), MappedBitBuffer::Access::ReadOnly);
+	ASSERT_FALSE(buffer.isValid());
+}
+
+}
@@ -0,0 +1,126 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/BitMatrix.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitMatrixFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static bool pattern(u32 row, u32 col)
+	{
+		return ((row * 2654435761u) ^ (col * 40503u)) % 5 == 0;
+	}
+
+	static void fillPattern(BitMatrix& matrix)
+	{
+		for (u32 row = 0; row < matrix.numRows(); ++row)
+			for (u32 col = 0; col < matrix.numCols(); ++col)
+				if (pattern(row, col))
+					matrix.setBit(row, col);
+	}
+};
+
+TEST_F(BitMatrixFixture, constructor_rowsAreCacheLineAlignedAndZero)
+{
+	BitMatrix matrix(10, 65);
+	EXPECT_EQ(matrix.stride(), 8u);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(matrix.rowData(3)) % BitMatrix::Alignment, 0u);
+	EXPECT_EQ(matrix.countSetBits(), 0u);
+
+	BitMatrix wide(2, 513);
+	EXPECT_EQ(wide.stride(), 16u);
+}
+
+TEST_F(BitMatrixFixture, row_isSpanOverRowBits)
+{
+	BitMatrix matrix(4, 100);
+	matrix.row(2).setAll();
+
+	EXPECT_EQ(matrix.countSetBits(), 100u);
+	EXPECT_TRUE(matrix.getBit(2, 99));
+	EXPECT_FALSE(matrix.getBit(1, 99));
+	EXPECT_EQ(matrix.constRow(2).countSetBits(), 100u);
+
+	matrix.row(1) |= matrix.row(2);
+	EXPECT_EQ(matrix.countSetBits(), 200u);
+}
+
+TEST_F(BitMatrixFixture, transposeBitBlock64_matchesNaiveTranspose)
+{
+	u64 block[64];
+	for (u32 i = 0; i < 64; ++i)
+		block[i] = (i + 1) * 0x9E3779B97F4A7C15ull;
+
+	u64 expected[64] = {};
+	for (u32 row = 0; row < 64; ++row)
+		for (u32 col = 0; col < 64; ++col)
+			if (bitword::getBit(block[row], col))
+				bitword::setBit(expected[col], row);
+
+	transposeBitBlock64(block);
+	for (u32 i = 0; i < 64; ++i)
+		EXPECT_EQ(block[i], expected[i]);
+}
+
+TEST_F(BitMatrixFixture, transposed_swapsRowsAndColumns)
+{
+	BitMatrix matrix(200, 130);
+	fillPattern(matrix);
+
+	BitMatrix transposed = matrix.transposed();
+	ASSERT_EQ(transposed.numRows(), 130u);
+	ASSERT_EQ(transposed.numCols(), 200u);
+	EXPECT_EQ(transposed.countSetBits(), matrix.countSetBits());
+
+	for (u32 row = 0; row < 200; ++row)
+		for (u32 col = 0; col < 130; ++col)
+			ASSERT_EQ(transposed.getBit(col, row), pattern(row, col));
+
+	BitMatrix roundTrip = transposed.transposed();
+	for (u32 row = 0; row < 200; ++row)
+		EXPECT_TRUE(roundTrip.constRow(row) == matrix.constRow(row));
+}
+
+TEST_F(BitMatrixFixture, getColumn_collectsBitOfEveryRow)
+{
+	BitMatrix matrix(150, 70);
+	fillPattern(matrix);
+
+	BitBuffer buffer(BitBuffer::OneInit, 150);
+	BitSpan column = buffer.span();
+	matrix.getColumn(67, column);
+
+	for (u32 row = 0; row < 150; ++row)
+		EXPECT_EQ(column.getBit(row), pattern(row, 67));
+}
+
+TEST_F(BitMatrixFixture, countColumnBits_matchesPerRowLookups)
+{
+	BitMatrix matrix(333, 190);
+	fillPattern(matrix);
+
+	std::vector<u32> counts(190);
+	matrix.countColumnBits(counts.data());
+
+	for (u32 col = 0; col < 190; ++col)
+	{
+		u32 expected = 0;
+		for (u32 row = 0; row < 333; ++row)
+			expected += pattern(row, col) ? 1 : 0;
+		EXPECT_EQ(counts[col], expected);
+	}
+}
+
+}
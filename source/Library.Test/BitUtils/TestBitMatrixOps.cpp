@@ -0,0 +1,147 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitMatrix.h>
+#include <Library/BitUtils/BitMatrixOps.h>
+#include <Library/Memory/BumpArena.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitMatrixOpsFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static void fillRandom(BitMatrix& matrix, u32 seed, u32 oneIn)
+	{
+		TestRandom random(seed);
+		for (u32 row = 0; row < matrix.numRows(); ++row)
+		{
+			for (u32 col = 0; col < matrix.numCols(); ++col)
+			{
+				if (random.oneIn(oneIn))
+					matrix.setBit(row, col);
+			}
+		}
+	}
+
+	static void expectNaiveProduct(const BitMatrix& a, const BitMatrix& b, const BitMatrix& product)
+	{
+		for (u32 row = 0; row < a.numRows(); ++row)
+		{
+			for (u32 col = 0; col < b.numCols(); ++col)
+			{
+				bool expected = false;
+				for (u32 k = 0; k < a.numCols() && !expected; ++k)
+					expected = a.getBit(row, k) && b.getBit(k, col);
+
+				ASSERT_EQ(product.getBit(row, col), expected) << row << " " << col;
+			}
+		}
+	}
+};
+
+TEST_F(BitMatrixOpsFixture, multiply_matchesNaiveProduct)
+{
+	BitMatrix a(70, 131);
+	BitMatrix b(131, 200);
+	fillRandom(a, 1, 20);
+	fillRandom(b, 2, 15);
+
+	BitMatrix product(70, 200);
+	bitmatrix::multiply(a, b, product);
+	expectNaiveProduct(a, b, product);
+}
+
+TEST_F(BitMatrixOpsFixture, multiply_tilesAndThreadsDoNotChangeResult)
+{
+	BitMatrix a(300, 100);
+	BitMatrix b(100, 1000);
+	fillRandom(a, 3, 10);
+	fillRandom(b, 4, 30);
+
+	BitMatrix reference(300, 1000);
+	BitMatrixMultiplyOptions single;
+	single.numThreads = 1;
+	bitmatrix::multiply(a, b, reference, single);
+	expectNaiveProduct(a, b, reference);
+
+	BitMatrix tiled(300, 1000);
+	BitMatrixMultiplyOptions options;
+	options.numThreads = 4;
+	options.minRowsPerThread = 16;
+	options.colTileWords = 3;
+	bitmatrix::multiply(a, b, tiled, options);
+
+	for (u32 row = 0; row < 300; ++row)
+		EXPECT_TRUE(tiled.constRow(row) == reference.constRow(row));
+}
+
+TEST_F(BitMatrixOpsFixture, multiply_threadsWithArenaBackedOutput)
+{
+	BitMatrix a(300, 100);
+	BitMatrix b(100, 500);
+	fillRandom(a, 5, 10);
+	fillRandom(b, 6, 30);
+
+	// BumpArena is not thread safe, worker threads must not allocate from the output resource
+	BumpArena arena;
+	BitMatrix product(300, 500, &arena);
+	BitMatrixMultiplyOptions options;
+	options.numThreads = 4;
+	options.minRowsPerThread = 16;
+	bitmatrix::multiply(a, b, product, options);
+	expectNaiveProduct(a, b, product);
+}
+
+TEST_F(BitMatrixOpsFixture, transitiveClosure_chainReachesEverythingAfter)
+{
+	const u32 numNodes = 150;
+	BitMatrix graph(numNodes, numNodes);
+	for (u32 i = 0; i + 1 < numNodes; ++i)
+		graph.setBit(i, i + 1);
+
+	BitMatrix closure(numNodes, numNodes);
+	bitmatrix::transitiveClosure(graph, closure);
+
+	for (u32 from = 0; from < numNodes; ++from)
+		for (u32 to = 0; to < numNodes; ++to)
+			ASSERT_EQ(closure.getBit(from, to), to > from);
+}
+
+TEST_F(BitMatrixOpsFixture, transitiveClosure_matchesWarshall)
+{
+	const u32 numNodes = 97;
+	BitMatrix graph(numNodes, numNodes);
+	fillRandom(graph, 5, 60);
+
+	BitMatrixMultiplyOptions options;
+	options.minRowsPerThread = 8;
+	BitMatrix closure(numNodes, numNodes);
+	bitmatrix::transitiveClosure(graph, closure, options);
+
+	std::vector<std::vector<bool>> expected(numNodes, std::vector<bool>(numNodes));
+	for (u32 i = 0; i < numNodes; ++i)
+		for (u32 j = 0; j < numNodes; ++j)
+			expected[i][j] = graph.getBit(i, j);
+
+	for (u32 k = 0; k < numNodes; ++k)
+		for (u32 i = 0; i < numNodes; ++i)
+			if (expected[i][k])
+				for (u32 j = 0; j < numNodes; ++j)
+					expected[i][j] = expected[i][j] || expected[k][j];
+
+	for (u32 i = 0; i < numNodes; ++i)
+		for (u32 j = 0; j < numNodes; ++j)
+			ASSERT_EQ(closure.getBit(i, j), expected[i][j]);
+}
+
+}
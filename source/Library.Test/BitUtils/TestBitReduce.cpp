@@ -0,0 +1,92 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitReduce.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitReduceFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	// oneIn controls density so that And does not turn empty right away
+	void makeInputs(u32 numInputs, u32 numBits, u32 oneIn)
+	{
+		_sets.make(numInputs, numBits, numInputs * 17 + numBits, oneIn - 1, oneIn);
+	}
+
+	bool naiveReduce(BitReduceOp op, u32 bit) const
+	{
+		u32 count = 0;
+		for (const ConstBitSpan& input : _sets.spans)
+			count += input.getBit(bit) ? 1 : 0;
+
+		switch (op)
+		{
+		case BitReduceOp::Or: return count > 0;
+		case BitReduceOp::And: return count == _sets.spans.size();
+		case BitReduceOp::Xor: return count % 2 == 1;
+		case BitReduceOp::Majority: return count > _sets.spans.size() / 2;
+		}
+		return false;
+	}
+
+	void expectReduceMatchesNaive(u32 numInputs, u32 numBits, u32 oneIn, const BitReduceOptions& options)
+	{
+		makeInputs(numInputs, numBits, oneIn);
+		BitBuffer buffer(BitBuffer::ZeroInit, numBits);
+		BitSpan result = buffer.span();
+
+		for (BitReduceOp op : { BitReduceOp::Or, BitReduceOp::And, BitReduceOp::Xor, BitReduceOp::Majority })
+		{
+			bitreduce::reduce(op, _sets.spans.data(), numInputs, result, options);
+			for (u32 bit = 0; bit < numBits; ++bit)
+				ASSERT_EQ(result.getBit(bit), naiveReduce(op, bit)) << static_cast<u32>(op) << " bit " << bit;
+		}
+	}
+
+	TestRandomBitSets _sets;
+};
+
+TEST_F(BitReduceFixture, reduce_matchesNaive)
+{
+	for (u32 numInputs : { 1u, 2u, 5u, 9u })
+	{
+		for (u32 numBits : { 1u, 64u, 1000u })
+			expectReduceMatchesNaive(numInputs, numBits, 8, {});
+	}
+}
+
+TEST_F(BitReduceFixture, reduce_smallTilesAcrossThreads)
+{
+	BitReduceOptions options;
+	options.numThreads = 3;
+	options.minWordsPerThread = 8;
+	options.tileWords = 5;
+
+	expectReduceMatchesNaive(37, 20000, 2, options);
+}
+
+TEST_F(BitReduceFixture, reduce_noInputs)
+{
+	BitBuffer buffer(BitBuffer::ZeroInit, 100);
+	BitSpan result = buffer.span();
+
+	bitreduce::reduce(BitReduceOp::And, nullptr, 0, result);
+	EXPECT_EQ(result.countSetBits(), 100u);
+
+	bitreduce::reduce(BitReduceOp::Or, nullptr, 0, result);
+	EXPECT_EQ(result.countSetBits(), 0u);
+}
+
+}
@@ -0,0 +1,79 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitSetInterner.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitSetInternerFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static BitBuffer makeSet(u32 numBits, u32 value)
+	{
+		BitBuffer buffer(BitBuffer::ZeroInit, numBits);
+		BitSpan span = buffer.span();
+		for (u32 bit = 0; bit < 32 && bit < numBits; ++bit)
+		{
+			if ((value >> bit) & 1)
+				span.setBit(bit * numBits / 32);
+		}
+		return buffer;
+	}
+};
+
+TEST_F(BitSetInternerFixture, intern_equalValuesShareHandle)
+{
+	BitSetInterner interner(200);
+	std::vector<BitSetInterner::Handle> handles;
+
+	// more distinct values than one page and than the initial table
+	for (u32 value = 0; value < 600; ++value)
+		handles.push_back(interner.intern(makeSet(200, value).constSpan()));
+	EXPECT_EQ(interner.size(), 600u);
+
+	for (u32 value = 0; value < 600; ++value)
+	{
+		ASSERT_EQ(interner.intern(makeSet(200, value).constSpan()), handles[value]);
+		ASSERT_TRUE(interner.get(handles[value]) == makeSet(200, value).constSpan());
+	}
+	EXPECT_EQ(interner.size(), 600u);
+	EXPECT_NE(handles[1], handles[2]);
+}
+
+TEST_F(BitSetInternerFixture, intern_ignoresDanglingBits)
+{
+	BitSetInterner interner(70);
+	BitBuffer a = makeSet(70, 5);
+	BitBuffer b = makeSet(70, 5);
+	b.span().data()[1] |= ~bitword::getDanglingPart(70);
+
+	EXPECT_EQ(interner.intern(a.constSpan()), interner.intern(b.constSpan()));
+}
+
+TEST_F(BitSetInternerFixture, operations_areMemoizedAndInterned)
+{
+	BitSetInterner interner(128);
+	const BitSetInterner::Handle a = interner.intern(makeSet(128, 0b1100).constSpan());
+	const BitSetInterner::Handle b = interner.intern(makeSet(128, 0b1010).constSpan());
+
+	const BitSetInterner::Handle both = interner.intersect(a, b);
+	EXPECT_EQ(both, interner.intern(makeSet(128, 0b1000).constSpan()));
+	EXPECT_EQ(interner.unite(a, b), interner.intern(makeSet(128, 0b1110).constSpan()));
+	EXPECT_EQ(interner.subtract(a, b), interner.intern(makeSet(128, 0b0100).constSpan()));
+	EXPECT_EQ(interner.numMemoized(), 3u);
+
+	EXPECT_EQ(interner.intersect(b, a), both);
+	EXPECT_EQ(interner.numMemoized(), 3u);
+}
+
+}
@@ -0,0 +1,146 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitSetSlab.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitSetSlabFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static void fillRandom(BitSetSlab& slab, u32 seed)
+	{
+		TestRandom random(seed);
+		for (u32 row = 0; row < slab.numRows(); ++row)
+		{
+			for (u32 bit = 0; bit < slab.numBitsPerRow(); ++bit)
+			{
+				if (!random.oneIn(3))
+					slab.setBit(row, bit);
+			}
+		}
+	}
+
+	static void expectMatchesNaive(const BitSetSlab& slab, const BitBuffer& queryBuffer)
+	{
+		const ConstBitSpan query = queryBuffer.constSpan();
+		BitBuffer allBuffer(BitBuffer::ZeroInit, slab.numRows());
+		BitBuffer anyBuffer(BitBuffer::ZeroInit, slab.numRows());
+		BitBuffer noneBuffer(BitBuffer::ZeroInit, slab.numRows());
+		BitSpan all = allBuffer.span();
+		BitSpan any = anyBuffer.span();
+		BitSpan none = noneBuffer.span();
+		slab.matchAll(query, all);
+		slab.matchAny(query, any);
+		slab.matchNone(query, none);
+
+		std::vector<u32> allRows(slab.numRows());
+		const u32 numAllRows = slab.matchAll(query, allRows.data());
+		allRows.resize(numAllRows);
+
+		std::vector<u32> expectedAllRows;
+		for (u32 row = 0; row < slab.numRows(); ++row)
+		{
+			u32 numShared = 0;
+			u32 numMissing = 0;
+			for (u32 bit = 0; bit < slab.numBitsPerRow(); ++bit)
+			{
+				if (!query.getBit(bit))
+					continue;
+				if (slab.getBit(row, bit))
+					numShared++;
+				else
+					numMissing++;
+			}
+
+			ASSERT_EQ(all.getBit(row), numMissing == 0) << row;
+			ASSERT_EQ(any.getBit(row), numShared != 0) << row;
+			ASSERT_EQ(none.getBit(row), numShared == 0) << row;
+			if (numMissing == 0)
+				expectedAllRows.push_back(row);
+		}
+		EXPECT_EQ(allRows, expectedAllRows);
+	}
+};
+
+TEST_F(BitSetSlabFixture, match_bothLayoutsMatchNaive)
+{
+	for (BitSetSlab::Layout layout : { BitSetSlab::Layout::RowMajor, BitSetSlab::Layout::Transposed })
+	{
+		for (u32 numBitsPerRow : { 5u, 64u, 130u })
+		{
+			BitSetSlab slab(203, numBitsPerRow, layout);
+			fillRandom(slab, numBitsPerRow);
+
+			BitBuffer query(BitBuffer::ZeroInit, numBitsPerRow);
+			query.span().setBit(1);
+			query.span().setBit(numBitsPerRow - 1);
+			expectMatchesNaive(slab, query);
+
+			// empty query matches all rows and no row for any
+			BitBuffer emptyQuery(BitBuffer::ZeroInit, numBitsPerRow);
+			expectMatchesNaive(slab, emptyQuery);
+		}
+	}
+}
+
+TEST_F(BitSetSlabFixture, rowMajor_rowsAreSpans)
+{
+	BitSetSlab slab(10, 70);
+	slab.row(3).setBit(69);
+	slab.row(4).setAll();
+
+	EXPECT_TRUE(slab.getBit(3, 69));
+	EXPECT_FALSE(slab.getBit(2, 69));
+	EXPECT_EQ(slab.constRow(4).countSetBits(), 70u);
+	EXPECT_EQ(slab.constRow(5).countSetBits(), 0u);
+}
+
+TEST_F(BitSetSlabFixture, transposed_planesAreSpansOverRows)
+{
+	BitSetSlab slab(100, 8, BitSetSlab::Layout::Transposed);
+	slab.setBit(70, 2);
+	slab.setBit(99, 2);
+
+	EXPECT_EQ(slab.constPlane(2).countSetBits(), 2u);
+	EXPECT_TRUE(slab.constPlane(2).getBit(70));
+	EXPECT_EQ(slab.constPlane(3).countSetBits(), 0u);
+}
+
+TEST_F(BitSetSlabFixture, intersectAndCount_bothLayouts)
+{
+	for (BitSetSlab::Layout layout : { BitSetSlab::Layout::RowMajor, BitSetSlab::Layout::Transposed })
+	{
+		BitSetSlab slab(150, 100, layout);
+		fillRandom(slab, 3);
+
+		BitBuffer query(BitBuffer::ZeroInit, 100);
+		for (u32 bit = 0; bit < 100; bit += 3)
+			query.span().setBit(bit);
+
+		std::vector<u32> expected(150);
+		for (u32 row = 0; row < 150; ++row)
+		{
+			for (u32 bit = 0; bit < 100; bit += 3)
+				expected[row] += slab.getBit(row, bit) ? 1 : 0;
+		}
+
+		slab.intersectAll(query.constSpan());
+		std::vector<u32> counts(150);
+		slab.countRowBits(counts.data());
+		EXPECT_EQ(counts, expected);
+	}
+}
+
+}
@@ -524,5 +524,29 @@ TEST_F(BitSpanFixture, setBitForeachSetBit)
 	ASSERT_EQ(markedBits[6], 125u);
 }
 
+TEST_F(BitSpanFixture, constRhsOperators_ignoreDanglingBitsOfRhs)
+{
+	const u32 NumBits = 70;
+	BitWordType lhsBuffer[2] = { 0b1100, 0 };
+	const BitWordType rhsBuffer[2] = { 0b1010, ~0ull }; // dangling bits of rhs are set and must not leak
+
+	BitSpan lhs(lhsBuffer, NumBits);
+	ConstBitSpan rhs(rhsBuffer, NumBits);
+
+	lhs |= rhs;
+	EXPECT_EQ(lhsBuffer[0], 0b1110ull);
+	EXPECT_EQ(lhsBuffer[1], 0b111111ull);
+
+	lhs &= rhs;
+	EXPECT_EQ(lhsBuffer[0], 0b1010ull);
+
+	lhs ^= rhs;
+	EXPECT_EQ(lhs.countSetBits(), 0u);
+
+	lhs.assign(rhs);
+	EXPECT_EQ(lhsBuffer[0], 0b1010ull);
+	EXPECT_EQ(lhsBuffer[1], 0b111111ull);
+	EXPECT_EQ(rhsBuffer[1], ~0ull);
 }
 
+}
@@ -0,0 +1,94 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitSpanHash.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ddahlkvist
+{
+
+class BitSpanHashFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+};
+
+TEST_F(BitSpanHashFixture, hash_ignoresDanglingBits)
+{
+	BitBuffer buffer(BitBuffer::ZeroInit, 300);
+	buffer.span().setBit(17);
+	buffer.span().setBit(299);
+	const u64 expected = bitspan::hash(buffer.constSpan());
+
+	// garbage beyond numBits must neither change the hash nor be cleared [a BitSpan would clear it on construction]
+	BitWordType* last = buffer.span().data() + 4;
+	*last |= ~bitword::getDanglingPart(300);
+	EXPECT_EQ(bitspan::hash(buffer.constSpan()), expected);
+	EXPECT_EQ(*last & ~bitword::getDanglingPart(300), ~bitword::getDanglingPart(300));
+}
+
+TEST_F(BitSpanHashFixture, hash_singleBitsAndSizesAreDistinct)
+{
+	std::unordered_set<u64> hashes;
+	for (u32 numBits : { 64u, 65u, 640u })
+	{
+		BitBuffer buffer(BitBuffer::ZeroInit, numBits);
+		hashes.insert(bitspan::hash(buffer.constSpan()));
+		for (u32 bit = 0; bit < numBits; ++bit)
+		{
+			buffer.span().setBit(bit);
+			hashes.insert(bitspan::hash(buffer.constSpan()));
+			buffer.span().clearAll();
+		}
+	}
+	EXPECT_EQ(hashes.size(), 3u + 64u + 65u + 640u);
+
+	// equal words at different positions must not cancel out
+	BitBuffer a(BitBuffer::ZeroInit, 640);
+	BitBuffer b(BitBuffer::ZeroInit, 640);
+	a.span().setBit(0);
+	b.span().setBit(4 * 64);
+	EXPECT_NE(bitspan::hash(a.constSpan()), bitspan::hash(b.constSpan()));
+}
+
+TEST_F(BitSpanHashFixture, xorHash_updatesPerBit)
+{
+	BitBuffer buffer(BitBuffer::ZeroInit, 1000);
+	BitSpan span = buffer.span();
+	u64 hash = bitspan::xorHash(span.asConst());
+
+	for (u32 bit : { 3u, 999u, 64u, 3u, 500u })
+	{
+		if (span.getBit(bit))
+			bitword::clearBit(span.data()[bit / NumBitsInWord], bit % NumBitsInWord);
+		else
+			span.setBit(bit);
+
+		hash = bitspan::updateXorHash(hash, bit);
+		ASSERT_EQ(hash, bitspan::xorHash(span.asConst()));
+	}
+}
+
+TEST_F(BitSpanHashFixture, stdHash_worksAsMapKey)
+{
+	BitBuffer a(BitBuffer::ZeroInit, 100);
+	BitBuffer b(BitBuffer::ZeroInit, 100);
+	a.span().setBit(5);
+	b.span().setBit(5);
+
+	std::unordered_map<ConstBitSpan, u32> map;
+	map.emplace(a.constSpan(), 1u);
+	EXPECT_EQ(map.count(b.constSpan()), 1u);
+
+	BitArray<70> array{ 1, 69 };
+	EXPECT_EQ(std::hash<BitArray<70>>{}(array), bitspan::hash(array.constSpan()));
+}
+
+}
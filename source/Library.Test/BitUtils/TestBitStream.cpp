@@ -0,0 +1,260 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitStream.h>
+
+#include <Library/BitUtils/BitSpan.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ddahlkvist
+{
+
+class BitStreamFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+		_path = testing::TempDir() + "BitStreamFixture.bits";
+#if defined(_WIN32)
+		_fd = _open(_path.c_str(), _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		_fd = open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+		ASSERT_GE(_fd, 0);
+	}
+
+	void TearDown() override {
+#if defined(_WIN32)
+		_close(_fd);
+#else
+		close(_fd);
+#endif
+		std::remove(_path.c_str());
+	}
+
+	void rewind() {
+#if defined(_WIN32)
+		_lseeki64(_fd, 0, SEEK_SET);
+#else
+		lseek(_fd, 0, SEEK_SET);
+#endif
+	}
+
+	void corruptByte(u64 offset) {
+		u8 value = 0;
+#if defined(_WIN32)
+		_lseeki64(_fd, offset, SEEK_SET);
+		_read(_fd, &value, 1);
+		value ^= 0x10;
+		_lseeki64(_fd, offset, SEEK_SET);
+		_write(_fd, &value, 1);
+#else
+		ASSERT_EQ(pread(_fd, &value, 1, offset), 1);
+		value ^= 0x10;
+		ASSERT_EQ(pwrite(_fd, &value, 1, offset), 1);
+#endif
+	}
+
+	static std::vector<BitWordType> makePattern(u32 numBits) {
+		std::vector<BitWordType> words(bitword::getNumWordsRequired(numBits));
+		BitWordType value = 0x9E3779B97F4A7C15ull;
+		for (auto& word : words)
+		{
+			value ^= value << 13;
+			value ^= value >> 7;
+			value ^= value << 17;
+			word = value;
+		}
+		BitSpan(words.data(), numBits).clearDanglingBits();
+		return words;
+	}
+
+	std::string _path;
+	int _fd = -1;
+};
+
+TEST_F(BitStreamFixture, writeReadAll_roundTrip)
+{
+	const u32 NumBits = 100 * NumBitsInWord - 11;
+	auto input = makePattern(NumBits);
+
+	BitStreamOptions options;
+	options.wordsPerChunk = 16;
+	ASSERT_EQ(BitStreamWriter::write(_fd, ConstBitSpan(input.data(), NumBits), options), BitStreamStatus::Ok);
+	rewind();
+
+	BitStreamReader reader(_fd);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+	ASSERT_EQ(reader.numBits(), NumBits);
+
+	std::vector<BitWordType> output(input.size());
+	ASSERT_EQ(reader.readAll(output.data()), BitStreamStatus::Ok);
+	ASSERT_EQ(input, output);
+}
+
+TEST_F(BitStreamFixture, write_sizeMatchesSerializedSize)
+{
+	const u32 NumBits = 12345;
+	auto input = makePattern(NumBits);
+
+	for (bool checksums : { false, true })
+	{
+		BitStreamOptions options;
+		options.wordsPerChunk = 7;
+		options.chunkChecksums = checksums;
+
+		const s64 before = static_cast<s64>(BitStreamWriter::getSerializedSize(NumBits, options));
+#if defined(_WIN32)
+		_chsize_s(_fd, 0);
+#else
+		ASSERT_EQ(ftruncate(_fd, 0), 0);
+#endif
+		rewind();
+		ASSERT_EQ(BitStreamWriter::write(_fd, ConstBitSpan(input.data(), NumBits), options), BitStreamStatus::Ok);
+#if defined(_WIN32)
+		ASSERT_EQ(_lseeki64(_fd, 0, SEEK_CUR), before);
+#else
+		ASSERT_EQ(lseek(_fd, 0, SEEK_CUR), before);
+#endif
+	}
+}
+
+TEST_F(BitStreamFixture, write_danglingBitsAreNotSerialized)
+{
+	BitWordType input[2] = { bitword::Ones, bitword::Ones };
+	ASSERT_EQ(BitStreamWriter::write(_fd, ConstBitSpan(input, NumBitsInWord + 3)), BitStreamStatus::Ok);
+	rewind();
+
+	BitStreamReader reader(_fd);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+
+	BitWordType output[2] = {};
+	ASSERT_EQ(reader.readAll(output), BitStreamStatus::Ok);
+	ASSERT_EQ(output[0], bitword::Ones);
+	ASSERT_EQ(output[1], BitWordType{ 0b111 });
+}
+
+TEST_F(BitStreamFixture, readRange_matchesSourceBits)
+{
+	const u32 NumBits = 64 * NumBitsInWord - 5;
+	auto input = makePattern(NumBits);
+	BitSpan source(input.data(), NumBits);
+
+	BitStreamOptions options;
+	options.wordsPerChunk = 5;
+	ASSERT_EQ(BitStreamWriter::write(_fd, source.asConst(), options), BitStreamStatus::Ok);
+	rewind();
+
+	BitStreamReader reader(_fd);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+
+	const u32 ranges[][2] = { { 0, NumBits }, { 3, 61 }, { 64, 64 }, { 100, 1000 }, { 317, 2000 }, { NumBits - 70, 70 }, { 640, 1 } };
+	for (const auto& range : ranges)
+	{
+		const u32 firstBit = range[0];
+		const u32 numBits = range[1];
+		for (bool verify : { false, true })
+		{
+			std::vector<BitWordType> output(BitStreamReader::getNumWordsRequiredForRange(firstBit, numBits), bitword::Ones);
+			ASSERT_EQ(reader.readRange(firstBit, numBits, output.data(), verify), BitStreamStatus::Ok);
+
+			BitSpan result(output.data(), numBits);
+			for (u32 bit = 0; bit < numBits; ++bit)
+				ASSERT_EQ(result.getBit(bit), source.getBit(firstBit + bit));
+		}
+	}
+}
+
+TEST_F(BitStreamFixture, readRange_outOfRangeIsRejected)
+{
+	BitWordType input[2] = {};
+	ASSERT_EQ(BitStreamWriter::write(_fd, ConstBitSpan(input, 100)), BitStreamStatus::Ok);
+	rewind();
+
+	BitStreamReader reader(_fd);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+
+	BitWordType output[2];
+	ASSERT_EQ(reader.readRange(90, 11, output), BitStreamStatus::OutOfRange);
+}
+
+TEST_F(BitStreamFixture, corruption_detectedByChunkChecksum)
+{
+	const u32 NumBits = 40 * NumBitsInWord;
+	auto input = makePattern(NumBits);
+
+	BitStreamOptions options;
+	options.wordsPerChunk = 8;
+	ASSERT_EQ(BitStreamWriter::write(_fd, ConstBitSpan(input.data(), NumBits), options), BitStreamStatus::Ok);
+
+	BitStreamHeader header;
+	rewind();
+	{
+		BitStreamReader reader(_fd);
+		ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+		header = reader.header();
+	}
+
+	// flip a bit inside word 20 [third chunk]
+	corruptByte(header.getWordsOffset() + 20 * sizeof(BitWordType) + 3);
+	rewind();
+
+	BitStreamReader reader(_fd);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+
+	std::vector<BitWordType> output(input.size());
+	ASSERT_EQ(reader.readRange(0, 8 * NumBitsInWord, output.data()), BitStreamStatus::Ok);
+	ASSERT_EQ(reader.readRange(17 * NumBitsInWord, 10, output.data()), BitStreamStatus::ChecksumMismatch);
+	ASSERT_EQ(reader.readRange(17 * NumBitsInWord, 10, output.data(), false), BitStreamStatus::Ok);
+	ASSERT_EQ(reader.readAll(output.data()), BitStreamStatus::ChecksumMismatch);
+}
+
+TEST_F(BitStreamFixture, readHeader_rejectsForeignData)
+{
+	u8 garbage[64] = { 1, 2, 3 };
+#if defined(_WIN32)
+	_write(_fd, garbage, sizeof(garbage));
+#else
+	ASSERT_EQ(write(_fd, garbage, sizeof(garbage)), static_cast<ssize_t>(sizeof(garbage)));
+#endif
+	rewind();
+
+	BitStreamReader reader(_fd);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::IncompatibleHeader);
+}
+
+#if !defined(_WIN32)
+TEST_F(BitStreamFixture, readAll_worksOnPipes)
+{
+	const u32 NumBits = 300;
+	auto input = makePattern(NumBits);
+
+	int fds[2];
+	ASSERT_EQ(pipe(fds), 0);
+	ASSERT_EQ(BitStreamWriter::write(fds[1], ConstBitSpan(input.data(), NumBits)), BitStreamStatus::Ok);
+	close(fds[1]);
+
+	BitStreamReader reader(fds[0]);
+	ASSERT_EQ(reader.readHeader(), BitStreamStatus::Ok);
+
+	std::vector<BitWordType> output(input.size());
+	ASSERT_EQ(reader.readAll(output.data()), BitStreamStatus::Ok);
+	ASSERT_EQ(input, output);
+
+	BitWordType partial[1];
+	ASSERT_EQ(reader.readRange(0, 10, partial), BitStreamStatus::IoError);
+	close(fds[0]);
+}
+#endif
+
+}
@@ -0,0 +1,206 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitVector.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitVectorFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	// validates that everything between numBits and capacity is zero
+	static void assertTailIsZero(const BitVector& vector) {
+		for (u32 bit = vector.numBits(); bit < vector.capacity(); ++bit)
+			ASSERT_FALSE(bitword::getBit(vector.data()[bit / NumBitsInWord], bit % NumBitsInWord));
+	}
+
+	static std::vector<bool> makePattern(u32 numBits, u32 seed) {
+		std::vector<bool> result;
+		TestRandom random(seed);
+		for (u32 i = 0; i < numBits; ++i)
+			result.push_back(random.oneIn(2));
+		return result;
+	}
+};
+
+TEST_F(BitVectorFixture, pushBack_matchesStdVectorBool)
+{
+	auto expected = makePattern(1000, 7);
+
+	BitVector vector;
+	for (bool value : expected)
+		vector.pushBack(value);
+
+	ASSERT_EQ(vector.numBits(), 1000u);
+	for (u32 i = 0; i < 1000; ++i)
+		ASSERT_EQ(vector.getBit(i), expected[i]);
+
+	assertTailIsZero(vector);
+}
+
+TEST_F(BitVectorFixture, pushBack_capacityGrowsGeometrically)
+{
+	BitVector vector;
+
+	u32 reallocations = 0;
+	u32 capacity = vector.capacity();
+	for (u32 i = 0; i < 100000; ++i)
+	{
+		vector.pushBack(true);
+		if (vector.capacity() != capacity)
+		{
+			reallocations++;
+			capacity = vector.capacity();
+		}
+	}
+
+	ASSERT_LE(reallocations, 12u);
+	ASSERT_EQ(vector.constSpan().countSetBits(), 100000u);
+}
+
+TEST_F(BitVectorFixture, append_unalignedMatchesBitByBit)
+{
+	for (u32 prefix : { 0u, 1u, 63u, 64u, 65u, 130u })
+	{
+		for (u32 appended : { 0u, 1u, 5u, 64u, 200u })
+		{
+			auto first = makePattern(prefix, prefix + 1);
+			auto second = makePattern(appended, appended + 3);
+
+			BitVector vector;
+			for (bool value : first)
+				vector.pushBack(value);
+
+			BitVector other;
+			for (bool value : second)
+				other.pushBack(value);
+			// garbage beyond the span must not leak into the result
+			if (other.numBits() % NumBitsInWord != 0)
+				other.data()[other.numWords() - 1] |= ~bitword::getDanglingPart(other.numBits());
+
+			vector.append(other.constSpan());
+
+			ASSERT_EQ(vector.numBits(), prefix + appended);
+			for (u32 i = 0; i < prefix; ++i)
+				ASSERT_EQ(vector.getBit(i), first[i]);
+			for (u32 i = 0; i < appended; ++i)
+				ASSERT_EQ(vector.getBit(prefix + i), second[i]);
+
+			assertTailIsZero(vector);
+		}
+	}
+}
+
+TEST_F(BitVectorFixture, append_selfDoublesContents)
+{
+	for (u32 prefix : { 1u, 63u, 70u, 512u, 700u })
+	{
+		auto pattern = makePattern(prefix, prefix + 7);
+
+		BitVector vector;
+		for (bool value : pattern)
+			vector.pushBack(value);
+
+		vector.append(vector.constSpan());
+
+		ASSERT_EQ(vector.numBits(), 2 * prefix);
+		for (u32 i = 0; i < 2 * prefix; ++i)
+			ASSERT_EQ(vector.getBit(i), pattern[i % prefix]);
+
+		assertTailIsZero(vector);
+	}
+}
+
+TEST_F(BitVectorFixture, resize_growWithOnes)
+{
+	BitVector vector(3, false);
+	vector.resize(200, true);
+
+	ASSERT_EQ(vector.numBits(), 200u);
+	ASSERT_FALSE(vector.getBit(0));
+	ASSERT_FALSE(vector.getBit(2));
+	ASSERT_EQ(vector.constSpan().countSetBits(), 197u);
+	assertTailIsZero(vector);
+}
+
+TEST_F(BitVectorFixture, resize_shrinkClearsRemovedBitsInPlace)
+{
+	BitVector vector(500, true);
+	const u32 capacity = vector.capacity();
+	BitWordType* data = vector.data();
+
+	vector.resize(77);
+	ASSERT_EQ(vector.capacity(), capacity);
+	ASSERT_EQ(vector.data(), data);
+	ASSERT_EQ(vector.constSpan().countSetBits(), 77u);
+	assertTailIsZero(vector);
+
+	vector.resize(300, false);
+	ASSERT_EQ(vector.constSpan().countSetBits(), 77u);
+}
+
+TEST_F(BitVectorFixture, shrinkToFit_releasesCapacity)
+{
+	BitVector vector;
+	vector.reserve(10000);
+	vector.resize(100, true);
+
+	vector.shrinkToFit();
+	ASSERT_EQ(vector.capacity(), 2 * NumBitsInWord);
+	ASSERT_EQ(vector.constSpan().countSetBits(), 100u);
+
+	vector.clear();
+	vector.shrinkToFit();
+	ASSERT_EQ(vector.capacity(), 0u);
+	ASSERT_EQ(vector.data(), nullptr);
+}
+
+TEST_F(BitVectorFixture, popBack_clearsBit)
+{
+	BitVector vector(65, true);
+	vector.popBack();
+
+	ASSERT_EQ(vector.numBits(), 64u);
+	assertTailIsZero(vector);
+}
+
+TEST_F(BitVectorFixture, span_operationsWorkOnActiveRange)
+{
+	BitVector a(150, false);
+	BitVector b(150, false);
+	a.setBit(3);
+	b.setBit(149);
+
+	BitSpan lhs = a.span();
+	BitSpan rhs = b.span();
+	lhs |= rhs;
+
+	ASSERT_TRUE(a.getBit(3));
+	ASSERT_TRUE(a.getBit(149));
+	ASSERT_EQ(a.constSpan().countSetBits(), 2u);
+}
+
+TEST_F(BitVectorFixture, copyAndMove)
+{
+	BitVector a(100, true);
+	BitVector b = a;
+	ASSERT_NE(a.data(), b.data());
+	ASSERT_TRUE(a.constSpan() == b.constSpan());
+
+	BitWordType* data = b.data();
+	BitVector c = std::move(b);
+	ASSERT_EQ(c.data(), data);
+	ASSERT_EQ(b.numBits(), 0u);
+}
+
+}
@@ -0,0 +1,227 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BlockBloomFilter.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ddahlkvist
+{
+
+class BlockBloomFilterFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+		_path = testing::TempDir() + "BlockBloomFilterFixture.bloom";
+#if defined(_WIN32)
+		_fd = _open(_path.c_str(), _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		_fd = open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+		ASSERT_GE(_fd, 0);
+	}
+
+	void TearDown() override {
+#if defined(_WIN32)
+		_close(_fd);
+#else
+		close(_fd);
+#endif
+		std::remove(_path.c_str());
+	}
+
+	void rewind() {
+#if defined(_WIN32)
+		_lseeki64(_fd, 0, SEEK_SET);
+#else
+		lseek(_fd, 0, SEEK_SET);
+#endif
+	}
+
+	// overwrites the block count of a filter written at the start of the file, as a corrupted file would have it
+	void patchNumBlocks(u32 numBlocks) {
+		const long offset = static_cast<long>(offsetof(BloomFilterHeader, numBlocks));
+#if defined(_WIN32)
+		_lseek(_fd, offset, SEEK_SET);
+		ASSERT_EQ(_write(_fd, &numBlocks, sizeof(numBlocks)), static_cast<int>(sizeof(numBlocks)));
+#else
+		lseek(_fd, offset, SEEK_SET);
+		ASSERT_EQ(write(_fd, &numBlocks, sizeof(numBlocks)), static_cast<ssize_t>(sizeof(numBlocks)));
+#endif
+		rewind();
+	}
+
+	// splitmix64, stands in for the key hash a caller would provide
+	static u64 hashOf(u64 key)
+	{
+		key += 0x9E3779B97F4A7C15ull;
+		key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+		key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+		return key ^ (key >> 31);
+	}
+
+	static std::vector<u64> hashes(u64 firstKey, u32 numKeys)
+	{
+		std::vector<u64> result(numKeys);
+		for (u32 i = 0; i < numKeys; ++i)
+			result[i] = hashOf(firstKey + i);
+		return result;
+	}
+
+	template<typename Filter>
+	static u32 countFalsePositives(const Filter& filter, u32 numQueries)
+	{
+		u32 counter = 0;
+		for (u64 hash : hashes(1ull << 40, numQueries))
+			counter += filter.contains(hash) ? 1 : 0;
+		return counter;
+	}
+
+	std::string _path;
+	int _fd = -1;
+};
+
+TEST_F(BlockBloomFilterFixture, insert_setsOneBitPerHalfLane)
+{
+	BloomFilter256 filter(4);
+	filter.insert(hashOf(1));
+	EXPECT_EQ(filter.constSpan().countSetBits(), 8u);
+
+	BloomFilter512 wide(4);
+	wide.insert(hashOf(1));
+	EXPECT_EQ(wide.constSpan().countSetBits(), 16u);
+}
+
+TEST_F(BlockBloomFilterFixture, contains_noFalseNegativesAndLowFalsePositiveRate)
+{
+	const u32 numKeys = 20000;
+	BloomFilter256 filter(BloomFilter256::getNumBlocks(numKeys, 10));
+	BloomFilter512 wide(BloomFilter512::getNumBlocks(numKeys, 16));
+
+	for (u64 hash : hashes(0, numKeys))
+	{
+		filter.insert(hash);
+		wide.insert(hash);
+	}
+
+	for (u64 hash : hashes(0, numKeys))
+	{
+		ASSERT_TRUE(filter.contains(hash));
+		ASSERT_TRUE(wide.contains(hash));
+	}
+
+	EXPECT_LT(countFalsePositives(filter, 100000), 3000u);
+	EXPECT_LT(countFalsePositives(wide, 100000), 1000u);
+}
+
+TEST_F(BlockBloomFilterFixture, batch_matchesSingleOperations)
+{
+	const std::vector<u64> inserted = hashes(0, 1000);
+	BloomFilter512 single(BloomFilter512::getNumBlocks(1000, 8));
+	BloomFilter512 batched(BloomFilter512::getNumBlocks(1000, 8));
+
+	for (u64 hash : inserted)
+		single.insert(hash);
+	batched.insertBatch(inserted.data(), static_cast<u32>(inserted.size()));
+	EXPECT_TRUE(single.constSpan() == batched.constSpan());
+
+	const std::vector<u64> queries = hashes(500, 1001);
+	BitBuffer buffer(BitBuffer::OneInit, 1001);
+	BitSpan results = buffer.span();
+	batched.containsBatch(queries.data(), 1001, results);
+
+	for (u32 i = 0; i < 1001; ++i)
+		EXPECT_EQ(results.getBit(i), single.contains(queries[i]));
+}
+
+TEST_F(BlockBloomFilterFixture, unionWith_containsKeysOfBoth)
+{
+	BloomFilter256 a(64);
+	BloomFilter256 b(64);
+	for (u64 hash : hashes(0, 100))
+		a.insert(hash);
+	for (u64 hash : hashes(1000, 100))
+		b.insert(hash);
+
+	a.unionWith(b);
+	for (u64 hash : hashes(0, 100))
+		EXPECT_TRUE(a.contains(hash));
+	for (u64 hash : hashes(1000, 100))
+		EXPECT_TRUE(a.contains(hash));
+}
+
+TEST_F(BlockBloomFilterFixture, intersectWith_keepsCommonKeys)
+{
+	BloomFilter256 a(64);
+	BloomFilter256 b(64);
+	for (u64 hash : hashes(0, 200))
+		a.insert(hash);
+	for (u64 hash : hashes(100, 200))
+		b.insert(hash);
+
+	const u32 bitsBefore = a.constSpan().countSetBits();
+	a.intersectWith(b);
+	EXPECT_LT(a.constSpan().countSetBits(), bitsBefore);
+
+	for (u64 hash : hashes(100, 100))
+		EXPECT_TRUE(a.contains(hash));
+}
+
+TEST_F(BlockBloomFilterFixture, write_readRoundTrip)
+{
+	BloomFilter512 filter(33);
+	for (u64 hash : hashes(0, 300))
+		filter.insert(hash);
+
+	ASSERT_EQ(filter.write(_fd), BitStreamStatus::Ok);
+	rewind();
+
+	BloomFilter512 loaded(1);
+	ASSERT_EQ(BloomFilter512::read(_fd, loaded), BitStreamStatus::Ok);
+	EXPECT_EQ(loaded.numBlocks(), 33u);
+	EXPECT_TRUE(loaded.constSpan() == filter.constSpan());
+	for (u64 hash : hashes(0, 300))
+		EXPECT_TRUE(loaded.contains(hash));
+}
+
+TEST_F(BlockBloomFilterFixture, read_rejectsOtherBlockSize)
+{
+	BloomFilter512 filter(8);
+	ASSERT_EQ(filter.write(_fd), BitStreamStatus::Ok);
+	rewind();
+
+	BloomFilter256 loaded(1);
+	EXPECT_EQ(BloomFilter256::read(_fd, loaded), BitStreamStatus::IncompatibleHeader);
+	EXPECT_EQ(loaded.numBlocks(), 1u);
+}
+
+TEST_F(BlockBloomFilterFixture, read_rejectsBlockCountNotMatchingStream)
+{
+	BloomFilter512 filter(1);
+	ASSERT_EQ(filter.write(_fd), BitStreamStatus::Ok);
+
+	// (2^23 + 1) * 512 bits wraps to 512 in 32 bits
+	for (u32 numBlocks : { 0u, (1u << 23) + 1, 2u })
+	{
+		patchNumBlocks(numBlocks);
+
+		BloomFilter512 loaded(3);
+		EXPECT_EQ(BloomFilter512::read(_fd, loaded), BitStreamStatus::IncompatibleHeader) << numBlocks;
+		EXPECT_EQ(loaded.numBlocks(), 3u);
+	}
+}
+
+}
@@ -0,0 +1,76 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/ConstBitSpan.h>
+
+#include <Core/Meta/Meta.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+
+namespace ddahlkvist
+{
+
+class ConstBitSpanFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+};
+
+TEST_F(ConstBitSpanFixture, ctor_danglingBitsAreNotModified)
+{
+	const BitWordType Default = 0xBEBEBEBEBEBEBEBE;
+	BitWordType buffer[2];
+	meta::fill_container(buffer, Default);
+
+	ConstBitSpan span(buffer, NumBitsInWord + 3);
+
+	ASSERT_EQ(buffer[0], Default);
+	ASSERT_EQ(buffer[1], Default);
+	ASSERT_EQ(span.numWords(), 2u);
+}
+
+TEST_F(ConstBitSpanFixture, countSetBits_ignoresDanglingBits)
+{
+	BitWordType buffer[3];
+	meta::fill_container(buffer, bitword::Ones);
+
+	ConstBitSpan span(buffer, 2 * NumBitsInWord + 5);
+	ASSERT_EQ(span.countSetBits(), 2 * NumBitsInWord + 5);
+}
+
+TEST_F(ConstBitSpanFixture, foreachSetBit_notInvokedForDanglingBits)
+{
+	BitWordType buffer[1] = {};
+	buffer[0] |= BitWordType{ 1 } << 59;
+	buffer[0] |= BitWordType{ 1 } << 60;
+	buffer[0] |= BitWordType{ 1 } << 61;
+
+	ConstBitSpan span(buffer, 61);
+
+	u32 counter = 0;
+	u32 indexes[10];
+	span.foreachSetBit([&counter, &indexes](u32 bitIdx) { indexes[counter++] = bitIdx; });
+
+	ASSERT_EQ(counter, 2u);
+	ASSERT_EQ(indexes[0], 59u);
+	ASSERT_EQ(indexes[1], 60u);
+}
+
+TEST_F(ConstBitSpanFixture, operatorCmp_onlyLooksAtSpanBits)
+{
+	const u32 NumBits = 3 * NumBitsInWord - 17;
+	BitWordType lhs[3] = { 1, 2, 3 };
+	BitWordType rhs[3] = { 1, 2, 3 };
+
+	ASSERT_TRUE(ConstBitSpan(lhs, NumBits) == ConstBitSpan(rhs, NumBits));
+
+	rhs[2] |= bitword::Ones & ~bitword::getDanglingPart(NumBits);
+	ASSERT_TRUE(ConstBitSpan(lhs, NumBits) == ConstBitSpan(rhs, NumBits));
+
+	rhs[1] = 0;
+	ASSERT_FALSE(ConstBitSpan(lhs, NumBits) == ConstBitSpan(rhs, NumBits));
+}
+
+}
@@ -0,0 +1,164 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/MappedBitBuffer.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+namespace ddahlkvist
+{
+
+class MappedBitBufferFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+		_path = testing::TempDir() + "MappedBitBufferFixture.bits";
+	}
+
+	void TearDown() override {
+		std::remove(_path.c_str());
+	}
+
+	std::string _path;
+};
+
+TEST_F(MappedBitBufferFixture, create_allBitsCleared)
+{
+	const u32 NumBits = 10 * NumBitsInWord - 5;
+	MappedBitBuffer buffer = MappedBitBuffer::create(_path.c_str(), NumBits);
+
+	ASSERT_TRUE(buffer.isValid());
+	ASSERT_TRUE(buffer.isWritable());
+	ASSERT_EQ(buffer.numBits(), NumBits);
+	ASSERT_EQ(buffer.size(), 10 * sizeof(BitWordType));
+
+	for (auto word : buffer)
+		ASSERT_EQ(word, bitword::Zero);
+}
+
+TEST_F(MappedBitBufferFixture, flush_bitsVisibleWhenReopened)
+{
+	const u32 NumBits = 5000;
+	{
+		MappedBitBuffer buffer = MappedBitBuffer::create(_path.c_str(), NumBits);
+		BitSpan span = buffer.span();
+		span.setBit(3);
+		span.setBit(1200);
+		span.setBit(NumBits - 1);
+		ASSERT_TRUE(buffer.flush());
+	}
+
+	MappedBitBuffer buffer = MappedBitBuffer::open(_path.c_str(), MappedBitBuffer::Access::ReadOnly);
+	ASSERT_TRUE(buffer.isValid());
+	ASSERT_FALSE(buffer.isWritable());
+	ASSERT_EQ(buffer.numBits(), NumBits);
+	ASSERT_TRUE(buffer.verifyChecksum());
+
+	ConstBitSpan view = buffer.constSpan();
+	ASSERT_EQ(view.countSetBits(), 3u);
+	ASSERT_TRUE(view.getBit(3));
+	ASSERT_TRUE(view.getBit(1200));
+	ASSERT_TRUE(view.getBit(NumBits - 1));
+}
+
+TEST_F(MappedBitBufferFixture, verifyChecksum_detectsUnflushedModification)
+{
+	MappedBitBuffer buffer = MappedBitBuffer::create(_path.c_str(), 777);
+	ASSERT_TRUE(buffer.verifyChecksum());
+
+	buffer.span().setBit(17);
+	ASSERT_FALSE(buffer.verifyChecksum());
+
+	ASSERT_TRUE(buffer.flush());
+	ASSERT_TRUE(buffer.verifyChecksum());
+}
+
+TEST_F(MappedBitBufferFixture, verifyChecksum_ignoresDanglingBits)
+{
+	MappedBitBuffer buffer = MappedBitBuffer::create(_path.c_str(), 70);
+	ASSERT_TRUE(buffer.flush());
+
+	buffer.data()[1] |= BitWordType{ 1 } << 40;
+	ASSERT_TRUE(buffer.verifyChecksum());
+}
+
+TEST_F(MappedBitBufferFixture, computeBitFileChecksum_matchesVersion1Files)
+{
+	BitWordType words[12];
+	for (u32 i = 0; i < 12; ++i)
+		words[i] = BitWordType{ 0x0123456789ABCDEFull } * (i + 1);
+
+	// values written by the first version of the format, changing them requires a new BitFileHeader version
+	ASSERT_EQ(computeBitFileChecksum(words, 0), 0x9B73E7826D96E5F2ull);
+	ASSERT_EQ(computeBitFileChecksum(words, 64), 0x6DCF0C118B0616A0ull);
+	ASSERT_EQ(computeBitFileChecksum(words, 200), 0x0F1BF87CA09B247Dull);
+	ASSERT_EQ(computeBitFileChecksum(words, 7 * 64 + 5), 0x922E1E9918F30BB9ull);
+	ASSERT_EQ(computeBitFileChecksum(words, 8 * 64), 0xF49099D4A40A54E6ull);
+	ASSERT_EQ(computeBitFileChecksum(words, 11 * 64 + 63), 0x714F851BAA256CFAull);
+}
+
+TEST_F(MappedBitBufferFixture, bitFileChecksum_independentOfAppendSplit)
+{
+	BitWordType words[11];
+	for (u32 i = 0; i < 11; ++i)
+		words[i] = BitWordType{ 0x0123456789ABCDEFull } * (i + 1);
+
+	const u32 NumBits = 10 * NumBitsInWord + 5;
+	words[10] &= bitword::getDanglingPart(NumBits);
+
+	for (u32 split = 0; split <= 11; ++split)
+	{
+		BitFileChecksum checksum;
+		checksum.append(words, split);
+		checksum.append(words + split, 11 - split);
+		ASSERT_EQ(checksum.finish(NumBits), computeBitFileChecksum(words, NumBits));
+	}
+}
+
+TEST_F(MappedBitBufferFixture, open_readWriteModificationsPersist)
+{
+	{
+		MappedBitBuffer buffer = MappedBitBuffer::create(_path.c_str(), 300);
+		ASSERT_TRUE(buffer.flush());
+	}
+	{
+		MappedBitBuffer buffer = MappedBitBuffer::open(_path.c_str(), MappedBitBuffer::Access::ReadWrite);
+		ASSERT_TRUE(buffer.isWritable());
+		buffer.span().setAll();
+		ASSERT_TRUE(buffer.flush());
+	}
+
+	MappedBitBuffer buffer = MappedBitBuffer::open(_path.c_str(), MappedBitBuffer::Access::ReadOnly);
+	ASSERT_EQ(buffer.constSpan().countSetBits(), 300u);
+}
+
+TEST_F(MappedBitBufferFixture, open_missingOrForeignFileIsInvalid)
+{
+	{
+		MappedBitBuffer buffer = MappedBitBuffer::open(_path.c_str(), MappedBitBuffer::Access::ReadOnly);
+		ASSERT_FALSE(buffer.isValid());
+	}
+
+	{
+		FILE* file = std::fopen(_path.c_str(), "wb");
+		char garbage[128] = {};
+		std::fwrite(garbage, 1, sizeof(garbage), file);
+		std::fclose(file);
+
+		MappedBitBuffer buffer = MappedBitBuffer::open(_path.c_str(), MappedBitBuffer::Access::ReadOnly);
+		ASSERT_FALSE(buffer.isValid());
+	}
+}
+
+TEST_F(MappedBitBufferFixture, move_transfersOwnership)
+{
+	MappedBitBuffer a = MappedBitBuffer::create(_path.c_str(), 128);
+	MappedBitBuffer b = std::move(a);
+
+	ASSERT_FALSE(a.isValid());
+	ASSERT_TRUE(b.isValid());
+	ASSERT_EQ(b.numBits(), 128u);
+}
+
+}
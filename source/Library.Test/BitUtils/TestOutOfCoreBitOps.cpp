@@ -0,0 +1,134 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/OutOfCoreBitOps.h>
+
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/MappedBitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class OutOfCoreBitOpsFixture : public testing::Test {
+public:
+protected:
+	static constexpr u32 NumFiles = 5;
+	static constexpr u32 NumBits = 1000 * NumBitsInWord - 19;
+
+	void SetUp() override {
+		for (u32 i = 0; i < NumFiles; ++i)
+		{
+			_paths.push_back(testing::TempDir() + "OutOfCoreBitOpsFixture" + std::to_string(i) + ".bits");
+			_expected.emplace_back(bitword::getNumWordsRequired(NumBits));
+
+			MappedBitBuffer buffer = MappedBitBuffer::create(_paths.back().c_str(), NumBits);
+			BitSpan span = buffer.span();
+			BitSpan expected(_expected.back().data(), NumBits);
+			for (u32 bit = i; bit < NumBits; bit += 3 + i * 2)
+			{
+				span.setBit(bit);
+				expected.setBit(bit);
+			}
+			buffer.flush();
+		}
+		_outputPath = testing::TempDir() + "OutOfCoreBitOpsFixtureOut.bits";
+	}
+
+	void TearDown() override {
+		for (auto& path : _paths)
+			std::remove(path.c_str());
+		std::remove(_outputPath.c_str());
+	}
+
+	std::vector<const char*> inputs() const {
+		std::vector<const char*> result;
+		for (auto& path : _paths)
+			result.push_back(path.c_str());
+		return result;
+	}
+
+	std::vector<std::string> _paths;
+	std::vector<std::vector<BitWordType>> _expected;
+	std::string _outputPath;
+};
+
+TEST_F(OutOfCoreBitOpsFixture, countSetBits_matchesInMemory)
+{
+	OutOfCoreOptions options;
+	options.wordsPerChunk = 64;
+
+	for (u32 i = 0; i < NumFiles; ++i)
+	{
+		u64 result = 0;
+		ASSERT_TRUE(outofcore::countSetBits(_paths[i].c_str(), result, options));
+		ASSERT_EQ(result, BitSpan(_expected[i].data(), NumBits).countSetBits());
+	}
+}
+
+TEST_F(OutOfCoreBitOpsFixture, countSetBitsAnd_matchesInMemory)
+{
+	OutOfCoreOptions options;
+	options.wordsPerChunk = 100;
+
+	u64 result = 0;
+	ASSERT_TRUE(outofcore::countSetBitsAnd(_paths[1].c_str(), _paths[2].c_str(), result, options));
+
+	BitSpan lhs(_expected[1].data(), NumBits);
+	BitSpan rhs(_expected[2].data(), NumBits);
+	lhs &= rhs;
+	ASSERT_EQ(result, lhs.countSetBits());
+}
+
+TEST_F(OutOfCoreBitOpsFixture, combine_matchesInMemory)
+{
+	OutOfCoreOptions options;
+	options.wordsPerChunk = 33;
+
+	const outofcore::Op ops[] = { outofcore::Op::Or, outofcore::Op::And, outofcore::Op::Xor };
+	for (auto op : ops)
+	{
+		auto paths = inputs();
+		ASSERT_TRUE(outofcore::combine(op, paths.data(), NumFiles, _outputPath.c_str(), options));
+
+		std::vector<BitWordType> expectedWords = _expected[0];
+		BitSpan expected(expectedWords.data(), NumBits);
+		for (u32 i = 1; i < NumFiles; ++i)
+		{
+			BitSpan other(_expected[i].data(), NumBits);
+			if (op == outofcore::Op::Or)
+				expected |= other;
+			else if (op == outofcore::Op::And)
+				expected &= other;
+			else
+				expected ^= other;
+		}
+
+		MappedBitBuffer result = MappedBitBuffer::open(_outputPath.c_str(), MappedBitBuffer::Access::ReadOnly);
+		ASSERT_TRUE(result.isValid());
+		ASSERT_TRUE(result.verifyChecksum());
+		ASSERT_TRUE(result.constSpan() == expected.asConst());
+	}
+}
+
+TEST_F(OutOfCoreBitOpsFixture, combine_outputAliasingInputFails)
+{
+	auto paths = inputs();
+	ASSERT_FALSE(outofcore::combine(outofcore::Op::Or, paths.data(), NumFiles, _paths[2].c_str()));
+
+	MappedBitBuffer input = MappedBitBuffer::open(_paths[2].c_str(), MappedBitBuffer::Access::ReadOnly);
+	ASSERT_TRUE(input.isValid());
+	ASSERT_TRUE(input.verifyChecksum());
+	ASSERT_TRUE(input.constSpan() == ConstBitSpan(_expected[2].data(), NumBits));
+}
+
+TEST_F(OutOfCoreBitOpsFixture, missingInput_fails)
+{
+	u64 result = 0;
+	const std::string missing = testing::TempDir() + "OutOfCoreBitOpsFixtureMissing.bits";
+	ASSERT_FALSE(outofcore::countSetBits(missing.c_str(), result));
+}
+
+}
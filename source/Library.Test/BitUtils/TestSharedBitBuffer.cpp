@@ -0,0 +1,125 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/SharedBitBuffer.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class SharedBitBufferFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+		SharedBitBuffer::unlink(Name);
+	}
+
+	void TearDown() override {
+		SharedBitBuffer::unlink(Name);
+	}
+
+	static constexpr const char* Name = "/SharedBitBufferFixture";
+};
+
+TEST_F(SharedBitBufferFixture, open_seesBitsOfWriter)
+{
+	const u32 NumBits = 5000;
+	SharedBitBuffer writer = SharedBitBuffer::create(Name, NumBits);
+	ASSERT_TRUE(writer.isValid());
+	ASSERT_EQ(writer.generation(), 0u);
+
+	SharedBitBuffer reader = SharedBitBuffer::open(Name, SharedBitBuffer::Access::ReadOnly);
+	ASSERT_TRUE(reader.isValid());
+	ASSERT_FALSE(reader.isWritable());
+	ASSERT_EQ(reader.numBits(), NumBits);
+	EXPECT_EQ(reader.constSpan().countSetBits(), 0u);
+
+	writer.beginWrite();
+	writer.span().setBit(3);
+	writer.span().setBit(NumBits - 1);
+	writer.endWrite();
+
+	BitBuffer snapshot(BitBuffer::NoInit, NumBits);
+	BitSpan out = snapshot.span();
+	EXPECT_EQ(reader.readSnapshot(out), 1u);
+	EXPECT_EQ(out.countSetBits(), 2u);
+	EXPECT_TRUE(out.getBit(3));
+	EXPECT_TRUE(out.getBit(NumBits - 1));
+
+	EXPECT_FALSE(SharedBitBuffer::open("/SharedBitBufferFixtureMissing", SharedBitBuffer::Access::ReadOnly).isValid());
+}
+
+TEST_F(SharedBitBufferFixture, readSnapshot_neverSeesPartialWrite)
+{
+	// every write sets all words to the same value, a snapshot mixing two writes would have differing words
+	const u32 NumBits = 64 * 512;
+	SharedBitBuffer writer = SharedBitBuffer::create(Name, NumBits);
+	SharedBitBuffer reader = SharedBitBuffer::open(Name, SharedBitBuffer::Access::ReadOnly);
+	ASSERT_TRUE(reader.isValid());
+
+	std::atomic<bool> done{ false };
+	std::thread writerThread([&writer, &done]() {
+		for (u64 value = 1; value <= 2000; ++value)
+		{
+			writer.beginWrite();
+			for (u32 i = 0; i < 512; ++i)
+				bitword::atomicStore(writer.data() + i, value); // atomic stores only to keep the test free of data races
+			writer.endWrite();
+		}
+		done = true;
+	});
+
+	BitBuffer snapshot(BitBuffer::NoInit, NumBits);
+	BitSpan out = snapshot.span();
+	u64 lastGeneration = 0;
+	u32 numTornSnapshots = 0;
+	while (!done)
+	{
+		const u64 generation = reader.readSnapshot(out);
+		EXPECT_GE(generation, lastGeneration);
+		lastGeneration = generation;
+
+		for (u32 i = 1; i < 512; ++i)
+		{
+			if (out.data()[i] != out.data()[0])
+			{
+				++numTornSnapshots;
+				break;
+			}
+		}
+	}
+	writerThread.join();
+	EXPECT_EQ(numTornSnapshots, 0u);
+	EXPECT_EQ(reader.readSnapshot(out), 2000u);
+}
+
+TEST_F(SharedBitBufferFixture, atomicSetBit_multipleWriters)
+{
+	const u32 NumBits = 10000;
+	SharedBitBuffer buffer = SharedBitBuffer::create(Name, NumBits);
+
+	std::vector<SharedBitBuffer> writers;
+	for (u32 i = 0; i < 4; ++i)
+		writers.push_back(SharedBitBuffer::open(Name, SharedBitBuffer::Access::ReadWrite));
+
+	std::vector<std::thread> threads;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		threads.emplace_back([&writers, i, NumBits]() {
+			for (u32 bit = i; bit < NumBits; bit += 4)
+				writers[i].atomicSetBit(bit);
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	EXPECT_EQ(buffer.constSpan().countSetBits(), NumBits);
+	EXPECT_TRUE(buffer.atomicClearBit(17));
+	EXPECT_FALSE(writers[0].atomicGetBit(17));
+}
+
+}
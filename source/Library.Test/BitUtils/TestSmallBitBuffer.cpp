@@ -0,0 +1,116 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/SmallBitBuffer.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class SmallBitBufferFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+};
+
+// resource that fails every allocation, proves that inline buffers never allocate
+class NoAllocationResource final : public std::pmr::memory_resource
+{
+protected:
+	void* do_allocate(std::size_t, std::size_t) override { ADD_FAILURE(); return nullptr; }
+	void do_deallocate(void*, std::size_t, std::size_t) override { ADD_FAILURE(); }
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST_F(SmallBitBufferFixture, inline_dataLivesInsideObject)
+{
+	NoAllocationResource resource;
+	SmallBitBuffer<4> buffer(SmallBitBuffer<4>::ZeroInit, 256, &resource);
+
+	ASSERT_TRUE(buffer.isInline());
+	const u8* begin = reinterpret_cast<const u8*>(&buffer);
+	const u8* data = reinterpret_cast<const u8*>(buffer.data());
+	ASSERT_GE(data, begin);
+	ASSERT_LT(data, begin + sizeof(buffer));
+
+	for (auto word : buffer)
+		ASSERT_EQ(word, bitword::Zero);
+}
+
+TEST_F(SmallBitBufferFixture, spill_largerSizesUseHeap)
+{
+	SmallBitBuffer<4> buffer(SmallBitBuffer<4>::OneInit, 257);
+
+	ASSERT_FALSE(buffer.isInline());
+	ASSERT_EQ(buffer.size(), 5 * sizeof(BitWordType));
+	ASSERT_EQ(reinterpret_cast<uptr>(buffer.data()) % SmallBitBuffer<4>::Alignment, 0u);
+
+	for (auto word : buffer)
+		ASSERT_EQ(word, bitword::Ones);
+}
+
+TEST_F(SmallBitBufferFixture, move_inlineDoesNotAllocate)
+{
+	NoAllocationResource resource;
+	SmallBitBuffer<2> a(SmallBitBuffer<2>::ZeroInit, 100, &resource);
+	a.span().setBit(77);
+
+	SmallBitBuffer<2> b = std::move(a);
+	ASSERT_TRUE(b.isInline());
+	ASSERT_TRUE(b.span().getBit(77));
+	ASSERT_EQ(b.data(), b.begin());
+	ASSERT_EQ(a.numBits(), 0u);
+}
+
+TEST_F(SmallBitBufferFixture, move_heapStealsStorage)
+{
+	SmallBitBuffer<2> a(SmallBitBuffer<2>::ZeroInit, 1000);
+	BitWordType* data = a.data();
+
+	SmallBitBuffer<2> b(SmallBitBuffer<2>::ZeroInit, 10);
+	b = std::move(a);
+
+	ASSERT_EQ(b.data(), data);
+	ASSERT_EQ(b.numBits(), 1000u);
+}
+
+TEST_F(SmallBitBufferFixture, copy_producesIndependentBuffer)
+{
+	for (u32 numBits : { 100u, 1000u })
+	{
+		SmallBitBuffer<2> a(SmallBitBuffer<2>::ZeroInit, numBits);
+		a.span().setBit(42);
+
+		SmallBitBuffer<2> b = a;
+		ASSERT_NE(a.data(), b.data());
+		ASSERT_TRUE(b.span().getBit(42));
+
+		b.span().setBit(43);
+		ASSERT_FALSE(a.span().getBit(43));
+	}
+}
+
+TEST_F(SmallBitBufferFixture, vector_inlineMasksAreContiguous)
+{
+	using Mask = SmallBitBuffer<4>;
+	std::vector<Mask> masks;
+	for (u32 i = 0; i < 64; ++i)
+	{
+		masks.emplace_back(Mask::ZeroInit, 200);
+		masks.back().span().setBit(i);
+	}
+
+	for (u32 i = 0; i < 64; ++i)
+	{
+		ASSERT_TRUE(masks[i].isInline());
+		ASSERT_EQ(masks[i].constSpan().countSetBits(), 1u);
+		ASSERT_TRUE(masks[i].constSpan().getBit(i));
+	}
+}
+
+}
@@ -0,0 +1,157 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/BitUtils/VectorWord.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+static_assert(NumBitsIn<u8> == 8);
+static_assert(NumBitsIn<BitWord512> == 512);
+static_assert(bitword::getNumWordsRequired<u16>(17) == 2);
+static_assert(bitword::getNumWordsRequired<BitWord256>(257) == 2);
+static_assert(bitword::getDanglingPart<u8>(11) == 0b111);
+static_assert(bitword::getDanglingPart<BitWord128>(66) == BitWord128{ { ~0ull, 0b11 } });
+static_assert(bitword::OnesOf<BitWord256> == ~bitword::ZeroOf<BitWord256>);
+
+class VectorWordFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	// sets the same pseudo random bits in a span of any word type
+	template<typename Word>
+	static void fillPattern(BasicBitSpan<Word>& span, u32 seed)
+	{
+		span.clearAll();
+		for (u32 i = 0; i < span.numBits(); ++i)
+			if (((i * 2654435761u) ^ seed) % 3 == 0)
+				span.setBit(i);
+	}
+
+	template<typename Word>
+	static std::vector<u32> setBitsOf(BasicBitSpan<Word>& span)
+	{
+		std::vector<u32> bits;
+		span.foreachSetBit([&bits](u32 bit) { bits.push_back(bit); });
+		return bits;
+	}
+
+	// applies the same operations through a span of Word and through the default span, results have to match
+	template<typename Word>
+	static void expectSameAsDefaultWord(u32 numBits)
+	{
+		BasicBitBuffer<Word> a(BasicBitBuffer<Word>::ZeroInit, numBits);
+		BasicBitBuffer<Word> b(BasicBitBuffer<Word>::ZeroInit, numBits);
+		BitBuffer referenceA(BitBuffer::ZeroInit, numBits);
+		BitBuffer referenceB(BitBuffer::ZeroInit, numBits);
+
+		BasicBitSpan<Word> spanA = a.span();
+		BasicBitSpan<Word> spanB = b.span();
+		BitSpan refA = referenceA.span();
+		BitSpan refB = referenceB.span();
+
+		fillPattern(spanA, 1);
+		fillPattern(spanB, 2);
+		fillPattern(refA, 1);
+		fillPattern(refB, 2);
+		EXPECT_EQ(spanA.countSetBits(), refA.countSetBits());
+
+		spanA |= spanB;
+		refA |= refB;
+		EXPECT_EQ(setBitsOf(spanA), setBitsOf(refA));
+
+		spanA ^= spanB;
+		refA ^= refB;
+		EXPECT_EQ(setBitsOf(spanA), setBitsOf(refA));
+
+		spanA.setAll();
+		refA.setAll();
+		spanA &= spanB;
+		refA &= refB;
+		EXPECT_EQ(setBitsOf(spanA), setBitsOf(refA));
+		EXPECT_EQ(spanA.countSetBits(), refA.countSetBits());
+		EXPECT_TRUE(spanA == spanB);
+		EXPECT_EQ(a.constSpan().countSetBits(), referenceA.constSpan().countSetBits());
+	}
+};
+
+TEST_F(VectorWordFixture, lowBits_spansLanes)
+{
+	BitWord256 word = BitWord256::lowBits(130);
+	EXPECT_EQ(word.lanes[0], ~0ull);
+	EXPECT_EQ(word.lanes[1], ~0ull);
+	EXPECT_EQ(word.lanes[2], 0b11ull);
+	EXPECT_EQ(word.lanes[3], 0ull);
+	EXPECT_EQ(word.countSetBits(), 130u);
+}
+
+TEST_F(VectorWordFixture, setBit_updatesCorrectLane)
+{
+	BitWord512 word{};
+	bitword::setBit(word, 0);
+	bitword::setBit(word, 300);
+	bitword::setBit(word, 511);
+
+	EXPECT_TRUE(bitword::getBit(word, 300));
+	EXPECT_FALSE(bitword::getBit(word, 301));
+	EXPECT_EQ(word.lanes[300 / 64], 1ull << (300 % 64));
+	EXPECT_EQ(bitword::countSetBits(word), 3u);
+
+	bitword::clearBit(word, 300);
+	EXPECT_EQ(bitword::countSetBits(word), 2u);
+}
+
+TEST_F(VectorWordFixture, foreachOne_reportsBitsInOrder)
+{
+	BitWord256 word{};
+	word.setBit(3);
+	word.setBit(64);
+	word.setBit(255);
+
+	std::vector<u32> bits;
+	bitword::foreachOne([&bits](u32 bit) { bits.push_back(bit); }, word, 1000);
+	EXPECT_EQ(bits, (std::vector<u32>{ 1003, 1064, 1255 }));
+}
+
+TEST_F(VectorWordFixture, bitBuffer_vectorWordIsAlignedToWordSize)
+{
+	BasicBitBuffer<BitWord512> buffer(BasicBitBuffer<BitWord512>::ZeroInit, 1000);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % alignof(BitWord512), 0u);
+	EXPECT_EQ(buffer.size(), 2 * sizeof(BitWord512));
+}
+
+TEST_F(VectorWordFixture, span_danglingBitsAreClearedForEveryWordType)
+{
+	BasicBitBuffer<u8> bytes(BasicBitBuffer<u8>::OneInit, 13);
+	EXPECT_EQ(bytes.span().countSetBits(), 13u);
+
+	BasicBitBuffer<BitWord256> wide(BasicBitBuffer<BitWord256>::OneInit, 300);
+	EXPECT_EQ(wide.span().countSetBits(), 300u);
+	EXPECT_EQ(wide.data()[1].lanes[0], (1ull << 44) - 1);
+}
+
+TEST_F(VectorWordFixture, span_allWordTypesMatchDefaultWord)
+{
+	for (u32 numBits : { 1u, 63u, 64u, 65u, 255u, 256u, 511u, 1000u, 4097u })
+	{
+		expectSameAsDefaultWord<u8>(numBits);
+		expectSameAsDefaultWord<u16>(numBits);
+		expectSameAsDefaultWord<u32>(numBits);
+		expectSameAsDefaultWord<u64>(numBits);
+		expectSameAsDefaultWord<BitWord128>(numBits);
+		expectSameAsDefaultWord<BitWord256>(numBits);
+		expectSameAsDefaultWord<BitWord512>(numBits);
+	}
+}
+
+}
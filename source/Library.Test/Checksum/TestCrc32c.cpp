@@ -0,0 +1,34 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Checksum/Crc32c.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace ddahlkvist
+{
+
+TEST(crc32c_tests, knownVector)
+{
+	const char* input = "123456789";
+	ASSERT_EQ(crc32c(input, strlen(input)), 0xE3069283u);
+}
+
+TEST(crc32c_tests, emptyInput)
+{
+	ASSERT_EQ(crc32c(nullptr, 0), 0u);
+}
+
+TEST(crc32c_tests, chainedEqualsSingleCall)
+{
+	u8 data[1000];
+	for (u32 i = 0; i < 1000; ++i)
+		data[i] = static_cast<u8>(i * 31 + 7);
+
+	const u32 whole = crc32c(data, sizeof(data));
+	const u32 chained = crc32c(data + 333, sizeof(data) - 333, crc32c(data, 333));
+
+	ASSERT_EQ(whole, chained);
+}
+
+}
@@ -0,0 +1,165 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Graph/DirectionOptimizingBfs.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class DirectionOptimizingBfsFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	struct CsrStorage
+	{
+		std::vector<u32> offsets;
+		std::vector<u32> targets;
+
+		CsrGraph graph() const { return CsrGraph{ offsets.data(), targets.data(), static_cast<u32>(offsets.size() - 1) }; }
+	};
+
+	static CsrStorage buildCsr(u32 numNodes, const std::vector<std::pair<u32, u32>>& edges)
+	{
+		CsrStorage storage;
+		storage.offsets.assign(numNodes + 1, 0);
+		for (const auto& edge : edges)
+			storage.offsets[edge.first + 1]++;
+		for (u32 i = 0; i < numNodes; ++i)
+			storage.offsets[i + 1] += storage.offsets[i];
+
+		std::vector<u32> cursor(storage.offsets.begin(), storage.offsets.end() - 1);
+		storage.targets.resize(edges.size());
+		for (const auto& edge : edges)
+			storage.targets[cursor[edge.first]++] = edge.second;
+		return storage;
+	}
+
+	// preferential attachment style edges, a few hubs and many low degree nodes
+	static std::vector<std::pair<u32, u32>> randomEdges(u32 numNodes, u32 edgesPerNode, u32 seed)
+	{
+		std::vector<std::pair<u32, u32>> edges;
+		TestRandom random(seed);
+		for (u32 node = 1; node < numNodes; ++node)
+		{
+			for (u32 i = 0; i < edgesPerNode; ++i)
+			{
+				const u32 target = edges.empty() || random.oneIn(2) ? random.below(node) : edges[random.below(static_cast<u32>(edges.size()))].second;
+				edges.emplace_back(node, target);
+			}
+		}
+		return edges;
+	}
+
+	static std::vector<u32> referenceDepths(const CsrGraph& graph, u32 source)
+	{
+		std::vector<u32> depths(graph.numNodes, DirectionOptimizingBfs::Unreached);
+		std::queue<u32> queue;
+		depths[source] = 0;
+		queue.push(source);
+
+		while (!queue.empty())
+		{
+			const u32 node = queue.front();
+			queue.pop();
+			for (u32 edge = graph.offsets[node]; edge < graph.offsets[node + 1]; ++edge)
+			{
+				const u32 target = graph.targets[edge];
+				if (depths[target] == DirectionOptimizingBfs::Unreached)
+				{
+					depths[target] = depths[node] + 1;
+					queue.push(target);
+				}
+			}
+		}
+		return depths;
+	}
+
+	static std::vector<std::pair<u32, u32>> symmetric(std::vector<std::pair<u32, u32>> edges)
+	{
+		const usize numEdges = edges.size();
+		for (usize i = 0; i < numEdges; ++i)
+			edges.emplace_back(edges[i].second, edges[i].first);
+		return edges;
+	}
+};
+
+TEST_F(DirectionOptimizingBfsFixture, run_pathGraphDepthsAreDistances)
+{
+	std::vector<std::pair<u32, u32>> edges;
+	for (u32 i = 0; i + 1 < 100; ++i)
+		edges.emplace_back(i, i + 1);
+	const CsrStorage storage = buildCsr(100, symmetric(edges));
+
+	DirectionOptimizingBfs bfs(storage.graph(), storage.graph());
+	std::vector<u32> depths(100);
+	EXPECT_EQ(bfs.run(0, depths.data()), 100u);
+
+	for (u32 i = 0; i < 100; ++i)
+		EXPECT_EQ(depths[i], i);
+}
+
+TEST_F(DirectionOptimizingBfsFixture, run_scaleFreeGraphMatchesQueueBfs)
+{
+	const u32 numNodes = 20000;
+	const CsrStorage storage = buildCsr(numNodes, symmetric(randomEdges(numNodes, 4, 7)));
+
+	BfsOptions options;
+	options.minWordsPerThread = 16;
+	DirectionOptimizingBfs bfs(storage.graph(), storage.graph(), options);
+
+	std::vector<u32> depths(numNodes);
+	const u32 numReached = bfs.run(123, depths.data());
+
+	EXPECT_EQ(depths, referenceDepths(storage.graph(), 123));
+	EXPECT_EQ(numReached, bfs.visited().countSetBits());
+	EXPECT_GT(bfs.numBottomUpSteps(), 0u);
+	EXPECT_GT(bfs.numTopDownSteps(), 0u);
+}
+
+TEST_F(DirectionOptimizingBfsFixture, run_directedGraphUsesIncomingEdgesBottomUp)
+{
+	const u32 numNodes = 5000;
+	std::vector<std::pair<u32, u32>> edges = randomEdges(numNodes, 3, 11);
+	std::vector<std::pair<u32, u32>> reversed;
+	for (const auto& edge : edges)
+		reversed.emplace_back(edge.second, edge.first);
+
+	// edges point from new to old nodes, searching from an old node uses the reversed direction
+	const CsrStorage outgoing = buildCsr(numNodes, reversed);
+	const CsrStorage incoming = buildCsr(numNodes, edges);
+
+	BfsOptions options;
+	options.alpha = 1000; // switch to bottom-up as early as possible
+	options.minWordsPerThread = 4;
+	DirectionOptimizingBfs bfs(outgoing.graph(), incoming.graph(), options);
+
+	std::vector<u32> depths(numNodes);
+	bfs.run(0, depths.data());
+	EXPECT_EQ(depths, referenceDepths(outgoing.graph(), 0));
+	EXPECT_GT(bfs.numBottomUpSteps(), 0u);
+}
+
+TEST_F(DirectionOptimizingBfsFixture, run_unreachableNodesAreMarked)
+{
+	const CsrStorage storage = buildCsr(130, symmetric({ { 0, 1 }, { 1, 2 }, { 100, 129 } }));
+
+	DirectionOptimizingBfs bfs(storage.graph(), storage.graph());
+	std::vector<u32> depths(130);
+	EXPECT_EQ(bfs.run(1, depths.data()), 3u);
+	EXPECT_EQ(depths[0], 1u);
+	EXPECT_EQ(depths[2], 1u);
+	EXPECT_EQ(depths[129], DirectionOptimizingBfs::Unreached);
+	EXPECT_FALSE(bfs.visited().getBit(100));
+}
+
+}
@@ -0,0 +1,100 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/ArchetypeMatcher.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <algorithm>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class ArchetypeMatcherFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static void addRandomArchetypes(ArchetypeMatcher& matcher, std::vector<std::vector<u32>>& archetypes, u32 numArchetypes, u32 seed)
+	{
+		TestRandom random(seed);
+		for (u32 i = 0; i < numArchetypes; ++i)
+		{
+			std::vector<u32> components;
+			for (u32 component = 0; component < matcher.numComponents(); ++component)
+			{
+				if (random.oneIn(4))
+					components.push_back(component);
+			}
+			matcher.addArchetype(components.data(), static_cast<u32>(components.size()));
+			archetypes.push_back(std::move(components));
+		}
+	}
+
+	static std::vector<u32> naiveMatches(const std::vector<std::vector<u32>>& archetypes, const ArchetypeQuery& query)
+	{
+		auto has = [](const std::vector<u32>& components, u32 component) { return std::find(components.begin(), components.end(), component) != components.end(); };
+
+		std::vector<u32> result;
+		for (u32 archetype = 0; archetype < archetypes.size(); ++archetype)
+		{
+			const std::vector<u32>& components = archetypes[archetype];
+			bool match = std::all_of(query.all.begin(), query.all.end(), [&](u32 c) { return has(components, c); });
+			match = match && std::none_of(query.none.begin(), query.none.end(), [&](u32 c) { return has(components, c); });
+			match = match && (query.any.empty() || std::any_of(query.any.begin(), query.any.end(), [&](u32 c) { return has(components, c); }));
+			if (match)
+				result.push_back(archetype);
+		}
+		return result;
+	}
+};
+
+TEST_F(ArchetypeMatcherFixture, matches_matchNaiveForNarrowAndWideSignatures)
+{
+	for (u32 numComponents : { 16u, 64u, 150u })
+	{
+		ArchetypeMatcher matcher(numComponents);
+		std::vector<std::vector<u32>> archetypes;
+		addRandomArchetypes(matcher, archetypes, 301, numComponents);
+
+		ArchetypeQuery query;
+		query.all = { 1, numComponents - 1 };
+		query.any = { 2, 3, 5 };
+		query.none = { 7 };
+
+		std::vector<u32> evaluated(matcher.numArchetypes());
+		evaluated.resize(matcher.evaluate(query, evaluated.data()));
+
+		const ArchetypeMatcher::QueryId id = matcher.addQuery(query);
+		EXPECT_EQ(matcher.matches(id), naiveMatches(archetypes, query));
+		EXPECT_EQ(evaluated, naiveMatches(archetypes, query));
+	}
+}
+
+TEST_F(ArchetypeMatcherFixture, matches_extendedWithNewArchetypes)
+{
+	ArchetypeMatcher matcher(40);
+	std::vector<std::vector<u32>> archetypes;
+
+	ArchetypeQuery query;
+	query.all = { 0 };
+	query.none = { 1 };
+	const ArchetypeMatcher::QueryId id = matcher.addQuery(query);
+	EXPECT_TRUE(matcher.matches(id).empty());
+
+	addRandomArchetypes(matcher, archetypes, 50, 3);
+	EXPECT_EQ(matcher.matches(id), naiveMatches(archetypes, query));
+
+	addRandomArchetypes(matcher, archetypes, 37, 4);
+	EXPECT_EQ(matcher.matches(id), naiveMatches(archetypes, query));
+
+	ArchetypeQuery emptyQuery;
+	const ArchetypeMatcher::QueryId everything = matcher.addQuery(emptyQuery);
+	EXPECT_EQ(matcher.matches(everything).size(), 87u);
+}
+
+}
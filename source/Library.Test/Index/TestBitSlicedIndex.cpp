@@ -0,0 +1,163 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/BitSlicedIndex.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitSlicedIndexFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static std::vector<u64> randomValues(u32 numRows, u64 maxValue, u32 seed)
+	{
+		std::vector<u64> values(numRows);
+		u64 state = seed;
+		for (u64& value : values)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			value = (state >> 20) % (maxValue + 1);
+		}
+		return values;
+	}
+
+	static bool evaluate(BitSlicedIndex::Compare op, u64 value, u64 constant)
+	{
+		switch (op)
+		{
+		case BitSlicedIndex::Compare::Less: return value < constant;
+		case BitSlicedIndex::Compare::LessOrEqual: return value <= constant;
+		case BitSlicedIndex::Compare::Equal: return value == constant;
+		case BitSlicedIndex::Compare::NotEqual: return value != constant;
+		case BitSlicedIndex::Compare::GreaterOrEqual: return value >= constant;
+		case BitSlicedIndex::Compare::Greater: return value > constant;
+		}
+		return false;
+	}
+};
+
+TEST_F(BitSlicedIndexFixture, append_valuesCanBeReadBack)
+{
+	BitSlicedIndex index(12);
+	const std::vector<u64> values = randomValues(300, 4095, 1);
+	index.append(values.data(), 200);
+	for (u32 i = 200; i < 300; ++i)
+		index.append(values[i]);
+
+	ASSERT_EQ(index.numRows(), 300u);
+	for (u32 row = 0; row < 300; ++row)
+		EXPECT_EQ(index.getValue(row), values[row]);
+}
+
+TEST_F(BitSlicedIndexFixture, compare_matchesScalarComparison)
+{
+	BitSlicedIndex index(10);
+	const std::vector<u64> values = randomValues(777, 1023, 2);
+	index.append(values.data(), static_cast<u32>(values.size()));
+
+	BitBuffer buffer(BitBuffer::NoInit, 777);
+	BitSpan result = buffer.span();
+
+	const BitSlicedIndex::Compare ops[] = { BitSlicedIndex::Compare::Less, BitSlicedIndex::Compare::LessOrEqual, BitSlicedIndex::Compare::Equal,
+		BitSlicedIndex::Compare::NotEqual, BitSlicedIndex::Compare::GreaterOrEqual, BitSlicedIndex::Compare::Greater };
+
+	for (BitSlicedIndex::Compare op : ops)
+	{
+		for (u64 constant : { 0ull, 1ull, values[5], 512ull, 1023ull, 1024ull, 5000ull })
+		{
+			index.compare(op, constant, result);
+			for (u32 row = 0; row < 777; ++row)
+				ASSERT_EQ(result.getBit(row), evaluate(op, values[row], constant)) << static_cast<int>(op) << " " << constant;
+		}
+	}
+}
+
+TEST_F(BitSlicedIndexFixture, sum_matchesScalarSumUnderFilter)
+{
+	BitSlicedIndex index(20);
+	const std::vector<u64> values = randomValues(1000, (1 << 20) - 1, 3);
+	index.append(values.data(), 1000);
+
+	BitBuffer filterBuffer(BitBuffer::ZeroInit, 1000);
+	BitSpan filter = filterBuffer.span();
+	u64 expected = 0;
+	u64 expectedAll = 0;
+	for (u32 row = 0; row < 1000; ++row)
+	{
+		expectedAll += values[row];
+		if (row % 3 == 0)
+		{
+			filter.setBit(row);
+			expected += values[row];
+		}
+	}
+
+	EXPECT_EQ(index.sum(), expectedAll);
+	EXPECT_EQ(index.sum(filter.asConst()), expected);
+}
+
+TEST_F(BitSlicedIndexFixture, topK_selectsLargestValues)
+{
+	BitSlicedIndex index(8);
+	const std::vector<u64> values = randomValues(500, 255, 4);
+	index.append(values.data(), 500);
+
+	BitBuffer buffer(BitBuffer::NoInit, 500);
+	BitSpan result = buffer.span();
+
+	for (u32 k : { 0u, 1u, 10u, 77u, 499u, 500u })
+	{
+		index.topK(k, result);
+		ASSERT_EQ(result.countSetBits(), k);
+
+		// every selected value is at least as large as every value left out
+		u64 minSelected = ~0ull;
+		u64 maxRejected = 0;
+		for (u32 row = 0; row < 500; ++row)
+		{
+			if (result.getBit(row))
+				minSelected = std::min(minSelected, values[row]);
+			else
+				maxRejected = std::max(maxRejected, values[row]);
+		}
+
+		if (k > 0 && k < 500)
+		{
+			EXPECT_GE(minSelected, maxRejected);
+		}
+	}
+}
+
+TEST_F(BitSlicedIndexFixture, topK_onlyConsidersFilteredRowsAndBreaksTiesByRow)
+{
+	BitSlicedIndex index(4);
+	const std::vector<u64> values = { 9, 3, 15, 7, 7, 7, 15 };
+	index.append(values.data(), 7);
+
+	BitBuffer filterBuffer(BitBuffer::OneInit, 7);
+	BitSpan filter = filterBuffer.span();
+	filter.clearAll();
+	for (u32 row : { 1u, 3u, 4u, 5u, 6u })
+		filter.setBit(row);
+
+	BitBuffer buffer(BitBuffer::NoInit, 7);
+	BitSpan result = buffer.span();
+	index.topK(3, filter.asConst(), result);
+
+	EXPECT_TRUE(result.getBit(6));
+	EXPECT_TRUE(result.getBit(3));
+	EXPECT_TRUE(result.getBit(4));
+	EXPECT_EQ(result.countSetBits(), 3u);
+}
+
+}
@@ -0,0 +1,135 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/BitmapIndex.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <algorithm>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class BitmapIndexFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	static std::vector<u32> randomColumn(u32 numRows, u32 cardinality, u32 seed)
+	{
+		std::vector<u32> values(numRows);
+		TestRandom random(seed);
+		for (u32& value : values)
+			value = random.below(cardinality);
+		return values;
+	}
+
+	// every between query of the index is compared against a scan of the column
+	static void expectMatchesScan(const BitmapIndex& index, const std::vector<u32>& values)
+	{
+		ASSERT_EQ(index.numRows(), values.size());
+		BitBuffer buffer(BitBuffer::OneInit, index.numRows());
+		BitSpan result = buffer.span();
+
+		for (u32 low = 0; low < index.cardinality(); ++low)
+		{
+			for (u32 high = low; high < index.cardinality() + 1; ++high)
+			{
+				index.between(low, high, result);
+				for (u32 row = 0; row < values.size(); ++row)
+					ASSERT_EQ(result.getBit(row), values[row] >= low && values[row] <= high) << low << " " << high << " " << row;
+			}
+		}
+	}
+};
+
+TEST_F(BitmapIndexFixture, equalityEncoding_oneBitmapPerValue)
+{
+	BitmapIndex index(5, BitmapIndex::Encoding::Equality);
+	const std::vector<u32> values = { 0, 4, 2, 2, 1 };
+	index.append(values.data(), 5);
+
+	EXPECT_EQ(index.numBitmaps(), 5u);
+	EXPECT_EQ(index.bitmap(2).countSetBits(), 2u);
+	EXPECT_TRUE(index.bitmap(4).getBit(1));
+}
+
+TEST_F(BitmapIndexFixture, rangeEncoding_bitmapsAreCumulative)
+{
+	BitmapIndex index(5, BitmapIndex::Encoding::Range);
+	const std::vector<u32> values = { 0, 4, 2, 2, 1 };
+	index.append(values.data(), 5);
+
+	EXPECT_EQ(index.numBitmaps(), 4u);
+	EXPECT_EQ(index.bitmap(0).countSetBits(), 1u);
+	EXPECT_EQ(index.bitmap(1).countSetBits(), 2u);
+	EXPECT_EQ(index.bitmap(3).countSetBits(), 4u);
+}
+
+TEST_F(BitmapIndexFixture, between_equalityEncodingMatchesScan)
+{
+	const std::vector<u32> values = randomColumn(1000, 13, 1);
+	BitmapIndex index(13, BitmapIndex::Encoding::Equality);
+	index.append(values.data(), static_cast<u32>(values.size()));
+	expectMatchesScan(index, values);
+}
+
+TEST_F(BitmapIndexFixture, between_rangeEncodingMatchesScan)
+{
+	const std::vector<u32> values = randomColumn(1000, 13, 2);
+	BitmapIndex index(13, BitmapIndex::Encoding::Range);
+	index.append(values.data(), static_cast<u32>(values.size()));
+	expectMatchesScan(index, values);
+}
+
+TEST_F(BitmapIndexFixture, append_incrementalBatchesMatchSingleBuild)
+{
+	const std::vector<u32> values = randomColumn(517, 7, 3);
+
+	for (BitmapIndex::Encoding encoding : { BitmapIndex::Encoding::Equality, BitmapIndex::Encoding::Range })
+	{
+		BitmapIndex index(7, encoding);
+		u32 row = 0;
+		for (u32 batch = 1; row < values.size(); ++batch)
+		{
+			const u32 count = std::min<u32>(batch * 3, static_cast<u32>(values.size()) - row);
+			index.append(values.data() + row, count);
+			row += count;
+		}
+		index.append(4);
+
+		std::vector<u32> expected = values;
+		expected.push_back(4);
+		expectMatchesScan(index, expected);
+	}
+}
+
+TEST_F(BitmapIndexFixture, predicates_emptyAndOutOfDomainRanges)
+{
+	BitmapIndex index(4, BitmapIndex::Encoding::Range);
+	const std::vector<u32> values = { 3, 1, 0 };
+	index.append(values.data(), 3);
+
+	BitBuffer buffer(BitBuffer::ZeroInit, 3);
+	BitSpan result = buffer.span();
+
+	index.between(2, 1, result);
+	EXPECT_EQ(result.countSetBits(), 0u);
+
+	index.greaterOrEqual(1, result);
+	EXPECT_EQ(result.countSetBits(), 2u);
+
+	index.lessOrEqual(100, result);
+	EXPECT_EQ(result.countSetBits(), 3u);
+
+	index.equals(3, result);
+	EXPECT_TRUE(result.getBit(0));
+	EXPECT_EQ(result.countSetBits(), 1u);
+}
+
+}
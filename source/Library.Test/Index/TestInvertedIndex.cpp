@@ -0,0 +1,159 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/InvertedIndex.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <algorithm>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class InvertedIndexFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+		// tag t is carried by roughly one item in (t * t + 1), the first tags are dense and the last ones sparse
+		_tags.resize(NumTags);
+		TestRandom random(17);
+		for (u32 tag = 0; tag < NumTags; ++tag)
+		{
+			for (u32 item = 0; item < NumItems; ++item)
+			{
+				if (random.oneIn(tag * tag + 1))
+					_tags[tag].push_back(item);
+			}
+			_index.setTag(tag, _tags[tag].data(), static_cast<u32>(_tags[tag].size()));
+		}
+	}
+
+	void TearDown() override {
+	}
+
+	bool hasTag(u32 tag, u32 item) const
+	{
+		const std::vector<u32>& items = _tags[tag];
+		return std::binary_search(items.begin(), items.end(), item);
+	}
+
+	std::vector<u32> scan(const TagQuery& query) const
+	{
+		std::vector<u32> result;
+		for (u32 item = 0; item < NumItems; ++item)
+		{
+			bool match = true;
+			for (u32 tag : query.all)
+				match = match && hasTag(tag, item);
+			for (const std::vector<u32>& group : query.any)
+			{
+				bool anyMatch = false;
+				for (u32 tag : group)
+					anyMatch = anyMatch || hasTag(tag, item);
+				match = match && anyMatch;
+			}
+			for (u32 tag : query.none)
+				match = match && !hasTag(tag, item);
+
+			if (match)
+				result.push_back(item);
+		}
+		return result;
+	}
+
+	void expectMatchesScan(const TagQuery& query)
+	{
+		const std::vector<u32> expected = scan(query);
+
+		BitBuffer buffer(BitBuffer::OneInit, NumItems);
+		BitSpan result = buffer.span();
+		EXPECT_EQ(_index.evaluate(query, result), expected.size());
+
+		std::vector<u32> fromSpan;
+		result.foreachSetBit([&fromSpan](u32 item) { fromSpan.push_back(item); });
+		EXPECT_EQ(fromSpan, expected);
+
+		std::vector<u32> items(NumItems);
+		const u32 numItems = _index.evaluate(query, items.data(), NumItems);
+		items.resize(numItems);
+		EXPECT_EQ(items, expected);
+	}
+
+	static constexpr u32 NumItems = 20000;
+	static constexpr u32 NumTags = 24;
+
+	InvertedIndex _index{ NumItems, NumTags };
+	std::vector<std::vector<u32>> _tags;
+};
+
+TEST_F(InvertedIndexFixture, setTag_representationFollowsDensity)
+{
+	EXPECT_TRUE(_index.isDense(0));
+	EXPECT_TRUE(_index.isDense(2));
+	EXPECT_FALSE(_index.isDense(NumTags - 1));
+	EXPECT_EQ(_index.cardinality(0), NumItems);
+}
+
+TEST_F(InvertedIndexFixture, evaluate_denseConjunctionMatchesScan)
+{
+	expectMatchesScan(TagQuery{ { 1, 2, 3 }, {}, {} });
+	expectMatchesScan(TagQuery{ { 3, 1 }, { { 2, 4 } }, { 5 } });
+}
+
+TEST_F(InvertedIndexFixture, evaluate_sparseDriverMatchesScan)
+{
+	expectMatchesScan(TagQuery{ { 1, 20 }, {}, {} });
+	expectMatchesScan(TagQuery{ { 2, 23, 1 }, { { 3, 22 } }, { 21, 4 } });
+	expectMatchesScan(TagQuery{ { 22, 23 }, {}, {} });
+}
+
+TEST_F(InvertedIndexFixture, evaluate_orAndNotOnlyQueries)
+{
+	expectMatchesScan(TagQuery{ {}, { { 21, 22, 23 } }, {} });
+	expectMatchesScan(TagQuery{ {}, { { 2, 23 }, { 3, 4 } }, { 20 } });
+	expectMatchesScan(TagQuery{ {}, {}, { 1, 23 } });
+}
+
+TEST_F(InvertedIndexFixture, evaluate_emptyTagShortCircuits)
+{
+	InvertedIndex index(1000, 2);
+	const u32 items[] = { 1, 2, 3 };
+	index.setTag(0, items, 3);
+
+	BitBuffer buffer(BitBuffer::OneInit, 1000);
+	BitSpan result = buffer.span();
+	EXPECT_EQ(index.evaluate(TagQuery{ { 0, 1 }, {}, {} }, result), 0u);
+	EXPECT_EQ(result.countSetBits(), 0u);
+	EXPECT_EQ(index.evaluate(TagQuery{ { 0 }, { { 1 } }, {} }, result), 0u);
+}
+
+TEST_F(InvertedIndexFixture, evaluate_limitReturnsLowestItems)
+{
+	for (const TagQuery& query : { TagQuery{ { 1, 2 }, {}, {} }, TagQuery{ { 22 }, {}, { 3 } } })
+	{
+		const std::vector<u32> expected = scan(query);
+		ASSERT_GT(expected.size(), 5u);
+
+		u32 items[5];
+		ASSERT_EQ(_index.evaluate(query, items, 5), 5u);
+		for (u32 i = 0; i < 5; ++i)
+			EXPECT_EQ(items[i], expected[i]);
+	}
+}
+
+TEST_F(InvertedIndexFixture, setTag_fromBitSpanMatchesItemList)
+{
+	BitBuffer buffer(BitBuffer::ZeroInit, NumItems);
+	BitSpan bits = buffer.span();
+	for (u32 item : _tags[20])
+		bits.setBit(item);
+
+	_index.setTag(0, bits.asConst());
+	EXPECT_EQ(_index.cardinality(0), _tags[20].size());
+	EXPECT_FALSE(_index.isDense(0));
+	_tags[0] = _tags[20];
+	expectMatchesScan(TagQuery{ { 0, 2 }, {}, {} });
+}
+
+}
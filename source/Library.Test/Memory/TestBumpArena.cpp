@@ -0,0 +1,62 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Memory/BumpArena.h>
+
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+
+namespace ddahlkvist
+{
+
+class BumpArenaFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+};
+
+TEST_F(BumpArenaFixture, allocate_respectsAlignment)
+{
+	BumpArena arena(1024);
+
+	for (usize alignment : { 1u, 8u, 16u, 64u })
+	{
+		void* p = arena.allocate(3, alignment);
+		ASSERT_EQ(reinterpret_cast<uptr>(p) % alignment, 0u);
+	}
+}
+
+TEST_F(BumpArenaFixture, allocate_consecutiveAllocationsDoNotOverlap)
+{
+	BumpArena arena(256);
+
+	u8* a = static_cast<u8*>(arena.allocate(100, 8));
+	u8* b = static_cast<u8*>(arena.allocate(100, 8));
+	u8* c = static_cast<u8*>(arena.allocate(100, 8)); // does not fit first block
+
+	ASSERT_GE(b, a + 100);
+	ASSERT_TRUE(c >= b + 100 || c + 100 <= a);
+	ASSERT_EQ(arena.bytesAllocated(), 300u);
+}
+
+TEST_F(BumpArenaFixture, reset_reusesBlocks)
+{
+	BumpArena arena(256);
+
+	void* first = arena.allocate(200, 64);
+	ASSERT_NE(arena.allocate(200, 64), nullptr);
+	ASSERT_NE(arena.allocate(5000, 64), nullptr);
+	const usize capacity = arena.capacity();
+
+	arena.reset();
+	ASSERT_EQ(arena.bytesAllocated(), 0u);
+
+	ASSERT_EQ(arena.allocate(200, 64), first);
+	ASSERT_NE(arena.allocate(200, 64), nullptr);
+	ASSERT_NE(arena.allocate(5000, 64), nullptr);
+	ASSERT_EQ(arena.capacity(), capacity);
+}
+
+}
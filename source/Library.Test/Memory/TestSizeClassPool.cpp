@@ -0,0 +1,69 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Memory/SizeClassPool.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+
+namespace ddahlkvist
+{
+
+class SizeClassPoolFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+};
+
+TEST_F(SizeClassPoolFixture, getSizeClass_roundsUpToPowerOfTwo)
+{
+	ASSERT_EQ(SizeClassPool::getSizeClass(1), 0u);
+	ASSERT_EQ(SizeClassPool::getSizeClass(64), 0u);
+	ASSERT_EQ(SizeClassPool::getSizeClass(65), 1u);
+	ASSERT_EQ(SizeClassPool::getSizeClass(128), 1u);
+	ASSERT_EQ(SizeClassPool::getSizeClass(129), 2u);
+	ASSERT_EQ(SizeClassPool::getSizeClass(SizeClassPool::MaxPooledSize), SizeClassPool::NumClasses - 1);
+}
+
+TEST_F(SizeClassPoolFixture, deallocate_memoryIsRecycledWithinClass)
+{
+	SizeClassPool pool;
+
+	void* a = pool.allocate(100, 64);
+	pool.deallocate(a, 100, 64);
+	ASSERT_EQ(pool.numPooled(), 1u);
+
+	void* b = pool.allocate(120, 64); // same class as 100
+	ASSERT_EQ(a, b);
+	ASSERT_EQ(pool.numPooled(), 0u);
+	pool.deallocate(b, 120, 64);
+}
+
+TEST_F(SizeClassPoolFixture, bitBuffers_recycleSameSizedStorage)
+{
+	SizeClassPool pool;
+
+	BitWordType* first = nullptr;
+	{
+		BitBuffer buffer(BitBuffer::ZeroInit, 1000, &pool);
+		first = buffer.data();
+	}
+
+	BitBuffer buffer(BitBuffer::ZeroInit, 1000, &pool);
+	ASSERT_EQ(buffer.data(), first);
+	ASSERT_EQ(reinterpret_cast<uptr>(buffer.data()) % BitBuffer::Alignment, 0u);
+}
+
+TEST_F(SizeClassPoolFixture, largeAllocations_bypassPool)
+{
+	SizeClassPool pool;
+
+	void* p = pool.allocate(SizeClassPool::MaxPooledSize + 1, 64);
+	pool.deallocate(p, SizeClassPool::MaxPooledSize + 1, 64);
+	ASSERT_EQ(pool.numPooled(), 0u);
+}
+
+}
@@ -0,0 +1,125 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Scan/ColumnPredicate.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class ColumnPredicateFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	// small value range so that equality and both range ends get hit, plus the type extremes
+	template<typename T>
+	static std::vector<T> makeValues(u32 numValues)
+	{
+		std::vector<T> values(numValues);
+		TestRandom random(99);
+		for (u32 i = 0; i < numValues; ++i)
+			values[i] = static_cast<T>(random.below(20));
+		if (numValues > 7)
+		{
+			values[3] = std::numeric_limits<T>::max();
+			values[7] = std::numeric_limits<T>::lowest();
+		}
+		return values;
+	}
+
+	template<typename T>
+	static bool evaluate(predicate::Compare op, T value, T constant)
+	{
+		switch (op)
+		{
+		case predicate::Compare::Equal: return value == constant;
+		case predicate::Compare::NotEqual: return value != constant;
+		case predicate::Compare::Less: return value < constant;
+		case predicate::Compare::LessOrEqual: return value <= constant;
+		case predicate::Compare::Greater: return value > constant;
+		case predicate::Compare::GreaterOrEqual: return value >= constant;
+		}
+		return false;
+	}
+
+	template<typename T>
+	static void expectAllPredicatesMatchScalar()
+	{
+		const predicate::Compare ops[] = { predicate::Compare::Equal, predicate::Compare::NotEqual, predicate::Compare::Less,
+			predicate::Compare::LessOrEqual, predicate::Compare::Greater, predicate::Compare::GreaterOrEqual };
+
+		for (u32 numValues : { 1u, 63u, 64u, 200u, 1000u })
+		{
+			const std::vector<T> values = makeValues<T>(numValues);
+			BitBuffer buffer(BitBuffer::OneInit, numValues);
+			BitSpan result = buffer.span();
+
+			for (predicate::Compare op : ops)
+			{
+				for (T constant : { static_cast<T>(0), static_cast<T>(7), std::numeric_limits<T>::max() })
+				{
+					predicate::compare(values.data(), op, constant, result);
+					for (u32 i = 0; i < numValues; ++i)
+						ASSERT_EQ(result.getBit(i), evaluate(op, values[i], constant)) << i;
+				}
+			}
+
+			predicate::between(values.data(), static_cast<T>(5), static_cast<T>(9), result);
+			for (u32 i = 0; i < numValues; ++i)
+				ASSERT_EQ(result.getBit(i), values[i] >= 5 && values[i] <= 9);
+
+			const T set[] = { 2, 11, std::numeric_limits<T>::max() };
+			predicate::inSet(values.data(), set, 3, result);
+			for (u32 i = 0; i < numValues; ++i)
+				ASSERT_EQ(result.getBit(i), values[i] == set[0] || values[i] == set[1] || values[i] == set[2]);
+		}
+	}
+};
+
+TEST_F(ColumnPredicateFixture, compare_u8) { expectAllPredicatesMatchScalar<u8>(); }
+TEST_F(ColumnPredicateFixture, compare_u16) { expectAllPredicatesMatchScalar<u16>(); }
+TEST_F(ColumnPredicateFixture, compare_u32) { expectAllPredicatesMatchScalar<u32>(); }
+TEST_F(ColumnPredicateFixture, compare_u64) { expectAllPredicatesMatchScalar<u64>(); }
+TEST_F(ColumnPredicateFixture, compare_float) { expectAllPredicatesMatchScalar<float>(); }
+TEST_F(ColumnPredicateFixture, compare_double) { expectAllPredicatesMatchScalar<double>(); }
+
+TEST_F(ColumnPredicateFixture, combineAnd_mergesIntoSelection)
+{
+	const std::vector<u32> values = makeValues<u32>(300);
+	BitBuffer buffer(BitBuffer::ZeroInit, 300);
+	BitSpan selection = buffer.span();
+	for (u32 i = 0; i < 300; i += 2)
+		selection.setBit(i);
+
+	predicate::compare(values.data(), predicate::Compare::Less, 10u, selection, predicate::Combine::And);
+	for (u32 i = 0; i < 300; ++i)
+		ASSERT_EQ(selection.getBit(i), i % 2 == 0 && values[i] < 10);
+}
+
+TEST_F(ColumnPredicateFixture, compare_nanOnlyMatchesNotEqual)
+{
+	std::vector<double> values(70, 1.0);
+	values[65] = std::nan("");
+	BitBuffer buffer(BitBuffer::ZeroInit, 70);
+	BitSpan result = buffer.span();
+
+	predicate::compare(values.data(), predicate::Compare::NotEqual, 1.0, result);
+	EXPECT_EQ(result.countSetBits(), 1u);
+	EXPECT_TRUE(result.getBit(65));
+
+	predicate::between(values.data(), 0.0, 2.0, result);
+	EXPECT_EQ(result.countSetBits(), 69u);
+	EXPECT_FALSE(result.getBit(65));
+}
+
+}
@@ -0,0 +1,124 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Scan/SelectionCompaction.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Core/Types.h>
+#include <gtest/gtest.h>
+#include "TestRandom.h"
+#include <vector>
+
+namespace ddahlkvist
+{
+
+class SelectionCompactionFixture : public testing::Test {
+public:
+protected:
+	void SetUp() override {
+	}
+
+	void TearDown() override {
+	}
+
+	// mixes empty, full and partially selected words
+	static void makeSelection(BitSpan& selection)
+	{
+		selection.clearAll();
+		TestRandom random(7);
+		for (u32 i = 0; i < selection.numBits(); ++i)
+		{
+			const u32 word = i / NumBitsInWord;
+			const bool selected = word % 4 == 0 ? false : word % 4 == 1 ? true : random.oneIn(3);
+			if (selected)
+				selection.setBit(i);
+		}
+	}
+
+	template<typename T>
+	static std::vector<T> expectedCompaction(const BitSpan& selection, const std::vector<T>& values)
+	{
+		std::vector<T> expected;
+		for (u32 i = 0; i < selection.numBits(); ++i)
+		{
+			if (selection.getBit(i))
+				expected.push_back(values[i]);
+		}
+		return expected;
+	}
+
+	template<typename T>
+	static void expectCompactionMatchesScalar()
+	{
+		for (u32 numValues : { 1u, 63u, 64u, 300u, 1000u })
+		{
+			std::vector<T> values(numValues);
+			for (u32 i = 0; i < numValues; ++i)
+				values[i] = static_cast<T>(i * 3 + 1);
+
+			BitBuffer buffer(BitBuffer::ZeroInit, numValues);
+			BitSpan selection = buffer.span();
+			makeSelection(selection);
+			const std::vector<T> expected = expectedCompaction(selection, values);
+
+			// exactly sized output so that writes past the selected count are caught by sanitizers
+			std::vector<T> out(expected.size());
+			const u32 numWritten = selection::compact(selection.asConst(), values.data(), out.data());
+			ASSERT_EQ(numWritten, expected.size());
+			EXPECT_EQ(out, expected);
+		}
+	}
+};
+
+TEST_F(SelectionCompactionFixture, compact_u8) { expectCompactionMatchesScalar<u8>(); }
+TEST_F(SelectionCompactionFixture, compact_u16) { expectCompactionMatchesScalar<u16>(); }
+TEST_F(SelectionCompactionFixture, compact_u32) { expectCompactionMatchesScalar<u32>(); }
+TEST_F(SelectionCompactionFixture, compact_u64) { expectCompactionMatchesScalar<u64>(); }
+TEST_F(SelectionCompactionFixture, compact_float) { expectCompactionMatchesScalar<float>(); }
+TEST_F(SelectionCompactionFixture, compact_double) { expectCompactionMatchesScalar<double>(); }
+
+TEST_F(SelectionCompactionFixture, compact_emptySelection_writesNothing)
+{
+	std::vector<u32> values(200, 5u);
+	BitBuffer buffer(BitBuffer::ZeroInit, 200);
+
+	u32 out = 0;
+	EXPECT_EQ(selection::compact(buffer.span().asConst(), values.data(), &out), 0u);
+	EXPECT_EQ(out, 0u);
+}
+
+TEST_F(SelectionCompactionFixture, compactColumns_matchesSingleColumns)
+{
+	const u32 numValues = 777;
+	std::vector<u8> bytes(numValues);
+	std::vector<u32> ints(numValues);
+	std::vector<double> doubles(numValues);
+	for (u32 i = 0; i < numValues; ++i)
+	{
+		bytes[i] = static_cast<u8>(i);
+		ints[i] = i * 7;
+		doubles[i] = i * 0.5;
+	}
+
+	BitBuffer buffer(BitBuffer::ZeroInit, numValues);
+	BitSpan selection = buffer.span();
+	makeSelection(selection);
+
+	const std::vector<u8> expectedBytes = expectedCompaction(selection, bytes);
+	const std::vector<u32> expectedInts = expectedCompaction(selection, ints);
+	const std::vector<double> expectedDoubles = expectedCompaction(selection, doubles);
+
+	std::vector<u8> outBytes(expectedBytes.size());
+	std::vector<u32> outInts(expectedInts.size());
+	std::vector<double> outDoubles(expectedDoubles.size());
+	const selection::Column columns[] = {
+		{ bytes.data(), outBytes.data(), sizeof(u8) },
+		{ ints.data(), outInts.data(), sizeof(u32) },
+		{ doubles.data(), outDoubles.data(), sizeof(double) },
+	};
+
+	EXPECT_EQ(selection::compactColumns(selection.asConst(), columns, 3), expectedInts.size());
+	EXPECT_EQ(outBytes, expectedBytes);
+	EXPECT_EQ(outInts, expectedInts);
+	EXPECT_EQ(outDoubles, expectedDoubles);
+}
+
+}
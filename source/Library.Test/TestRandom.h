@@ -0,0 +1,70 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Core/Types.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// deterministic generator for test data, same sequence with every compiler and standard library
+class TestRandom
+{
+public:
+	explicit TestRandom(u32 seed)
+		: _state(seed)
+	{
+	}
+
+	// upper 24 bits of a 32 bit lcg, the low bits have short periods
+	inline u32 next()
+	{
+		_state = (_state * 1664525u + 1013904223u) & 0xFFFFFFFFu;
+		return _state >> 8;
+	}
+
+	inline u32 below(u32 bound) { return next() % bound; }
+	inline bool oneIn(u32 n) { return below(n) == 0; }
+
+	// sets every bit of span with probability numSet / outOf, bits are never cleared
+	void setBits(BitSpan span, u32 numSet, u32 outOf)
+	{
+		for (u32 bit = 0; bit < span.numBits(); ++bit)
+		{
+			if (below(outOf) < numSet)
+				span.setBit(bit);
+		}
+	}
+
+private:
+	u32 _state;
+};
+
+// equally sized random bitsets and ConstBitSpan views of them, as taken by the many input kernels
+struct TestRandomBitSets
+{
+	void make(u32 numSets, u32 numBits, u32 seed, u32 numSet, u32 outOf)
+	{
+		buffers.clear();
+		spans.clear();
+		buffers.reserve(numSets);
+
+		TestRandom random(seed);
+		for (u32 i = 0; i < numSets; ++i)
+		{
+			buffers.emplace_back(BitBuffer::ZeroInit, numBits);
+			random.setBits(buffers.back().span(), numSet, outOf);
+		}
+
+		for (const BitBuffer& buffer : buffers)
+			spans.push_back(buffer.constSpan());
+	}
+
+	std::vector<BitBuffer> buffers;
+	std::vector<ConstBitSpan> spans;
+};
+
+}
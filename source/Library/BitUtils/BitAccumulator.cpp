@@ -0,0 +1,227 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitAccumulator.h>
+
+#include <Library/BitUtils/BitRangeZipper.h>
+
+#include "ParallelRanges.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace ddahlkvist
+{
+
+BitAccumulator::Local::Local(u32 numBits, u32 blockWords, u32 maxSparseBits, std::pmr::memory_resource* resource)
+	: _dense(BitBuffer::NoInit, 0, resource)
+	, _dirtyMask(BitBuffer::NoInit, 0, resource)
+	, _resource(resource)
+	, _numBits(numBits)
+	, _numWords(bitword::getNumWordsRequired(numBits))
+	, _blockWords(blockWords)
+	, _maxSparseBits(maxSparseBits)
+{
+}
+
+BitWordType* BitAccumulator::Local::touchBlock(u32 block)
+{
+	const u32 firstWord = block * _blockWords;
+	BitWordType* words = _dense.data() + firstWord;
+
+	if (!isDirty(block))
+	{
+		memset(words, 0, std::min(_blockWords, _numWords - firstWord) * sizeof(BitWordType));
+		_dirtyMask.span().setBit(block);
+		_dirtyBlocks.push_back(block);
+	}
+	return words;
+}
+
+void BitAccumulator::Local::setBit(u32 bit)
+{
+	DD_ASSERT(bit < _numBits);
+
+	if (!isDense())
+	{
+		_sparse.push_back(bit);
+		if (_sparse.size() > _maxSparseBits)
+			densify();
+		return;
+	}
+
+	const u32 word = bit / NumBitsInWord;
+	BitWordType* blockWords = touchBlock(word / _blockWords);
+	bitword::setBit(blockWords[word % _blockWords], bit % NumBitsInWord);
+}
+
+void BitAccumulator::Local::densify()
+{
+	// storage is left uninitialized, blocks are zeroed when first touched
+	const u32 numBlocks = (_numWords + _blockWords - 1) / _blockWords;
+	_dense = BitBuffer(BitBuffer::NoInit, _numBits, _resource);
+	_dirtyMask = BitBuffer(BitBuffer::ZeroInit, numBlocks, _resource);
+
+	std::vector<u32> sparse = std::move(_sparse);
+	_sparse.clear();
+	for (u32 bit : sparse)
+		setBit(bit);
+}
+
+void BitAccumulator::Local::mergeFrom(Local& other)
+{
+	if (!other.isDense())
+	{
+		for (u32 bit : other._sparse)
+			setBit(bit);
+		return;
+	}
+
+	// a sparse local takes over the dense storage and adds its own list on top
+	if (!isDense())
+	{
+		std::swap(_dense, other._dense);
+		std::swap(_dirtyMask, other._dirtyMask);
+		std::swap(_dirtyBlocks, other._dirtyBlocks);
+		std::swap(_sparse, other._sparse);
+
+		for (u32 bit : other._sparse)
+			setBit(bit);
+		return;
+	}
+
+	for (u32 block : other._dirtyBlocks)
+	{
+		const u32 firstWord = block * _blockWords;
+		const u32 numBlockWords = std::min(_blockWords, _numWords - firstWord);
+		BitWordType* source = other._dense.data() + firstWord;
+
+		if (!isDirty(block))
+		{
+			_dirtyMask.span().setBit(block);
+			_dirtyBlocks.push_back(block);
+			memcpy(_dense.data() + firstWord, source, numBlockWords * sizeof(BitWordType));
+			continue;
+		}
+
+		BitRangeZipper zipper(_dense.data() + firstWord, source, numBlockWords * NumBitsInWord);
+		zipper.foreachWord([](auto& lhs, auto rhs) { lhs |= rhs; });
+	}
+}
+
+void BitAccumulator::Local::clear()
+{
+	_sparse.clear();
+
+	// only the dirty bits are reset, the blocks themselves are zeroed again on their next use
+	if (isDense())
+	{
+		BitSpan dirtyMask = _dirtyMask.span();
+		for (u32 block : _dirtyBlocks)
+			bitword::clearBit(dirtyMask.data()[block / NumBitsInWord], block % NumBitsInWord);
+	}
+	_dirtyBlocks.clear();
+}
+
+BitAccumulator::BitAccumulator(u32 numBits, u32 numWorkers, const BitAccumulatorOptions& options, std::pmr::memory_resource* resource)
+	: _options(options)
+	, _numBits(numBits)
+{
+	DD_ASSERT(numWorkers > 0);
+
+	const u32 blockWords = std::max<u32>(1, options.blockWords);
+	const u32 maxSparseBits = options.maxSparseBits != 0 ? options.maxSparseBits : std::max<u32>(1, numBits / 256);
+
+	_locals.reserve(numWorkers);
+	for (u32 i = 0; i < numWorkers; ++i)
+		_locals.push_back(Local(numBits, blockWords, maxSparseBits, resource));
+}
+
+void BitAccumulator::densifyMergeTargets()
+{
+	// sparse list length of every local after each level of the tree, Dense once it holds a buffer
+	constexpr usize Dense = ~usize{ 0 };
+
+	const u32 numLocals = numWorkers();
+	std::vector<usize> listSizes(numLocals);
+	for (u32 i = 0; i < numLocals; ++i)
+		listSizes[i] = _locals[i].isDense() ? Dense : _locals[i]._sparse.size();
+
+	for (u32 step = 1; step < numLocals; step *= 2)
+	{
+		for (u32 target = 0; target + step < numLocals; target += 2 * step)
+		{
+			usize& size = listSizes[target];
+			const usize otherSize = listSizes[target + step];
+			if (size == Dense)
+				continue;
+
+			// a dense source hands over its storage, nothing is allocated
+			if (otherSize == Dense)
+			{
+				size = Dense;
+				continue;
+			}
+
+			size += otherSize;
+			if (size > _locals[target]._maxSparseBits)
+			{
+				_locals[target].densify();
+				size = Dense;
+			}
+		}
+	}
+}
+
+void BitAccumulator::merge(BitSpan& result)
+{
+	DD_ASSERT(result.numBits() == _numBits);
+
+	const u32 numLocals = numWorkers();
+	densifyMergeTargets();
+
+	// level by level local i absorbs local i + step, the pairs of a level are independent
+	for (u32 step = 1; step < numLocals; step *= 2)
+	{
+		const u32 numPairs = (numLocals - step + 2 * step - 1) / (2 * step);
+		parallel::foreachRange(numPairs, 1, _options.numThreads, [this, step](u32, u32 begin, u32 end) {
+			for (u32 pair = begin; pair < end; ++pair)
+			{
+				const u32 target = pair * 2 * step;
+				_locals[target].mergeFrom(_locals[target + step]);
+			}
+		});
+	}
+
+	Local& root = _locals[0];
+	BitWordType* out = result.data();
+
+	if (!root.isDense())
+	{
+		for (u32 bit : root._sparse)
+			bitword::setBit(out[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+	else
+	{
+		const u32 blockWords = root._blockWords;
+		parallel::foreachRange(root.numDirtyBlocks(), 16, _options.numThreads, [&root, out, blockWords](u32, u32 begin, u32 end) {
+			for (u32 i = begin; i < end; ++i)
+			{
+				const u32 firstWord = root._dirtyBlocks[i] * blockWords;
+				const u32 numBlockWords = std::min(blockWords, root._numWords - firstWord);
+				BitRangeZipper zipper(out + firstWord, root._dense.data() + firstWord, numBlockWords * NumBitsInWord);
+				zipper.foreachWord([](auto& lhs, auto rhs) { lhs |= rhs; });
+			}
+		});
+	}
+
+	result.clearDanglingBits();
+	clear();
+}
+
+void BitAccumulator::clear()
+{
+	for (Local& local : _locals)
+		local.clear();
+}
+
+}
@@ -0,0 +1,173 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitCounters.h>
+
+#include "ParallelRanges.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ddahlkvist
+{
+namespace bitcounter
+{
+namespace
+{
+
+constexpr u32 BlockWords = 64; // 16 planes of this many words is 8kb of counters
+constexpr u32 MaxNumPlanes = 16;
+
+inline u32 getNumPlanes(u32 numInputs)
+{
+	u32 numPlanes = 1;
+	while ((numInputs >> numPlanes) != 0)
+		++numPlanes;
+	return numPlanes;
+}
+
+struct Planes
+{
+	BitWordType words[MaxNumPlanes][BlockWords];
+};
+
+inline void ripple(Planes& planes, u32 plane, u32 word, BitWordType carry)
+{
+	// a counter never exceeds numInputs so the carry dies before running out of planes
+	while (carry != bitword::Zero)
+	{
+		BitWordType& counter = planes.words[plane][word];
+		const BitWordType next = counter & carry;
+		counter ^= carry;
+		carry = next;
+		++plane;
+	}
+}
+
+void accumulateBlock(const ConstBitSpan* inputs, u32 numInputs, u32 firstWord, u32 numWords, u32 numPlanes, Planes& planes)
+{
+	for (u32 plane = 0; plane < numPlanes; ++plane)
+		memset(planes.words[plane], 0, numWords * sizeof(BitWordType));
+
+	u32 input = 0;
+	for (; input + 1 < numInputs; input += 2)
+	{
+		const BitWordType* a = inputs[input].data() + firstWord;
+		const BitWordType* b = inputs[input + 1].data() + firstWord;
+
+		for (u32 word = 0; word < numWords; ++word)
+		{
+			// carry-save adder of plane 0 and two inputs, sum stays in plane 0 and the carry is added at plane 1
+			BitWordType& low = planes.words[0][word];
+			const BitWordType partial = low ^ a[word];
+			const BitWordType carry = (low & a[word]) | (partial & b[word]);
+			low = partial ^ b[word];
+			ripple(planes, 1, word, carry);
+		}
+	}
+
+	if (input < numInputs)
+	{
+		const BitWordType* a = inputs[input].data() + firstWord;
+		for (u32 word = 0; word < numWords; ++word)
+			ripple(planes, 0, word, a[word]);
+	}
+}
+
+// bits of the words where the counter is >= k, compared from the most significant plane down
+inline BitWordType greaterOrEqual(const Planes& planes, u32 numPlanes, u32 word, u32 k)
+{
+	BitWordType greater = bitword::Zero;
+	BitWordType equal = bitword::Ones;
+
+	for (u32 plane = numPlanes; plane-- > 0;)
+	{
+		const BitWordType counterBits = planes.words[plane][word];
+		if ((k >> plane) & 1)
+		{
+			equal &= counterBits;
+		}
+		else
+		{
+			greater |= equal & counterBits;
+			equal &= ~counterBits;
+		}
+	}
+	return greater | equal;
+}
+
+// either output may be null
+void count(const ConstBitSpan* inputs, u32 numInputs, u32 numBits, u32 k, BitWordType* result, u16* counts, const BitCounterOptions& options)
+{
+	DD_ASSERT(numInputs <= MaxNumInputs);
+	for (u32 i = 0; i < numInputs; ++i)
+		DD_ASSERT(inputs[i].numBits() == numBits);
+
+	const u32 numWords = bitword::getNumWordsRequired(numBits);
+	const u32 numPlanes = getNumPlanes(numInputs);
+
+	// k above numInputs needs more planes than the counters have, no position can reach it
+	if (result != nullptr && k > numInputs)
+	{
+		memset(result, 0, numWords * sizeof(BitWordType));
+		result = nullptr;
+		if (counts == nullptr)
+			return;
+	}
+
+	parallel::foreachRange(numWords, options.minWordsPerThread, options.numThreads, [&](u32, u32 begin, u32 end) {
+		Planes planes;
+
+		for (u32 firstWord = begin; firstWord < end; firstWord += BlockWords)
+		{
+			const u32 numBlockWords = std::min(BlockWords, end - firstWord);
+			accumulateBlock(inputs, numInputs, firstWord, numBlockWords, numPlanes, planes);
+
+			if (result != nullptr)
+			{
+				for (u32 word = 0; word < numBlockWords; ++word)
+					result[firstWord + word] = greaterOrEqual(planes, numPlanes, word, k);
+			}
+
+			if (counts != nullptr)
+			{
+				const u32 firstBit = firstWord * NumBitsInWord;
+				const u32 numBlockBits = std::min(numBits - firstBit, numBlockWords * NumBitsInWord);
+				memset(counts + firstBit, 0, numBlockBits * sizeof(u16));
+
+				// dangling bits of the inputs are not masked when accumulating, so the last counters are cut off here
+				const bool hasDangling = firstWord + numBlockWords == numWords && bitword::hasDanglingPart(numBits);
+				for (u32 word = 0; word < numBlockWords; ++word)
+				{
+					const BitWordType mask = hasDangling && word + 1 == numBlockWords ? bitword::getDanglingPart(numBits) : bitword::Ones;
+					for (u32 plane = 0; plane < numPlanes; ++plane)
+					{
+						const u16 weight = static_cast<u16>(1u << plane);
+						bitword::foreachOne([counts, weight](u32 bit) { counts[bit] = static_cast<u16>(counts[bit] + weight); },
+							planes.words[plane][word] & mask, firstBit + word * NumBitsInWord);
+					}
+				}
+			}
+		}
+	});
+}
+
+}
+
+void atLeast(const ConstBitSpan* inputs, u32 numInputs, u32 k, BitSpan& result, const BitCounterOptions& options)
+{
+	count(inputs, numInputs, result.numBits(), k, result.data(), nullptr, options);
+	result.clearDanglingBits();
+}
+
+void atLeast(const ConstBitSpan* inputs, u32 numInputs, u32 k, BitSpan& result, u16* counts, const BitCounterOptions& options)
+{
+	count(inputs, numInputs, result.numBits(), k, result.data(), counts, options);
+	result.clearDanglingBits();
+}
+
+void countPerPosition(const ConstBitSpan* inputs, u32 numInputs, u32 numBits, u16* counts, const BitCounterOptions& options)
+{
+	count(inputs, numInputs, numBits, 0, nullptr, counts, options);
+}
+
+}
+}
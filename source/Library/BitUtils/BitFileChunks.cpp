@@ -0,0 +1,227 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitFileChunks.h>
+
+#include "FileIO.h"
+
+#include <algorithm>
+
+namespace ddahlkvist
+{
+
+BitFileChunkReader::~BitFileChunkReader()
+{
+	close();
+}
+
+bool BitFileChunkReader::open(const char* const* paths, u32 numFiles, u32 wordsPerChunk)
+{
+	DD_ASSERT(_files.empty());
+	DD_ASSERT(numFiles > 0 && wordsPerChunk > 0);
+
+	for (u32 i = 0; i < numFiles; ++i)
+	{
+		const int fd = fileio::openForRead(paths[i]);
+		if (fd < 0)
+		{
+			close();
+			return false;
+		}
+		_files.push_back(fd);
+
+		BitFileHeader header;
+		if (!fileio::readAt(fd, 0, &header, sizeof(BitFileHeader)) || !header.isCompatible() || (i > 0 && header.numBits != _numBits))
+		{
+			close();
+			return false;
+		}
+
+		_numBits = header.numBits;
+		fileio::adviseSequential(fd);
+	}
+
+	_wordsPerChunk = wordsPerChunk;
+	_numChunks = (bitword::getNumWordsRequired(_numBits) + wordsPerChunk - 1) / wordsPerChunk;
+
+	for (Slot& slot : _slots)
+	{
+		slot.words.resize(static_cast<usize>(numFiles) * wordsPerChunk);
+		slot.state = SlotState::Free;
+	}
+
+	if (_numChunks > 0)
+		_thread = std::thread([this]() { prefetchThread(); });
+
+	return true;
+}
+
+void BitFileChunkReader::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_all();
+
+	if (_thread.joinable())
+		_thread.join();
+
+	for (int fd : _files)
+		fileio::closeFile(fd);
+
+	_files.clear();
+	_numBits = 0;
+	_wordsPerChunk = 0;
+	_numChunks = 0;
+	_nextChunk = 0;
+	_failed = false;
+	_stop = false;
+}
+
+void BitFileChunkReader::prefetchThread()
+{
+	const u32 numWords = bitword::getNumWordsRequired(_numBits);
+
+	for (u32 chunk = 0; chunk < _numChunks; ++chunk)
+	{
+		Slot& slot = _slots[chunk % 2];
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this, &slot]() { return _stop || slot.state == SlotState::Free; });
+			if (_stop)
+				return;
+
+			slot.state = SlotState::Reading;
+		}
+
+		// slot is owned by this thread while Reading, no lock needed for the io
+		const u32 firstWord = chunk * _wordsPerChunk;
+		const u32 chunkWords = std::min(_wordsPerChunk, numWords - firstWord);
+		const u64 offset = sizeof(BitFileHeader) + u64{ firstWord } * sizeof(BitWordType);
+
+		bool success = true;
+		for (u32 file = 0; file < _files.size() && success; ++file)
+			success = fileio::readAt(_files[file], offset, slot.words.data() + file * _wordsPerChunk, u64{ chunkWords } * sizeof(BitWordType));
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			slot.state = SlotState::Ready;
+			_failed |= !success;
+		}
+		_condition.notify_all();
+
+		if (!success)
+			return;
+	}
+}
+
+bool BitFileChunkReader::nextChunk(BitFileChunk& chunk)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	// previous chunk is handed back to the prefetch thread
+	if (_nextChunk > 0)
+	{
+		Slot& previous = _slots[(_nextChunk - 1) % 2];
+		if (previous.state == SlotState::InUse)
+		{
+			previous.state = SlotState::Free;
+			_condition.notify_all();
+		}
+	}
+
+	if (_nextChunk >= _numChunks || _failed)
+		return false;
+
+	Slot& slot = _slots[_nextChunk % 2];
+	_condition.wait(lock, [this, &slot]() { return _failed || slot.state == SlotState::Ready; });
+	if (_failed)
+		return false;
+
+	slot.state = SlotState::InUse;
+
+	const u32 numWords = bitword::getNumWordsRequired(_numBits);
+	const u32 firstWord = _nextChunk * _wordsPerChunk;
+
+	chunk.chunkIndex = _nextChunk;
+	chunk.firstBit = firstWord * NumBitsInWord;
+	chunk.numWords = std::min(_wordsPerChunk, numWords - firstWord);
+	chunk.numBits = std::min(chunk.numWords * NumBitsInWord, _numBits - chunk.firstBit);
+	chunk.data = slot.words.data();
+	chunk.stride = _wordsPerChunk;
+
+	_nextChunk++;
+	return true;
+}
+
+BitFileChunkWriter::~BitFileChunkWriter()
+{
+	if (_file >= 0)
+		fileio::closeFile(_file);
+}
+
+bool BitFileChunkWriter::open(const char* path, u32 numBits)
+{
+	DD_ASSERT(_file < 0);
+
+	_file = fileio::openForWrite(path);
+	if (_file < 0)
+		return false;
+
+	_numBits = numBits;
+	_numWordsWritten = 0;
+	_checksum = BitFileChecksum();
+
+	// placeholder, real header is written by finish
+	const BitFileHeader placeholder = {};
+	const fileio::Segment segment = { &placeholder, sizeof(BitFileHeader) };
+	return fileio::writeSegments(_file, &segment, 1);
+}
+
+bool BitFileChunkWriter::append(const BitWordType* words, u32 numWords)
+{
+	DD_ASSERT(_file >= 0);
+
+	const u32 totalWords = bitword::getNumWordsRequired(_numBits);
+	if (numWords > totalWords - _numWordsWritten)
+		return false;
+
+	_numWordsWritten += numWords;
+
+	const bool containsDanglingWord = _numWordsWritten == totalWords && bitword::hasDanglingPart(_numBits) && numWords > 0;
+	if (!containsDanglingWord)
+	{
+		_checksum.append(words, numWords);
+
+		const fileio::Segment segment = { words, u64{ numWords } * sizeof(BitWordType) };
+		return fileio::writeSegments(_file, &segment, 1);
+	}
+
+	const BitWordType last = words[numWords - 1] & bitword::getDanglingPart(_numBits);
+	_checksum.append(words, numWords - 1);
+	_checksum.append(&last, 1);
+
+	const fileio::Segment segments[2] = {
+		{ words, u64{ numWords - 1 } * sizeof(BitWordType) },
+		{ &last, sizeof(BitWordType) },
+	};
+	return fileio::writeSegments(_file, segments, 2);
+}
+
+bool BitFileChunkWriter::finish()
+{
+	DD_ASSERT(_file >= 0);
+
+	bool success = _numWordsWritten == bitword::getNumWordsRequired(_numBits);
+	if (success)
+	{
+		BitFileHeader header = BitFileHeader::create(_numBits);
+		header.checksum = _checksum.finish(_numBits);
+		success = fileio::writeAt(_file, 0, &header, sizeof(BitFileHeader));
+	}
+
+	fileio::closeFile(_file);
+	_file = -1;
+	return success;
+}
+
+}
@@ -0,0 +1,209 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitMatrix.h>
+
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ddahlkvist
+{
+
+// recursive block swap [hacker's delight 7-3], each step swaps the off diagonal j x j sub blocks
+// steps with j >= 4 touch runs of at least 4 consecutive rows and are done 4 rows per avx2 instruction
+void transposeBitBlock64(u64* block)
+{
+	u32 j = 32;
+	u64 mask = 0x00000000FFFFFFFFull;
+
+#if defined(__AVX2__)
+	for (; j >= 4; j >>= 1, mask ^= mask << j)
+	{
+		const __m256i laneMask = _mm256_set1_epi64x(static_cast<long long>(mask));
+		const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(j));
+
+		for (u32 k = 0; k < 64; k += 2 * j)
+		{
+			for (u32 i = k; i < k + j; i += 4)
+			{
+				__m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+				__m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i + j));
+				const __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srl_epi64(lo, shift), hi), laneMask);
+				lo = _mm256_xor_si256(lo, _mm256_sll_epi64(t, shift));
+				hi = _mm256_xor_si256(hi, t);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(block + i), lo);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(block + i + j), hi);
+			}
+		}
+	}
+#endif
+
+	for (; j != 0; j >>= 1, mask ^= mask << j)
+	{
+		for (u32 k = 0; k < 64; k = ((k | j) + 1) & ~j)
+		{
+			const u64 t = ((block[k] >> j) ^ block[k | j]) & mask;
+			block[k] ^= t << j;
+			block[k | j] ^= t;
+		}
+	}
+}
+
+BitMatrix::BitMatrix(u32 numRows, u32 numCols, std::pmr::memory_resource* resource)
+	: _resource(resource)
+	, _numRows(numRows)
+	, _numCols(numCols)
+	, _stride((bitword::getNumWordsRequired(numCols) + StrideAlignmentWords - 1) / StrideAlignmentWords * StrideAlignmentWords)
+{
+	if (numWords() > 0)
+	{
+		_data = static_cast<BitWordType*>(_resource->allocate(numWords() * sizeof(BitWordType), Alignment));
+		clearAll();
+	}
+}
+
+BitMatrix::~BitMatrix()
+{
+	release();
+}
+
+BitMatrix::BitMatrix(BitMatrix&& other) noexcept
+	: _data(std::exchange(other._data, nullptr))
+	, _resource(other._resource)
+	, _numRows(std::exchange(other._numRows, 0))
+	, _numCols(std::exchange(other._numCols, 0))
+	, _stride(std::exchange(other._stride, 0))
+{
+}
+
+BitMatrix& BitMatrix::operator=(BitMatrix&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		_data = std::exchange(other._data, nullptr);
+		_resource = other._resource;
+		_numRows = std::exchange(other._numRows, 0);
+		_numCols = std::exchange(other._numCols, 0);
+		_stride = std::exchange(other._stride, 0);
+	}
+	return *this;
+}
+
+void BitMatrix::release()
+{
+	if (_data != nullptr)
+		_resource->deallocate(_data, numWords() * sizeof(BitWordType), Alignment);
+}
+
+void BitMatrix::clearAll()
+{
+	if (_data != nullptr)
+		memset(_data, 0, numWords() * sizeof(BitWordType));
+}
+
+u64 BitMatrix::countSetBits() const
+{
+	// padding is zero so whole rows including padding can be counted
+	u64 counter = 0;
+	const BitWordType* end = _data + numWords();
+	for (const BitWordType* it = _data; it != end; ++it)
+		counter += bitword::countSetBits(*it);
+	return counter;
+}
+
+void BitMatrix::getColumn(u32 col, BitSpan& output) const
+{
+	DD_ASSERT(col < _numCols);
+	DD_ASSERT(output.numBits() == _numRows);
+
+	const u32 wordIndex = col / NumBitsInWord;
+	const u32 bitIndex = col % NumBitsInWord;
+	BitWordType* out = output.data();
+
+	for (u32 rowBlock = 0; rowBlock * NumBitsInWord < _numRows; ++rowBlock)
+	{
+		const u32 firstRow = rowBlock * NumBitsInWord;
+		const u32 lastRow = firstRow + NumBitsInWord < _numRows ? firstRow + NumBitsInWord : _numRows;
+
+		BitWordType word = bitword::Zero;
+		const BitWordType* it = rowData(firstRow) + wordIndex;
+		for (u32 row = firstRow; row < lastRow; ++row, it += _stride)
+			word |= ((*it >> bitIndex) & 1ull) << (row - firstRow);
+
+		out[rowBlock] = word;
+	}
+}
+
+void BitMatrix::loadBlock(u32 rowBlock, u32 colBlock, u64* block) const
+{
+	const u32 firstRow = rowBlock * 64;
+	const u32 numRowsInBlock = _numRows - firstRow < 64 ? _numRows - firstRow : 64;
+
+	const BitWordType* it = _data + static_cast<usize>(firstRow) * _stride + colBlock;
+	for (u32 i = 0; i < numRowsInBlock; ++i, it += _stride)
+		block[i] = *it;
+	for (u32 i = numRowsInBlock; i < 64; ++i)
+		block[i] = 0;
+}
+
+void BitMatrix::countColumnBits(u32* counts) const
+{
+	memset(counts, 0, _numCols * sizeof(u32));
+
+	// a transposed block turns 64 columns into 64 words, one popcount per column and block
+	alignas(64) u64 block[64];
+	const u32 numColBlocks = bitword::getNumWordsRequired(_numCols);
+	const u32 numRowBlocks = bitword::getNumWordsRequired(_numRows);
+
+	for (u32 colBlock = 0; colBlock < numColBlocks; ++colBlock)
+	{
+		const u32 firstCol = colBlock * 64;
+		const u32 numColsInBlock = _numCols - firstCol < 64 ? _numCols - firstCol : 64;
+
+		for (u32 rowBlock = 0; rowBlock < numRowBlocks; ++rowBlock)
+		{
+			loadBlock(rowBlock, colBlock, block);
+			transposeBitBlock64(block);
+
+			for (u32 i = 0; i < numColsInBlock; ++i)
+				counts[firstCol + i] += bitword::countSetBits(block[i]);
+		}
+	}
+}
+
+void BitMatrix::transposeInto(BitMatrix& output) const
+{
+	DD_ASSERT(output._numRows == _numCols && output._numCols == _numRows);
+
+	alignas(64) u64 block[64];
+	const u32 numColBlocks = bitword::getNumWordsRequired(_numCols);
+	const u32 numRowBlocks = bitword::getNumWordsRequired(_numRows);
+
+	for (u32 rowBlock = 0; rowBlock < numRowBlocks; ++rowBlock)
+	{
+		for (u32 colBlock = 0; colBlock < numColBlocks; ++colBlock)
+		{
+			loadBlock(rowBlock, colBlock, block);
+			transposeBitBlock64(block);
+
+			// rows beyond numRows were loaded as zero, so the output padding stays zero
+			const u32 firstOutRow = colBlock * 64;
+			const u32 numOutRows = _numCols - firstOutRow < 64 ? _numCols - firstOutRow : 64;
+			BitWordType* out = output._data + static_cast<usize>(firstOutRow) * output._stride + rowBlock;
+			for (u32 i = 0; i < numOutRows; ++i, out += output._stride)
+				*out = block[i];
+		}
+	}
+}
+
+BitMatrix BitMatrix::transposed() const
+{
+	BitMatrix output(_numCols, _numRows, _resource);
+	transposeInto(output);
+	return output;
+}
+
+}
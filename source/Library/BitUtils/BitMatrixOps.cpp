@@ -0,0 +1,144 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitMatrixOps.h>
+
+#include <Library/BitUtils/BitRangeZipper.h>
+#include "ParallelRanges.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory_resource>
+
+namespace ddahlkvist
+{
+namespace bitmatrix
+{
+namespace
+{
+
+constexpr u32 NumBitsPerTable = 8;
+constexpr u32 NumTableEntries = 1u << NumBitsPerTable;
+
+// table[x] = OR of the rows in group selected by the bits of x, restricted to one column tile
+// every entry is derived from an entry with one bit less, one row accumulation per entry
+void buildTable(const BitMatrix& b, u32 firstRow, u32 firstWord, u32 numWords, BitWordType* table)
+{
+	memset(table, 0, numWords * sizeof(BitWordType));
+
+	for (u32 entry = 1; entry < NumTableEntries; ++entry)
+	{
+		const u32 lowestBit = bitword::getLowestSetBit(entry);
+		const u32 row = firstRow + lowestBit;
+		BitWordType* out = table + entry * numWords;
+		const BitWordType* previous = table + (entry & (entry - 1)) * numWords;
+
+		if (row >= b.numRows())
+		{
+			memcpy(out, previous, numWords * sizeof(BitWordType));
+			continue;
+		}
+
+		const BitWordType* source = b.rowData(row) + firstWord;
+		for (u32 i = 0; i < numWords; ++i)
+			out[i] = previous[i] | source[i];
+	}
+}
+
+void multiplyRows(const BitMatrix& a, const BitMatrix& b, BitMatrix& output, u32 rowBegin, u32 rowEnd, u32 colTileWords, BitWordType* table)
+{
+	const u32 numOutputWords = bitword::getNumWordsRequired(output.numCols());
+	const u32 numGroups = (a.numCols() + NumBitsPerTable - 1) / NumBitsPerTable;
+
+	// column tiles outermost so the table and the touched part of every output row stay in cache
+	for (u32 firstWord = 0; firstWord < numOutputWords; firstWord += colTileWords)
+	{
+		const u32 numWords = std::min(colTileWords, numOutputWords - firstWord);
+
+		for (u32 group = 0; group < numGroups; ++group)
+		{
+			const u32 groupWord = group * NumBitsPerTable / NumBitsInWord;
+			const u32 groupShift = group * NumBitsPerTable % NumBitsInWord;
+
+			// skip building the table when no row in the range uses the group [common for sparse graphs]
+			bool used = false;
+			for (u32 row = rowBegin; row < rowEnd && !used; ++row)
+				used = ((a.rowData(row)[groupWord] >> groupShift) & (NumTableEntries - 1)) != 0;
+
+			if (!used)
+				continue;
+
+			buildTable(b, group * NumBitsPerTable, firstWord, numWords, table);
+
+			for (u32 row = rowBegin; row < rowEnd; ++row)
+			{
+				const u32 entry = static_cast<u32>((a.rowData(row)[groupWord] >> groupShift) & (NumTableEntries - 1));
+				if (entry == 0)
+					continue;
+
+				BitRangeZipper zipper(output.rowData(row) + firstWord, table + entry * numWords, numWords * NumBitsInWord);
+				zipper.foreachWord([](auto& lhs, auto rhs) { lhs |= rhs; });
+			}
+		}
+	}
+}
+
+}
+
+void multiply(const BitMatrix& a, const BitMatrix& b, BitMatrix& output, const BitMatrixMultiplyOptions& options)
+{
+	DD_ASSERT(a.numCols() == b.numRows());
+	DD_ASSERT(output.numRows() == a.numRows() && output.numCols() == b.numCols());
+	DD_ASSERT(&output != &a && &output != &b);
+
+	output.clearAll();
+
+	// tables are allocated on the calling thread, the output resource [BumpArena, SizeClassPool] need not be thread safe
+	const u32 numRanges = parallel::getNumRanges(a.numRows(), options.minRowsPerThread, options.numThreads);
+	const u32 colTileWords = std::max<u32>(1, options.colTileWords);
+	const usize tableWords = NumTableEntries * colTileWords;
+	const usize tablesSize = numRanges * tableWords * sizeof(BitWordType);
+	if (tablesSize == 0)
+		return;
+
+	std::pmr::memory_resource* resource = output.resource();
+	auto* tables = static_cast<BitWordType*>(resource->allocate(tablesSize, BitMatrix::Alignment));
+
+	parallel::foreachRange(a.numRows(), options.minRowsPerThread, options.numThreads, [&](u32 rangeIndex, u32 begin, u32 end) {
+		multiplyRows(a, b, output, begin, end, colTileWords, tables + rangeIndex * tableWords);
+	});
+
+	resource->deallocate(tables, tablesSize, BitMatrix::Alignment);
+}
+
+void transitiveClosure(const BitMatrix& adjacency, BitMatrix& output, const BitMatrixMultiplyOptions& options)
+{
+	const u32 numNodes = adjacency.numRows();
+	DD_ASSERT(adjacency.numCols() == numNodes);
+	DD_ASSERT(output.numRows() == numNodes && output.numCols() == numNodes);
+
+	const usize numBytes = static_cast<usize>(numNodes) * adjacency.stride() * sizeof(BitWordType);
+	if (numBytes != 0)
+		memcpy(output.data(), adjacency.data(), numBytes);
+
+	BitMatrix squared(numNodes, numNodes, output.resource());
+	u64 numReachable = output.countSetBits();
+
+	// paths of length up to 2^i are covered after i iterations, reachability only grows so an unchanged count means done
+	for (;;)
+	{
+		multiply(output, output, squared, options);
+
+		parallel::foreachRange(numNodes, options.minRowsPerThread, options.numThreads, [&](u32, u32 begin, u32 end) {
+			for (u32 row = begin; row < end; ++row)
+				output.row(row) |= squared.row(row);
+		});
+
+		const u64 count = output.countSetBits();
+		if (count == numReachable)
+			break;
+
+		numReachable = count;
+	}
+}
+
+}
+}
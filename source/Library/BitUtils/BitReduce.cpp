@@ -0,0 +1,124 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitReduce.h>
+
+#include <Library/BitUtils/BitCounters.h>
+#include "ParallelRanges.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ddahlkvist
+{
+namespace bitreduce
+{
+namespace
+{
+
+struct OrOp
+{
+	static inline BitWordType apply(BitWordType a, BitWordType b) { return a | b; }
+};
+
+struct AndOp
+{
+	static inline BitWordType apply(BitWordType a, BitWordType b) { return a & b; }
+};
+
+struct XorOp
+{
+	static inline BitWordType apply(BitWordType a, BitWordType b) { return a ^ b; }
+};
+
+inline bool isZero(const BitWordType* words, u32 numWords)
+{
+	BitWordType any = bitword::Zero;
+	for (u32 i = 0; i < numWords; ++i)
+		any |= words[i];
+	return any == bitword::Zero;
+}
+
+template<typename Op>
+void reduceTile(const ConstBitSpan* inputs, u32 numInputs, u32 firstWord, u32 numWords, BitWordType* out)
+{
+	memcpy(out, inputs[0].data() + firstWord, numWords * sizeof(BitWordType));
+
+	u32 input = 1;
+	for (; input + 4 <= numInputs; input += 4)
+	{
+		const BitWordType* a = inputs[input].data() + firstWord;
+		const BitWordType* b = inputs[input + 1].data() + firstWord;
+		const BitWordType* c = inputs[input + 2].data() + firstWord;
+		const BitWordType* d = inputs[input + 3].data() + firstWord;
+
+		for (u32 word = 0; word < numWords; ++word)
+			out[word] = Op::apply(Op::apply(out[word], Op::apply(a[word], b[word])), Op::apply(c[word], d[word]));
+
+		if constexpr (std::is_same_v<Op, AndOp>)
+		{
+			if (isZero(out, numWords))
+				return;
+		}
+	}
+
+	for (; input < numInputs; ++input)
+	{
+		const BitWordType* a = inputs[input].data() + firstWord;
+		for (u32 word = 0; word < numWords; ++word)
+			out[word] = Op::apply(out[word], a[word]);
+	}
+}
+
+template<typename Op>
+void reduceTiled(const ConstBitSpan* inputs, u32 numInputs, BitSpan& result, const BitReduceOptions& options)
+{
+	const u32 tileWords = std::max<u32>(1, options.tileWords);
+	BitWordType* out = result.data();
+
+	parallel::foreachRange(result.numWords(), options.minWordsPerThread, options.numThreads, [&](u32, u32 begin, u32 end) {
+		for (u32 firstWord = begin; firstWord < end; firstWord += tileWords)
+			reduceTile<Op>(inputs, numInputs, firstWord, std::min(tileWords, end - firstWord), out + firstWord);
+	});
+}
+
+}
+
+void reduce(BitReduceOp op, const ConstBitSpan* inputs, u32 numInputs, BitSpan& result, const BitReduceOptions& options)
+{
+	for (u32 i = 0; i < numInputs; ++i)
+		DD_ASSERT(inputs[i].numBits() == result.numBits());
+
+	if (numInputs == 0)
+	{
+		if (op == BitReduceOp::And)
+			result.setAll();
+		else
+			result.clearAll();
+		return;
+	}
+
+	switch (op)
+	{
+	case BitReduceOp::Or:
+		reduceTiled<OrOp>(inputs, numInputs, result, options);
+		break;
+	case BitReduceOp::And:
+		reduceTiled<AndOp>(inputs, numInputs, result, options);
+		break;
+	case BitReduceOp::Xor:
+		reduceTiled<XorOp>(inputs, numInputs, result, options);
+		break;
+	case BitReduceOp::Majority:
+	{
+		BitCounterOptions counterOptions;
+		counterOptions.numThreads = options.numThreads;
+		counterOptions.minWordsPerThread = options.minWordsPerThread;
+		bitcounter::atLeast(inputs, numInputs, numInputs / 2 + 1, result, counterOptions);
+		break;
+	}
+	}
+
+	result.clearDanglingBits();
+}
+
+}
+}
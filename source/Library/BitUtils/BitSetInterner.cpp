@@ -0,0 +1,133 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitSetInterner.h>
+
+#include <Library/BitUtils/BitSpanHash.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace ddahlkvist
+{
+namespace
+{
+
+constexpr u32 InitialTableSize = 64;
+
+// interners of zero bit sets still allocate non empty pages
+usize getPageBytes(u32 wordsPerSet)
+{
+	return std::max<usize>(1, usize{ BitSetInterner::PageSize } * wordsPerSet) * sizeof(BitWordType);
+}
+
+}
+
+BitSetInterner::BitSetInterner(u32 numBits, std::pmr::memory_resource* resource)
+	: _resource(resource)
+	, _table(InitialTableSize, 0)
+	, _scratch(bitword::getNumWordsRequired(numBits))
+	, _numBits(numBits)
+	, _wordsPerSet(bitword::getNumWordsRequired(numBits))
+{
+}
+
+BitSetInterner::~BitSetInterner()
+{
+	const usize pageBytes = getPageBytes(_wordsPerSet);
+	for (BitWordType* page : _pages)
+		_resource->deallocate(page, pageBytes, Alignment);
+}
+
+BitSetInterner::Handle BitSetInterner::intern(const ConstBitSpan& bits)
+{
+	DD_ASSERT(bits.numBits() == _numBits);
+
+	// the copy has the dangling bits masked, which is how values are stored and hashed
+	BitWordType* out = _scratch.data();
+	bits.foreachWord([&out](BitWordType word) { *out++ = word; });
+
+	return internWords(_scratch.data(), bitspan::hash(ConstBitSpan(_scratch.data(), _numBits)));
+}
+
+BitSetInterner::Handle BitSetInterner::internWords(const BitWordType* words, u64 hash)
+{
+	const u32 mask = static_cast<u32>(_table.size()) - 1;
+	u32 slot = static_cast<u32>(hash) & mask;
+
+	for (; _table[slot] != 0; slot = (slot + 1) & mask)
+	{
+		const u32 index = _table[slot] - 1;
+		if (_hashes[index] == hash && memcmp(setData(index), words, _wordsPerSet * sizeof(BitWordType)) == 0)
+			return { index };
+	}
+
+	DD_ASSERT(_numSets < (1u << 31)); // memo keys use 31 bits per handle
+	if (_numSets % PageSize == 0)
+		_pages.push_back(static_cast<BitWordType*>(_resource->allocate(getPageBytes(_wordsPerSet), Alignment)));
+
+	const u32 index = _numSets++;
+	memcpy(setData(index), words, _wordsPerSet * sizeof(BitWordType));
+	_hashes.push_back(hash);
+	_table[slot] = index + 1;
+
+	// at most half full keeps probe sequences short
+	if (_numSets * 2 > _table.size())
+		growTable();
+
+	return { index };
+}
+
+void BitSetInterner::growTable()
+{
+	_table.assign(_table.size() * 2, 0);
+	const u32 mask = static_cast<u32>(_table.size()) - 1;
+
+	for (u32 index = 0; index < _numSets; ++index)
+	{
+		u32 slot = static_cast<u32>(_hashes[index]) & mask;
+		while (_table[slot] != 0)
+			slot = (slot + 1) & mask;
+		_table[slot] = index + 1;
+	}
+}
+
+BitSetInterner::Handle BitSetInterner::apply(Op op, Handle a, Handle b)
+{
+	// intersect and unite are commutative, both orders share one memo entry
+	if (op != Op::Subtract && b.index < a.index)
+		std::swap(a, b);
+
+	const u64 key = (static_cast<u64>(op) << 62) | (static_cast<u64>(a.index) << 31) | b.index;
+	auto it = _memo.find(key);
+	if (it != _memo.end())
+		return { it->second };
+
+	const BitWordType* lhs = setData(a.index);
+	const BitWordType* rhs = setData(b.index);
+	BitWordType* out = _scratch.data();
+
+	switch (op)
+	{
+	case Op::Intersect:
+		for (u32 i = 0; i < _wordsPerSet; ++i)
+			out[i] = lhs[i] & rhs[i];
+		break;
+	case Op::Unite:
+		for (u32 i = 0; i < _wordsPerSet; ++i)
+			out[i] = lhs[i] | rhs[i];
+		break;
+	case Op::Subtract:
+		for (u32 i = 0; i < _wordsPerSet; ++i)
+			out[i] = lhs[i] & ~rhs[i];
+		break;
+	}
+
+	const Handle result = internWords(out, bitspan::hash(ConstBitSpan(out, _numBits)));
+	_memo.emplace(key, result.index);
+	return result;
+}
+
+BitSetInterner::Handle BitSetInterner::intersect(Handle a, Handle b) { return apply(Op::Intersect, a, b); }
+BitSetInterner::Handle BitSetInterner::unite(Handle a, Handle b) { return apply(Op::Unite, a, b); }
+BitSetInterner::Handle BitSetInterner::subtract(Handle a, Handle b) { return apply(Op::Subtract, a, b); }
+
+}
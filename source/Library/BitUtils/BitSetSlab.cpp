@@ -0,0 +1,240 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitSetSlab.h>
+
+#include <Library/BitUtils/BitMatrix.h>
+#include "RowMatch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace ddahlkvist
+{
+namespace
+{
+
+using Words = std::pmr::vector<BitWordType>;
+
+struct MatchAllTag {};
+struct MatchAnyTag {};
+struct MatchNoneTag {};
+
+}
+
+BitSetSlab::BitSetSlab(u32 numRows, u32 numBitsPerRow, Layout layout, std::pmr::memory_resource* resource)
+	: _resource(resource)
+	, _numRows(numRows)
+	, _numBitsPerRow(numBitsPerRow)
+	, _wordsPerRow(bitword::getNumWordsRequired(numBitsPerRow))
+	, _wordsPerPlane(bitword::getNumWordsRequired(numRows))
+	, _layout(layout)
+{
+	if (numWords() > 0)
+	{
+		_data = static_cast<BitWordType*>(_resource->allocate(numWords() * sizeof(BitWordType), Alignment));
+		clearAll();
+	}
+}
+
+BitSetSlab::~BitSetSlab()
+{
+	release();
+}
+
+BitSetSlab::BitSetSlab(BitSetSlab&& other) noexcept
+	: _data(std::exchange(other._data, nullptr))
+	, _resource(other._resource)
+	, _numRows(std::exchange(other._numRows, 0))
+	, _numBitsPerRow(std::exchange(other._numBitsPerRow, 0))
+	, _wordsPerRow(std::exchange(other._wordsPerRow, 0))
+	, _wordsPerPlane(std::exchange(other._wordsPerPlane, 0))
+	, _layout(other._layout)
+{
+}
+
+BitSetSlab& BitSetSlab::operator=(BitSetSlab&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		_data = std::exchange(other._data, nullptr);
+		_resource = other._resource;
+		_numRows = std::exchange(other._numRows, 0);
+		_numBitsPerRow = std::exchange(other._numBitsPerRow, 0);
+		_wordsPerRow = std::exchange(other._wordsPerRow, 0);
+		_wordsPerPlane = std::exchange(other._wordsPerPlane, 0);
+		_layout = other._layout;
+	}
+	return *this;
+}
+
+void BitSetSlab::release()
+{
+	if (_data != nullptr)
+		_resource->deallocate(_data, numWords() * sizeof(BitWordType), Alignment);
+}
+
+void BitSetSlab::clearAll()
+{
+	if (_data != nullptr)
+		memset(_data, 0, numWords() * sizeof(BitWordType));
+}
+
+template<typename Emit>
+void BitSetSlab::evaluate(Match match, const ConstBitSpan& query, Emit&& emit) const
+{
+	DD_ASSERT(query.numBits() == _numBitsPerRow);
+
+	const u32 numRowBlocks = bitword::getNumWordsRequired(_numRows);
+	const BitWordType lastBlockMask = bitword::hasDanglingPart(_numRows) ? bitword::getDanglingPart(_numRows) : bitword::Ones;
+
+	auto run = [&](auto tag) {
+		using MatchTag = decltype(tag);
+
+		if (_layout == Layout::RowMajor)
+		{
+			// the query lands in the require, any or exclude mask of the shared row kernel
+			const u32 maskIndex = std::is_same_v<MatchTag, MatchAllTag> ? 0 : std::is_same_v<MatchTag, MatchAnyTag> ? 1 : 2;
+			Words masks(3 * _wordsPerRow, bitword::Zero, _resource);
+			BitWordType* mask = masks.data() + static_cast<usize>(maskIndex) * _wordsPerRow;
+			query.foreachWord([&mask](BitWordType word) { *mask++ = word; });
+
+			for (u32 rowBlock = 0; rowBlock < numRowBlocks; ++rowBlock)
+			{
+				const u32 firstRow = rowBlock * NumBitsInWord;
+				const u32 numBlockRows = std::min(NumBitsInWord, _numRows - firstRow);
+				const BitWordType* rows = _data + static_cast<usize>(firstRow) * _wordsPerRow;
+				emit(rowBlock, rowmatch::matchRows(rows, numBlockRows, _wordsPerRow, masks.data(), maskIndex == 1));
+			}
+		}
+		else
+		{
+			// only the planes of the query bits are read, 64 rows per word
+			std::pmr::vector<const BitWordType*> planes(_resource);
+			query.foreachSetBit([this, &planes](u32 bit) { planes.push_back(planeData(bit)); });
+
+			for (u32 rowBlock = 0; rowBlock < numRowBlocks; ++rowBlock)
+			{
+				BitWordType bits = std::is_same_v<MatchTag, MatchAllTag> ? bitword::Ones : bitword::Zero;
+				for (const BitWordType* plane : planes)
+				{
+					if constexpr (std::is_same_v<MatchTag, MatchAllTag>)
+						bits &= plane[rowBlock];
+					else
+						bits |= plane[rowBlock];
+				}
+
+				if constexpr (std::is_same_v<MatchTag, MatchNoneTag>)
+					bits = ~bits;
+
+				emit(rowBlock, rowBlock + 1 == numRowBlocks ? bits & lastBlockMask : bits);
+			}
+		}
+	};
+
+	switch (match)
+	{
+	case Match::All: run(MatchAllTag{}); break;
+	case Match::Any: run(MatchAnyTag{}); break;
+	case Match::None: run(MatchNoneTag{}); break;
+	}
+}
+
+void BitSetSlab::match(Match match, const ConstBitSpan& query, BitSpan& result) const
+{
+	DD_ASSERT(result.numBits() == _numRows);
+
+	BitWordType* out = result.data();
+	evaluate(match, query, [out](u32 rowBlock, BitWordType bits) { out[rowBlock] = bits; });
+}
+
+u32 BitSetSlab::match(Match match, const ConstBitSpan& query, u32* rowIndices) const
+{
+	u32 numMatches = 0;
+	evaluate(match, query, [rowIndices, &numMatches](u32 rowBlock, BitWordType bits) {
+		bitword::foreachOne([rowIndices, &numMatches](u32 row) { rowIndices[numMatches++] = row; }, bits, rowBlock * NumBitsInWord);
+	});
+	return numMatches;
+}
+
+void BitSetSlab::matchAll(const ConstBitSpan& query, BitSpan& result) const { match(Match::All, query, result); }
+void BitSetSlab::matchAny(const ConstBitSpan& query, BitSpan& result) const { match(Match::Any, query, result); }
+void BitSetSlab::matchNone(const ConstBitSpan& query, BitSpan& result) const { match(Match::None, query, result); }
+
+u32 BitSetSlab::matchAll(const ConstBitSpan& query, u32* rowIndices) const { return match(Match::All, query, rowIndices); }
+u32 BitSetSlab::matchAny(const ConstBitSpan& query, u32* rowIndices) const { return match(Match::Any, query, rowIndices); }
+u32 BitSetSlab::matchNone(const ConstBitSpan& query, u32* rowIndices) const { return match(Match::None, query, rowIndices); }
+
+void BitSetSlab::intersectAll(const ConstBitSpan& query)
+{
+	DD_ASSERT(query.numBits() == _numBitsPerRow);
+
+	if (_layout == Layout::RowMajor)
+	{
+		Words queryWords(_resource);
+		queryWords.reserve(_wordsPerRow);
+		query.foreachWord([&queryWords](BitWordType word) { queryWords.push_back(word); });
+
+		BitWordType* it = _data;
+		for (u32 row = 0; row < _numRows; ++row)
+		{
+			for (u32 i = 0; i < _wordsPerRow; ++i, ++it)
+				*it &= queryWords[i];
+		}
+	}
+	else
+	{
+		// rows lose exactly the bits outside the query, which are whole planes
+		for (u32 bit = 0; bit < _numBitsPerRow; ++bit)
+		{
+			if (!query.getBit(bit))
+				memset(planeData(bit), 0, _wordsPerPlane * sizeof(BitWordType));
+		}
+	}
+}
+
+void BitSetSlab::countRowBits(u32* counts) const
+{
+	if (_layout == Layout::RowMajor)
+	{
+		const BitWordType* it = _data;
+		for (u32 row = 0; row < _numRows; ++row)
+		{
+			u32 count = 0;
+			for (u32 i = 0; i < _wordsPerRow; ++i, ++it)
+				count += bitword::countSetBits(*it);
+			counts[row] = count;
+		}
+		return;
+	}
+
+	memset(counts, 0, _numRows * sizeof(u32));
+
+	// 64 planes x 64 rows are transposed into one word per row, one popcount per row and block
+	alignas(64) u64 block[64];
+	const u32 numPlaneBlocks = bitword::getNumWordsRequired(_numBitsPerRow);
+
+	for (u32 rowBlock = 0; rowBlock < _wordsPerPlane; ++rowBlock)
+	{
+		const u32 firstRow = rowBlock * NumBitsInWord;
+		const u32 numBlockRows = std::min(NumBitsInWord, _numRows - firstRow);
+
+		for (u32 planeBlock = 0; planeBlock < numPlaneBlocks; ++planeBlock)
+		{
+			const u32 firstPlane = planeBlock * NumBitsInWord;
+			const u32 numBlockPlanes = std::min(NumBitsInWord, _numBitsPerRow - firstPlane);
+			for (u32 i = 0; i < numBlockPlanes; ++i)
+				block[i] = _data[static_cast<usize>(firstPlane + i) * _wordsPerPlane + rowBlock];
+			for (u32 i = numBlockPlanes; i < 64; ++i)
+				block[i] = 0;
+
+			transposeBitBlock64(block);
+
+			for (u32 i = 0; i < numBlockRows; ++i)
+				counts[firstRow + i] += bitword::countSetBits(block[i]);
+		}
+	}
+}
+
+}
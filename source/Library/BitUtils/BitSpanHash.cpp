@@ -0,0 +1,100 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitSpanHash.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ddahlkvist
+{
+namespace bitspan
+{
+namespace
+{
+
+constexpr u32 NumLanes = 4;
+constexpr u64 LaneKeys[NumLanes] = { 0x243F6A8885A308D3ull, 0x13198A2E03707344ull, 0xA4093822299F31D0ull, 0x082EFA98EC4E6C89ull };
+constexpr u64 KeyStep = 0x9E3779B97F4A7C15ull; // keys advance per stripe so that equal words at different positions do not cancel
+
+inline u64 mix(u64 value)
+{
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDull;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ull;
+	return value ^ (value >> 33);
+}
+
+// acc[lane] += lo32(word ^ key) * hi32(word ^ key) + word, one stripe is NumLanes words
+inline void accumulateStripe(u64* acc, u64* keys, const BitWordType* words)
+{
+	for (u32 lane = 0; lane < NumLanes; ++lane)
+	{
+		const u64 keyed = words[lane] ^ keys[lane];
+		acc[lane] += (keyed & 0xFFFFFFFFull) * (keyed >> 32) + words[lane];
+		keys[lane] += KeyStep;
+	}
+}
+
+}
+
+u64 hash(const ConstBitSpan& bits, u64 seed)
+{
+	const u32 numWords = bits.numWords();
+	const BitWordType* words = bits.data();
+
+	// the last word [dangling bits masked] is always handled in the padded tail stripe
+	const u32 numFullStripes = numWords == 0 ? 0 : (numWords - 1) / NumLanes;
+
+	u64 acc[NumLanes] = {};
+	u64 keys[NumLanes] = { LaneKeys[0] ^ seed, LaneKeys[1] ^ seed, LaneKeys[2] ^ seed, LaneKeys[3] ^ seed };
+	u32 stripe = 0;
+
+#if defined(__AVX2__)
+	__m256i accLanes = _mm256_setzero_si256();
+	__m256i keyLanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+	const __m256i stepLanes = _mm256_set1_epi64x(static_cast<long long>(KeyStep));
+
+	for (; stripe < numFullStripes; ++stripe)
+	{
+		const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + stripe * NumLanes));
+		const __m256i keyed = _mm256_xor_si256(data, keyLanes);
+		const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+		accLanes = _mm256_add_epi64(accLanes, _mm256_add_epi64(product, data));
+		keyLanes = _mm256_add_epi64(keyLanes, stepLanes);
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), accLanes);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(keys), keyLanes);
+#endif
+
+	for (; stripe < numFullStripes; ++stripe)
+		accumulateStripe(acc, keys, words + stripe * NumLanes);
+
+	if (numWords != 0)
+	{
+		BitWordType tail[NumLanes] = {};
+		const u32 firstTailWord = numFullStripes * NumLanes;
+		for (u32 i = firstTailWord; i < numWords; ++i)
+			tail[i - firstTailWord] = words[i];
+		if (bitword::hasDanglingPart(bits.numBits()))
+			tail[numWords - 1 - firstTailWord] &= bitword::getDanglingPart(bits.numBits());
+
+		accumulateStripe(acc, keys, tail);
+	}
+
+	u64 result = mix(seed ^ (static_cast<u64>(bits.numBits()) * KeyStep));
+	for (u32 lane = 0; lane < NumLanes; ++lane)
+		result = mix(result ^ acc[lane]);
+	return result;
+}
+
+u64 xorHash(const ConstBitSpan& bits, u64 seed)
+{
+	u64 result = 0;
+	bits.foreachSetBit([&result, seed](u32 bit) { result ^= bitKey(bit, seed); });
+	return result;
+}
+
+}
+}
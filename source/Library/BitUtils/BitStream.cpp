@@ -0,0 +1,264 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BitStream.h>
+
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/Checksum/Crc32c.h>
+#include "FileIO.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ddahlkvist
+{
+
+namespace
+{
+
+BitStreamHeader makeHeader(u32 numBits, const BitStreamOptions& options)
+{
+	BitStreamHeader header;
+	memset(&header, 0, sizeof(BitStreamHeader));
+	header.magic = BitStreamHeader::Magic;
+	header.version = BitStreamHeader::CurrentVersion;
+	header.flags = options.chunkChecksums ? BitStreamHeader::FlagChunkChecksums : 0;
+	header.byteOrderMark = BitStreamHeader::ByteOrderMark;
+	header.numBits = numBits;
+	header.wordsPerChunk = options.wordsPerChunk;
+	header.headerChecksum = header.computeHeaderChecksum();
+	return header;
+}
+
+// crc of a chunk as it is stored, the dangling bits of the last word are always stored cleared
+u32 computeChunkChecksum(const BitWordType* words, u32 numWords, bool containsLastWord, BitWordType danglingMask)
+{
+	if (!containsLastWord)
+		return crc32c(words, numWords * sizeof(BitWordType));
+
+	const u32 crc = crc32c(words, (numWords - 1) * sizeof(BitWordType));
+	const BitWordType last = words[numWords - 1] & danglingMask;
+	return crc32c(&last, sizeof(BitWordType), crc);
+}
+
+BitWordType getDanglingMask(u32 numBits)
+{
+	return bitword::hasDanglingPart(numBits) ? bitword::getDanglingPart(numBits) : bitword::Ones;
+}
+
+}
+
+u64 BitStreamHeader::getChecksumTableSize() const
+{
+	if (!hasChunkChecksums())
+		return 0;
+
+	const u64 numBytes = u64{ numChunks() } * sizeof(u32);
+	return (numBytes + sizeof(BitWordType) - 1) / sizeof(BitWordType) * sizeof(BitWordType);
+}
+
+u64 BitStreamHeader::getWordsOffset() const
+{
+	return sizeof(BitStreamHeader) + getChecksumTableSize();
+}
+
+u32 BitStreamHeader::computeHeaderChecksum() const
+{
+	BitStreamHeader copy = *this;
+	copy.headerChecksum = 0;
+	return crc32c(&copy, sizeof(BitStreamHeader));
+}
+
+bool BitStreamHeader::isCompatible() const
+{
+	return magic == Magic
+		&& version == CurrentVersion
+		&& byteOrderMark == ByteOrderMark
+		&& wordsPerChunk > 0
+		&& headerChecksum == computeHeaderChecksum();
+}
+
+u64 BitStreamWriter::getSerializedSize(u32 numBits, const BitStreamOptions& options)
+{
+	const BitStreamHeader header = makeHeader(numBits, options);
+	return header.getWordsOffset() + u64{ header.numWords() } * sizeof(BitWordType);
+}
+
+BitStreamStatus BitStreamWriter::write(int fd, const ConstBitSpan& bits, const BitStreamOptions& options)
+{
+	DD_ASSERT(options.wordsPerChunk > 0);
+
+	const BitStreamHeader header = makeHeader(bits.numBits(), options);
+	const u32 numWords = header.numWords();
+	const BitWordType* words = bits.data();
+	const BitWordType danglingMask = getDanglingMask(bits.numBits());
+
+	std::vector<u32> checksums;
+	if (header.hasChunkChecksums())
+	{
+		checksums.resize(header.getChecksumTableSize() / sizeof(u32), 0u);
+
+		for (u32 chunk = 0; chunk < header.numChunks(); ++chunk)
+		{
+			const u32 begin = chunk * header.wordsPerChunk;
+			const u32 end = std::min(begin + header.wordsPerChunk, numWords);
+			checksums[chunk] = computeChunkChecksum(words + begin, end - begin, end == numWords, danglingMask);
+		}
+	}
+
+	// everything but the last word is written straight from the span
+	const BitWordType lastWord = numWords > 0 ? (words[numWords - 1] & danglingMask) : bitword::Zero;
+
+	fileio::Segment segments[4];
+	u32 numSegments = 0;
+	segments[numSegments++] = { &header, sizeof(BitStreamHeader) };
+	if (!checksums.empty())
+		segments[numSegments++] = { checksums.data(), checksums.size() * sizeof(u32) };
+	if (numWords > 1)
+		segments[numSegments++] = { words, u64{ numWords - 1 } * sizeof(BitWordType) };
+	if (numWords > 0)
+		segments[numSegments++] = { &lastWord, sizeof(BitWordType) };
+
+	if (!fileio::writeSegments(fd, segments, numSegments))
+		return BitStreamStatus::IoError;
+
+	return BitStreamStatus::Ok;
+}
+
+BitStreamReader::BitStreamReader(int fd)
+	: _fd(fd)
+{
+}
+
+BitStreamStatus BitStreamReader::readHeader()
+{
+	_streamOffset = fileio::getOffset(_fd);
+
+	if (!fileio::readExact(_fd, &_header, sizeof(BitStreamHeader)))
+		return BitStreamStatus::IoError;
+
+	if (!_header.isCompatible())
+		return BitStreamStatus::IncompatibleHeader;
+
+	_checksums.resize(_header.getChecksumTableSize() / sizeof(u32));
+	if (!_checksums.empty() && !fileio::readExact(_fd, _checksums.data(), _checksums.size() * sizeof(u32)))
+		return BitStreamStatus::IoError;
+
+	return BitStreamStatus::Ok;
+}
+
+u32 BitStreamReader::getNumWordsRequiredForRange(u32 firstBit, u32 numBits)
+{
+	if (numBits == 0)
+		return 0;
+
+	const u32 firstWord = firstBit / NumBitsInWord;
+	const u32 lastWord = (firstBit + numBits - 1) / NumBitsInWord;
+	return lastWord - firstWord + 1;
+}
+
+BitStreamStatus BitStreamReader::readAll(BitWordType* words, bool verify)
+{
+	DD_ASSERT(_header.magic == BitStreamHeader::Magic);
+
+	const u32 numWords = _header.numWords();
+	if (!fileio::readExact(_fd, words, u64{ numWords } * sizeof(BitWordType)))
+		return BitStreamStatus::IoError;
+
+	if (verify && _header.hasChunkChecksums())
+	{
+		const BitWordType danglingMask = getDanglingMask(_header.numBits);
+
+		for (u32 chunk = 0; chunk < _header.numChunks(); ++chunk)
+		{
+			const u32 begin = chunk * _header.wordsPerChunk;
+			const u32 end = std::min(begin + _header.wordsPerChunk, numWords);
+			if (computeChunkChecksum(words + begin, end - begin, end == numWords, danglingMask) != _checksums[chunk])
+				return BitStreamStatus::ChecksumMismatch;
+		}
+	}
+
+	BitSpan(words, _header.numBits).clearDanglingBits();
+	return BitStreamStatus::Ok;
+}
+
+BitStreamStatus BitStreamReader::readRange(u32 firstBit, u32 numBits, BitWordType* words, bool verify)
+{
+	DD_ASSERT(_header.magic == BitStreamHeader::Magic);
+
+	if (u64{ firstBit } + numBits > _header.numBits)
+		return BitStreamStatus::OutOfRange;
+
+	if (numBits == 0)
+		return BitStreamStatus::Ok;
+
+	const u32 firstWord = firstBit / NumBitsInWord;
+	const u32 numWords = getNumWordsRequiredForRange(firstBit, numBits);
+
+	const BitStreamStatus status = readChunkRange(firstWord, numWords, words, verify);
+	if (status != BitStreamStatus::Ok)
+		return status;
+
+	// move firstBit down to bit 0
+	const u32 shift = firstBit % NumBitsInWord;
+	if (shift != 0)
+	{
+		for (u32 i = 0; i + 1 < numWords; ++i)
+			words[i] = (words[i] >> shift) | (words[i + 1] << (NumBitsInWord - shift));
+
+		words[numWords - 1] >>= shift;
+	}
+
+	BitSpan(words, numBits).clearDanglingBits();
+	return BitStreamStatus::Ok;
+}
+
+BitStreamStatus BitStreamReader::readChunkRange(u32 firstWord, u32 numWords, BitWordType* words, bool verify)
+{
+	if (_streamOffset < 0)
+		return BitStreamStatus::IoError; // not seekable
+
+	const u64 wordsOffset = static_cast<u64>(_streamOffset) + _header.getWordsOffset();
+
+	if (!verify || !_header.hasChunkChecksums())
+	{
+		if (!fileio::readAt(_fd, wordsOffset + u64{ firstWord } * sizeof(BitWordType), words, u64{ numWords } * sizeof(BitWordType)))
+			return BitStreamStatus::IoError;
+
+		return BitStreamStatus::Ok;
+	}
+
+	const u32 totalWords = _header.numWords();
+	const u32 wordsPerChunk = _header.wordsPerChunk;
+	const u32 endWord = firstWord + numWords;
+	const BitWordType danglingMask = getDanglingMask(_header.numBits);
+
+	for (u32 chunk = firstWord / wordsPerChunk; chunk * wordsPerChunk < endWord; ++chunk)
+	{
+		const u32 chunkBegin = chunk * wordsPerChunk;
+		const u32 chunkEnd = std::min(chunkBegin + wordsPerChunk, totalWords);
+		const u32 overlapBegin = std::max(chunkBegin, firstWord);
+		const u32 overlapEnd = std::min(chunkEnd, endWord);
+		const u32 chunkSize = chunkEnd - chunkBegin;
+
+		// chunks fully covered by the range are read in place, edge chunks go through scratch to be verifiable
+		const bool inPlace = overlapBegin == chunkBegin && overlapEnd == chunkEnd;
+		BitWordType* destination = words + (chunkBegin - firstWord);
+		if (!inPlace)
+		{
+			_scratch.resize(chunkSize);
+			destination = _scratch.data();
+		}
+
+		if (!fileio::readAt(_fd, wordsOffset + u64{ chunkBegin } * sizeof(BitWordType), destination, u64{ chunkSize } * sizeof(BitWordType)))
+			return BitStreamStatus::IoError;
+
+		if (computeChunkChecksum(destination, chunkSize, chunkEnd == totalWords, danglingMask) != _checksums[chunk])
+			return BitStreamStatus::ChecksumMismatch;
+
+		if (!inPlace)
+			memcpy(words + (overlapBegin - firstWord), destination + (overlapBegin - chunkBegin), (overlapEnd - overlapBegin) * sizeof(BitWordType));
+	}
+
+	return BitStreamStatus::Ok;
+}
+
+}
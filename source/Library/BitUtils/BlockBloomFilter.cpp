@@ -0,0 +1,39 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/BlockBloomFilter.h>
+
+#include "FileIO.h"
+
+namespace ddahlkvist
+{
+namespace bloomfilter
+{
+
+BitStreamStatus write(int fd, u32 blockBits, const ConstBitSpan& bits)
+{
+	BloomFilterHeader header = {};
+	header.magic = BloomFilterHeader::Magic;
+	header.version = BloomFilterHeader::CurrentVersion;
+	header.blockBits = static_cast<u16>(blockBits);
+	header.numBlocks = bits.numBits() / blockBits;
+
+	const fileio::Segment segment = { &header, sizeof(header) };
+	if (!fileio::writeSegments(fd, &segment, 1))
+		return BitStreamStatus::IoError;
+
+	return BitStreamWriter::write(fd, bits);
+}
+
+BitStreamStatus readHeader(int fd, u32 blockBits, BloomFilterHeader& header)
+{
+	if (!fileio::readExact(fd, &header, sizeof(header)))
+		return BitStreamStatus::IoError;
+
+	// a filter with another block size maps keys differently and can not be reinterpreted
+	if (header.magic != BloomFilterHeader::Magic || header.version != BloomFilterHeader::CurrentVersion || header.blockBits != blockBits)
+		return BitStreamStatus::IncompatibleHeader;
+
+	return BitStreamStatus::Ok;
+}
+
+}
+}
@@ -0,0 +1,297 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include "FileIO.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace ddahlkvist
+{
+namespace fileio
+{
+
+namespace
+{
+constexpr u64 MaxBytesPerCall = 1ull << 30;
+}
+
+#if defined(_WIN32)
+
+int openForRead(const char* path)
+{
+	int fd = -1;
+	_sopen_s(&fd, path, _O_RDONLY | _O_BINARY, _SH_DENYNO, 0);
+	return fd;
+}
+
+int openForWrite(const char* path)
+{
+	int fd = -1;
+	_sopen_s(&fd, path, _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+	return fd;
+}
+
+void closeFile(int fd)
+{
+	_close(fd);
+}
+
+bool isSameFile(const char* lhs, const char* rhs)
+{
+	// st_ino is always zero on windows, the volume serial and file index identify a file instead
+	auto getInfo = [](const char* path, BY_HANDLE_FILE_INFORMATION& info) {
+		HANDLE file = CreateFileA(path, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		const bool result = GetFileInformationByHandle(file, &info) != 0;
+		CloseHandle(file);
+		return result;
+	};
+
+	BY_HANDLE_FILE_INFORMATION lhsInfo;
+	BY_HANDLE_FILE_INFORMATION rhsInfo;
+	if (!getInfo(lhs, lhsInfo) || !getInfo(rhs, rhsInfo))
+		return false;
+
+	return lhsInfo.dwVolumeSerialNumber == rhsInfo.dwVolumeSerialNumber
+		&& lhsInfo.nFileIndexHigh == rhsInfo.nFileIndexHigh
+		&& lhsInfo.nFileIndexLow == rhsInfo.nFileIndexLow;
+}
+
+void adviseSequential(int)
+{
+}
+
+bool writeSegments(int fd, const Segment* segments, u32 numSegments)
+{
+	for (u32 i = 0; i < numSegments; ++i)
+	{
+		const u8* it = static_cast<const u8*>(segments[i].data);
+		u64 remaining = segments[i].numBytes;
+
+		while (remaining > 0)
+		{
+			const unsigned int request = static_cast<unsigned int>(std::min(remaining, MaxBytesPerCall));
+			const int written = _write(fd, it, request);
+			if (written <= 0)
+				return false;
+
+			it += written;
+			remaining -= static_cast<u64>(written);
+		}
+	}
+
+	return true;
+}
+
+bool readExact(int fd, void* destination, u64 numBytes)
+{
+	u8* it = static_cast<u8*>(destination);
+
+	while (numBytes > 0)
+	{
+		const unsigned int request = static_cast<unsigned int>(std::min(numBytes, MaxBytesPerCall));
+		const int numRead = _read(fd, it, request);
+		if (numRead <= 0)
+			return false;
+
+		it += numRead;
+		numBytes -= static_cast<u64>(numRead);
+	}
+
+	return true;
+}
+
+bool writeAt(int fd, u64 offset, const void* source, u64 numBytes)
+{
+	if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0)
+		return false;
+
+	const Segment segment = { source, numBytes };
+	return writeSegments(fd, &segment, 1);
+}
+
+bool readAt(int fd, u64 offset, void* destination, u64 numBytes)
+{
+	if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0)
+		return false;
+
+	return readExact(fd, destination, numBytes);
+}
+
+s64 getOffset(int fd)
+{
+	return _lseeki64(fd, 0, SEEK_CUR);
+}
+
+#else
+
+int openForRead(const char* path)
+{
+	return open(path, O_RDONLY);
+}
+
+int openForWrite(const char* path)
+{
+	return open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+}
+
+void closeFile(int fd)
+{
+	close(fd);
+}
+
+bool isSameFile(const char* lhs, const char* rhs)
+{
+	struct stat lhsInfo;
+	struct stat rhsInfo;
+	if (stat(lhs, &lhsInfo) != 0 || stat(rhs, &rhsInfo) != 0)
+		return false;
+
+	return lhsInfo.st_dev == rhsInfo.st_dev && lhsInfo.st_ino == rhsInfo.st_ino;
+}
+
+void adviseSequential(int fd)
+{
+#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+bool writeSegments(int fd, const Segment* segments, u32 numSegments)
+{
+	std::vector<iovec> vectors;
+	vectors.reserve(numSegments);
+
+	for (u32 i = 0; i < numSegments; ++i)
+	{
+		const u8* it = static_cast<const u8*>(segments[i].data);
+		u64 remaining = segments[i].numBytes;
+
+		while (remaining > 0)
+		{
+			const u64 numBytes = std::min(remaining, MaxBytesPerCall);
+			vectors.push_back({ const_cast<u8*>(it), static_cast<size_t>(numBytes) });
+			it += numBytes;
+			remaining -= numBytes;
+		}
+	}
+
+	constexpr size_t MaxVectorsPerCall = 1024; // IOV_MAX on linux
+	size_t index = 0;
+
+	while (index < vectors.size())
+	{
+		const int count = static_cast<int>(std::min(vectors.size() - index, MaxVectorsPerCall));
+		ssize_t written = writev(fd, &vectors[index], count);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		while (written > 0)
+		{
+			iovec& current = vectors[index];
+			if (static_cast<size_t>(written) >= current.iov_len)
+			{
+				written -= static_cast<ssize_t>(current.iov_len);
+				index++;
+			}
+			else
+			{
+				current.iov_base = static_cast<u8*>(current.iov_base) + written;
+				current.iov_len -= static_cast<size_t>(written);
+				written = 0;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool readExact(int fd, void* destination, u64 numBytes)
+{
+	u8* it = static_cast<u8*>(destination);
+
+	while (numBytes > 0)
+	{
+		const ssize_t numRead = read(fd, it, static_cast<size_t>(std::min(numBytes, MaxBytesPerCall)));
+		if (numRead < 0 && errno == EINTR)
+			continue;
+		if (numRead <= 0)
+			return false;
+
+		it += numRead;
+		numBytes -= static_cast<u64>(numRead);
+	}
+
+	return true;
+}
+
+bool writeAt(int fd, u64 offset, const void* source, u64 numBytes)
+{
+	const u8* it = static_cast<const u8*>(source);
+
+	while (numBytes > 0)
+	{
+		const ssize_t written = pwrite(fd, it, static_cast<size_t>(std::min(numBytes, MaxBytesPerCall)), static_cast<off_t>(offset));
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return false;
+
+		it += written;
+		offset += static_cast<u64>(written);
+		numBytes -= static_cast<u64>(written);
+	}
+
+	return true;
+}
+
+bool readAt(int fd, u64 offset, void* destination, u64 numBytes)
+{
+	u8* it = static_cast<u8*>(destination);
+
+	while (numBytes > 0)
+	{
+		const ssize_t numRead = pread(fd, it, static_cast<size_t>(std::min(numBytes, MaxBytesPerCall)), static_cast<off_t>(offset));
+		if (numRead < 0 && errno == EINTR)
+			continue;
+		if (numRead <= 0)
+			return false;
+
+		it += numRead;
+		offset += static_cast<u64>(numRead);
+		numBytes -= static_cast<u64>(numRead);
+	}
+
+	return true;
+}
+
+s64 getOffset(int fd)
+{
+	return static_cast<s64>(lseek(fd, 0, SEEK_CUR));
+}
+
+#endif
+
+}
+}
@@ -0,0 +1,44 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+
+namespace ddahlkvist
+{
+namespace fileio
+{
+
+// thin wrappers around file descriptor io that retry on partial transfers/interrupts
+// all of them return false on error or unexpected end of file
+
+int openForRead(const char* path);
+int openForWrite(const char* path); // creates or truncates
+void closeFile(int fd);
+
+// true if both paths exist and name the same file [links and different spellings of a path included]
+bool isSameFile(const char* lhs, const char* rhs);
+
+// hint that fd will be read front to back, allowing the OS to read ahead aggressively
+void adviseSequential(int fd);
+
+struct Segment
+{
+	const void* data;
+	u64 numBytes;
+};
+
+// gathers all segments into as few system calls as possible [writev where available]
+bool writeSegments(int fd, const Segment* segments, u32 numSegments);
+
+bool writeAt(int fd, u64 offset, const void* source, u64 numBytes);
+
+bool readExact(int fd, void* destination, u64 numBytes);
+
+// positioned read, does not move the file offset where the platform supports it [pread]
+bool readAt(int fd, u64 offset, void* destination, u64 numBytes);
+
+// current offset of fd, negative if the descriptor is not seekable [pipes, sockets]
+s64 getOffset(int fd);
+
+}
+}
@@ -0,0 +1,394 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/MappedBitBuffer.h>
+
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ddahlkvist
+{
+
+namespace
+{
+
+constexpr u64 HeaderSize = sizeof(BitFileHeader);
+
+constexpr u64 ChecksumPrime = 0x9E3779B185EBCA87ull;
+
+inline u64 rotateLeft(u64 value, u32 shift)
+{
+	return (value << shift) | (value >> (64 - shift));
+}
+
+inline void mixChecksumLane(u64& lane, BitWordType word)
+{
+	lane = rotateLeft((lane ^ word) * ChecksumPrime, 31);
+}
+
+inline void mixChecksumGroup(u64 (&lanes)[4], const BitWordType* words)
+{
+	for (u32 lane = 0; lane < 4; ++lane)
+		mixChecksumLane(lanes[lane], words[lane]);
+}
+
+u64 getFileSize(u32 numBits)
+{
+	return HeaderSize + u64{ bitword::getNumWordsRequired(numBits) } * sizeof(BitWordType);
+}
+
+struct Mapping
+{
+	void* address = nullptr;
+	u64 size = 0;
+	void* fileHandle = nullptr;
+};
+
+#if defined(_WIN32)
+Mapping mapFile(const char* path, bool writable, bool create, u64 createSize)
+{
+	Mapping result;
+
+	const DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+	HANDLE file = CreateFileA(path, access, FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return result;
+
+	LARGE_INTEGER size;
+	if (create)
+	{
+		size.QuadPart = static_cast<LONGLONG>(createSize);
+		if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+		{
+			CloseHandle(file);
+			return result;
+		}
+	}
+	else if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return result;
+	}
+
+	if (static_cast<u64>(size.QuadPart) < HeaderSize)
+	{
+		CloseHandle(file);
+		return result;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return result;
+	}
+
+	void* address = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping); // view keeps the mapping object alive
+
+	if (address == nullptr)
+	{
+		CloseHandle(file);
+		return result;
+	}
+
+	result.address = address;
+	result.size = static_cast<u64>(size.QuadPart);
+	result.fileHandle = file;
+	return result;
+}
+
+void unmapFile(Mapping& mapping)
+{
+	UnmapViewOfFile(mapping.address);
+	CloseHandle(static_cast<HANDLE>(mapping.fileHandle));
+}
+
+bool syncFile(const Mapping& mapping)
+{
+	if (!FlushViewOfFile(mapping.address, 0))
+		return false;
+
+	return FlushFileBuffers(static_cast<HANDLE>(mapping.fileHandle)) != 0;
+}
+#else
+Mapping mapFile(const char* path, bool writable, bool create, u64 createSize)
+{
+	Mapping result;
+
+	const int flags = (writable ? O_RDWR : O_RDONLY) | (create ? (O_CREAT | O_TRUNC) : 0);
+	const int fd = ::open(path, flags, 0644);
+	if (fd < 0)
+		return result;
+
+	u64 size = createSize;
+	if (create)
+	{
+		if (ftruncate(fd, static_cast<off_t>(createSize)) != 0)
+		{
+			::close(fd);
+			return result;
+		}
+	}
+	else
+	{
+		struct stat info;
+		if (fstat(fd, &info) != 0)
+		{
+			::close(fd);
+			return result;
+		}
+		size = static_cast<u64>(info.st_size);
+	}
+
+	if (size < HeaderSize)
+	{
+		::close(fd);
+		return result;
+	}
+
+	void* address = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd); // mapping stays valid after the descriptor is closed
+
+	if (address == MAP_FAILED)
+		return result;
+
+	result.address = address;
+	result.size = size;
+	return result;
+}
+
+void unmapFile(Mapping& mapping)
+{
+	munmap(mapping.address, mapping.size);
+}
+
+bool syncFile(const Mapping& mapping)
+{
+	return msync(mapping.address, mapping.size, MS_SYNC) == 0;
+}
+#endif
+
+}
+
+BitFileHeader BitFileHeader::create(u32 numBits)
+{
+	BitFileHeader header;
+	memset(&header, 0, sizeof(BitFileHeader));
+	header.magic = Magic;
+	header.version = CurrentVersion;
+	header.wordSize = sizeof(BitWordType);
+	header.byteOrderMark = ByteOrderMark;
+	header.numBits = numBits;
+	header.numWords = bitword::getNumWordsRequired(numBits);
+	return header;
+}
+
+bool BitFileHeader::isCompatible() const
+{
+	return magic == Magic
+		&& version == CurrentVersion
+		&& wordSize == sizeof(BitWordType)
+		&& byteOrderMark == ByteOrderMark
+		&& numWords == bitword::getNumWordsRequired(numBits);
+}
+
+BitFileChecksum::BitFileChecksum()
+	: _lanes{ ChecksumPrime, ChecksumPrime ^ 1, ChecksumPrime ^ 2, ChecksumPrime ^ 3 }
+{
+}
+
+void BitFileChecksum::append(const BitWordType* words, u64 numWords)
+{
+	// the last [up to four] words are held back since the version 1 format mixes the tail words differently,
+	// which keeps the result independent of how words are split into appends
+	u64 i = 0;
+	for (; i < numWords && _numPending < 4; ++i)
+		_pending[_numPending++] = words[i];
+
+	if (i == numWords)
+		return;
+
+	mixChecksumGroup(_lanes, _pending);
+
+	// four independent lanes to not serialize on the multiply latency
+	for (; i + 4 < numWords; i += 4)
+		mixChecksumGroup(_lanes, words + i);
+
+	_numPending = 0;
+	for (; i < numWords; ++i)
+		_pending[_numPending++] = words[i];
+}
+
+u64 BitFileChecksum::finish(u32 numBits) const
+{
+	const bool hasDanglingWord = bitword::hasDanglingPart(numBits);
+	DD_ASSERT(!hasDanglingWord || _numPending != 0);
+
+	u64 lanes[4] = { _lanes[0], _lanes[1], _lanes[2], _lanes[3] };
+
+	// full words after the last group of four go to lane 0, the dangling word to lane 1
+	const u32 numFullWords = hasDanglingWord ? _numPending - 1 : _numPending;
+	if (numFullWords == 4)
+	{
+		mixChecksumGroup(lanes, _pending);
+	}
+	else
+	{
+		for (u32 i = 0; i < numFullWords; ++i)
+			mixChecksumLane(lanes[0], _pending[i]);
+	}
+
+	if (hasDanglingWord)
+		mixChecksumLane(lanes[1], _pending[numFullWords]);
+
+	u64 result = numBits;
+	for (u32 lane = 0; lane < 4; ++lane)
+		result = rotateLeft((result ^ lanes[lane]) * ChecksumPrime, 27);
+
+	return result;
+}
+
+u64 computeBitFileChecksum(const BitWordType* words, u32 numBits)
+{
+	const u32 numFullWords = numBits / NumBitsInWord;
+
+	BitFileChecksum checksum;
+	checksum.append(words, numFullWords);
+
+	// dangling bits are not part of the bitmap and never affect the checksum
+	if (bitword::hasDanglingPart(numBits))
+	{
+		const BitWordType last = words[numFullWords] & bitword::getDanglingPart(numBits);
+		checksum.append(&last, 1);
+	}
+
+	return checksum.finish(numBits);
+}
+
+MappedBitBuffer::~MappedBitBuffer()
+{
+	close();
+}
+
+MappedBitBuffer::MappedBitBuffer(MappedBitBuffer&& other) noexcept
+	: _header(std::exchange(other._header, nullptr))
+	, _words(std::exchange(other._words, nullptr))
+	, _mappingSize(std::exchange(other._mappingSize, 0))
+	, _fileHandle(std::exchange(other._fileHandle, nullptr))
+	, _access(other._access)
+{
+}
+
+MappedBitBuffer& MappedBitBuffer::operator=(MappedBitBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		_header = std::exchange(other._header, nullptr);
+		_words = std::exchange(other._words, nullptr);
+		_mappingSize = std::exchange(other._mappingSize, 0);
+		_fileHandle = std::exchange(other._fileHandle, nullptr);
+		_access = other._access;
+	}
+	return *this;
+}
+
+MappedBitBuffer MappedBitBuffer::create(const char* path, u32 numBits)
+{
+	DD_ASSERT(numBits < 400000000); // sanity check against "-1 issues"
+
+	MappedBitBuffer result;
+
+	Mapping mapping = mapFile(path, true, true, getFileSize(numBits));
+	if (mapping.address == nullptr)
+		return result;
+
+	result._header = static_cast<BitFileHeader*>(mapping.address);
+	result._words = reinterpret_cast<BitWordType*>(static_cast<u8*>(mapping.address) + HeaderSize);
+	result._mappingSize = mapping.size;
+	result._fileHandle = mapping.fileHandle;
+	result._access = Access::ReadWrite;
+
+	// file is zero filled by the resize, only header needs to be written
+	*result._header = BitFileHeader::create(numBits);
+	result._header->checksum = computeBitFileChecksum(result._words, numBits);
+
+	return result;
+}
+
+MappedBitBuffer MappedBitBuffer::open(const char* path, Access access)
+{
+	MappedBitBuffer result;
+
+	Mapping mapping = mapFile(path, access == Access::ReadWrite, false, 0);
+	if (mapping.address == nullptr)
+		return result;
+
+	const auto* header = static_cast<const BitFileHeader*>(mapping.address);
+	if (!header->isCompatible() || mapping.size < getFileSize(header->numBits))
+	{
+		unmapFile(mapping);
+		return result;
+	}
+
+	result._header = static_cast<BitFileHeader*>(mapping.address);
+	result._words = reinterpret_cast<BitWordType*>(static_cast<u8*>(mapping.address) + HeaderSize);
+	result._mappingSize = mapping.size;
+	result._fileHandle = mapping.fileHandle;
+	result._access = access;
+
+	return result;
+}
+
+bool MappedBitBuffer::verifyChecksum() const
+{
+	if (!isValid())
+		return false;
+
+	return computeBitFileChecksum(_words, _header->numBits) == _header->checksum;
+}
+
+bool MappedBitBuffer::flush()
+{
+	if (!isValid() || !isWritable())
+		return false;
+
+	span().clearDanglingBits();
+	_header->checksum = computeBitFileChecksum(_words, _header->numBits);
+
+	Mapping mapping;
+	mapping.address = _header;
+	mapping.size = _mappingSize;
+	mapping.fileHandle = _fileHandle;
+	return syncFile(mapping);
+}
+
+void MappedBitBuffer::close()
+{
+	if (!isValid())
+		return;
+
+	Mapping mapping;
+	mapping.address = _header;
+	mapping.size = _mappingSize;
+	mapping.fileHandle = _fileHandle;
+	unmapFile(mapping);
+
+	_header = nullptr;
+	_words = nullptr;
+	_mappingSize = 0;
+	_fileHandle = nullptr;
+	_access = Access::ReadOnly;
+}
+
+}
@@ -0,0 +1,103 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/OutOfCoreBitOps.h>
+
+#include <Library/BitUtils/BitFileChunks.h>
+#include <Library/BitUtils/BitSpan.h>
+#include "FileIO.h"
+
+namespace ddahlkvist
+{
+namespace outofcore
+{
+
+bool countSetBits(const char* path, u64& result, const OutOfCoreOptions& options)
+{
+	BitFileChunkReader reader;
+	if (!reader.open(&path, 1, options.wordsPerChunk))
+		return false;
+
+	u64 counter = 0;
+	BitFileChunk chunk;
+	while (reader.nextChunk(chunk))
+		counter += BitSpan(chunk.words(0), chunk.numBits).countSetBits();
+
+	if (reader.failed())
+		return false;
+
+	result = counter;
+	return true;
+}
+
+bool countSetBitsAnd(const char* input, const char* filter, u64& result, const OutOfCoreOptions& options)
+{
+	const char* paths[2] = { input, filter };
+
+	BitFileChunkReader reader;
+	if (!reader.open(paths, 2, options.wordsPerChunk))
+		return false;
+
+	u64 counter = 0;
+	BitFileChunk chunk;
+	while (reader.nextChunk(chunk))
+	{
+		BitSpan lhs(chunk.words(0), chunk.numBits);
+		BitSpan rhs(chunk.words(1), chunk.numBits);
+		lhs &= rhs;
+		counter += lhs.countSetBits();
+	}
+
+	if (reader.failed())
+		return false;
+
+	result = counter;
+	return true;
+}
+
+bool combine(Op op, const char* const* inputs, u32 numInputs, const char* output, const OutOfCoreOptions& options)
+{
+	DD_ASSERT(numInputs > 0);
+
+	// the writer truncates the output, an input behind the same path would be destroyed while it is read
+	for (u32 i = 0; i < numInputs; ++i)
+	{
+		if (fileio::isSameFile(inputs[i], output))
+			return false;
+	}
+
+	BitFileChunkReader reader;
+	if (!reader.open(inputs, numInputs, options.wordsPerChunk))
+		return false;
+
+	BitFileChunkWriter writer;
+	if (!writer.open(output, reader.numBits()))
+		return false;
+
+	// first file of the chunk is used as accumulator, chunk buffers are owned by the reader and writable
+	BitFileChunk chunk;
+	while (reader.nextChunk(chunk))
+	{
+		BitSpan accumulator(chunk.words(0), chunk.numBits);
+
+		for (u32 i = 1; i < numInputs; ++i)
+		{
+			BitSpan other(chunk.words(i), chunk.numBits);
+			switch (op)
+			{
+			case Op::Or: accumulator |= other; break;
+			case Op::And: accumulator &= other; break;
+			case Op::Xor: accumulator ^= other; break;
+			}
+		}
+
+		if (!writer.append(chunk.words(0), chunk.numWords))
+			return false;
+	}
+
+	if (reader.failed())
+		return false;
+
+	return writer.finish();
+}
+
+}
+}
@@ -0,0 +1,62 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace ddahlkvist
+{
+namespace parallel
+{
+
+// 0 means one thread per hardware thread
+inline u32 resolveNumThreads(u32 numThreads)
+{
+	if (numThreads != 0)
+		return numThreads;
+
+	const u32 hardwareThreads = std::thread::hardware_concurrency();
+	return hardwareThreads != 0 ? hardwareThreads : 1u;
+}
+
+// number of ranges foreachRange will use, for sizing per range state up front
+inline u32 getNumRanges(u32 numItems, u32 minItemsPerRange, u32 numThreads)
+{
+	if (numItems == 0)
+		return 0;
+
+	const u32 maxRanges = std::max<u32>(1, numItems / std::max<u32>(1, minItemsPerRange));
+	return std::min(resolveNumThreads(numThreads), maxRanges);
+}
+
+// splits [0, numItems) into at most numThreads contiguous ranges of at least minItemsPerRange items
+// and calls action(rangeIndex, begin, end) for each, first range runs on the calling thread
+template<typename RangeAction>
+void foreachRange(u32 numItems, u32 minItemsPerRange, u32 numThreads, RangeAction&& action)
+{
+	if (numItems == 0)
+		return;
+
+	const u32 numRanges = getNumRanges(numItems, minItemsPerRange, numThreads);
+	const u32 itemsPerRange = (numItems + numRanges - 1) / numRanges;
+
+	std::vector<std::thread> threads;
+	threads.reserve(numRanges - 1);
+
+	for (u32 i = 1; i < numRanges; ++i)
+	{
+		const u32 begin = std::min(numItems, i * itemsPerRange);
+		const u32 end = std::min(numItems, begin + itemsPerRange);
+		threads.emplace_back([&action, i, begin, end]() { action(i, begin, end); });
+	}
+
+	action(0u, 0u, std::min(numItems, itemsPerRange));
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+}
+}
@@ -0,0 +1,98 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ddahlkvist
+{
+namespace rowmatch
+{
+
+// masks are require, any and exclude back to back, numWords each
+// a row matches when it has every require bit, no exclude bit and [when hasAny] at least one any bit
+
+inline bool matchRow(const BitWordType* row, const BitWordType* masks, bool hasAny, u32 numWords)
+{
+	const BitWordType* require = masks;
+	const BitWordType* any = masks + numWords;
+	const BitWordType* exclude = masks + 2 * numWords;
+
+	BitWordType missing = bitword::Zero;
+	BitWordType anyHits = bitword::Zero;
+	BitWordType excluded = bitword::Zero;
+	for (u32 i = 0; i < numWords; ++i)
+	{
+		missing |= require[i] & ~row[i];
+		anyHits |= any[i] & row[i];
+		excluded |= exclude[i] & row[i];
+	}
+	return missing == bitword::Zero && excluded == bitword::Zero && (!hasAny || anyHits != bitword::Zero);
+}
+
+// rows of exactly one word, one result bit per row [bit i = rows[i]], numRows <= NumBitsInWord
+inline BitWordType matchSingleWordRows(const BitWordType* rows, u32 numRows, const BitWordType* masks, bool hasAny)
+{
+	DD_ASSERT(numRows <= NumBitsInWord);
+
+	BitWordType bits = bitword::Zero;
+	u32 i = 0;
+
+#if defined(__AVX512F__)
+	const __m512i requireLanes = _mm512_set1_epi64(static_cast<long long>(masks[0]));
+	const __m512i anyLanes = _mm512_set1_epi64(static_cast<long long>(masks[1]));
+	const __m512i excludeLanes = _mm512_set1_epi64(static_cast<long long>(masks[2]));
+
+	for (; i + 8 <= numRows; i += 8)
+	{
+		const __m512i lanes = _mm512_loadu_si512(rows + i);
+		__mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_and_si512(lanes, requireLanes), requireLanes);
+		mask &= _mm512_testn_epi64_mask(lanes, excludeLanes);
+		if (hasAny)
+			mask &= _mm512_test_epi64_mask(lanes, anyLanes);
+		bits |= static_cast<BitWordType>(mask) << i;
+	}
+#elif defined(__AVX2__)
+	const __m256i requireLanes = _mm256_set1_epi64x(static_cast<long long>(masks[0]));
+	const __m256i anyLanes = _mm256_set1_epi64x(static_cast<long long>(masks[1]));
+	const __m256i excludeLanes = _mm256_set1_epi64x(static_cast<long long>(masks[2]));
+	const __m256i zero = _mm256_setzero_si256();
+
+	for (; i + 4 <= numRows; i += 4)
+	{
+		const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + i));
+
+		// all lanes that pass are all ones, the any test inverts a "no any bit" compare
+		__m256i pass = _mm256_cmpeq_epi64(_mm256_and_si256(lanes, requireLanes), requireLanes);
+		pass = _mm256_and_si256(pass, _mm256_cmpeq_epi64(_mm256_and_si256(lanes, excludeLanes), zero));
+		if (hasAny)
+			pass = _mm256_andnot_si256(_mm256_cmpeq_epi64(_mm256_and_si256(lanes, anyLanes), zero), pass);
+
+		bits |= static_cast<BitWordType>(_mm256_movemask_pd(_mm256_castsi256_pd(pass))) << i;
+	}
+#endif
+
+	for (; i < numRows; ++i)
+		bits |= static_cast<BitWordType>(matchRow(rows + i, masks, hasAny, 1)) << i;
+
+	return bits;
+}
+
+// numRows <= NumBitsInWord rows of wordsPerRow words packed back to back, one result bit per row
+inline BitWordType matchRows(const BitWordType* rows, u32 numRows, u32 wordsPerRow, const BitWordType* masks, bool hasAny)
+{
+	if (wordsPerRow == 1)
+		return matchSingleWordRows(rows, numRows, masks, hasAny);
+
+	BitWordType bits = bitword::Zero;
+	for (u32 i = 0; i < numRows; ++i, rows += wordsPerRow)
+		bits |= static_cast<BitWordType>(matchRow(rows, masks, hasAny, wordsPerRow)) << i;
+	return bits;
+}
+
+}
+}
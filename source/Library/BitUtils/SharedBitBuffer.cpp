@@ -0,0 +1,316 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/BitUtils/SharedBitBuffer.h>
+
+#include <cstring>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ddahlkvist
+{
+
+namespace
+{
+
+constexpr u64 HeaderSize = sizeof(SharedBitHeader);
+
+u64 getObjectSize(u32 numBits)
+{
+	return HeaderSize + u64{ bitword::getNumWordsRequired(numBits) } * sizeof(BitWordType);
+}
+
+struct Mapping
+{
+	void* address = nullptr;
+	u64 size = 0;
+	void* handle = nullptr;
+};
+
+#if defined(_WIN32)
+Mapping mapObject(const char* name, bool writable, bool create, u64 createSize)
+{
+	Mapping result;
+
+	// page file backed sections are zero filled, just like a truncated shm object
+	HANDLE mapping = create
+		? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(createSize >> 32), static_cast<DWORD>(createSize), name)
+		: OpenFileMappingA(writable ? FILE_MAP_WRITE : FILE_MAP_READ, FALSE, name);
+	if (mapping == nullptr)
+		return result;
+
+	// an existing section is returned as is, with its old size and contents
+	const bool reused = create && GetLastError() == ERROR_ALREADY_EXISTS;
+
+	void* address = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+	if (address == nullptr)
+	{
+		CloseHandle(mapping);
+		return result;
+	}
+
+	MEMORY_BASIC_INFORMATION info;
+	const u64 minSize = create ? createSize : HeaderSize;
+	if (VirtualQuery(address, &info, sizeof(info)) == 0 || info.RegionSize < minSize)
+	{
+		UnmapViewOfFile(address);
+		CloseHandle(mapping);
+		return result;
+	}
+
+	// cleared to match the posix path, which truncates an existing object on create
+	if (reused)
+		memset(address, 0, createSize);
+
+	result.address = address;
+	result.size = create ? createSize : static_cast<u64>(info.RegionSize);
+	result.handle = mapping;
+	return result;
+}
+
+void unmapObject(Mapping& mapping)
+{
+	UnmapViewOfFile(mapping.address);
+	CloseHandle(static_cast<HANDLE>(mapping.handle));
+}
+
+bool unlinkObject(const char*)
+{
+	// the section is released together with its last handle
+	return true;
+}
+#else
+Mapping mapObject(const char* name, bool writable, bool create, u64 createSize)
+{
+	Mapping result;
+
+	const int flags = (writable ? O_RDWR : O_RDONLY) | (create ? (O_CREAT | O_TRUNC) : 0);
+	const int fd = shm_open(name, flags, 0644);
+	if (fd < 0)
+		return result;
+
+	u64 size = createSize;
+	if (create)
+	{
+		if (ftruncate(fd, static_cast<off_t>(createSize)) != 0)
+		{
+			::close(fd);
+			return result;
+		}
+	}
+	else
+	{
+		struct stat info;
+		if (fstat(fd, &info) != 0)
+		{
+			::close(fd);
+			return result;
+		}
+		size = static_cast<u64>(info.st_size);
+	}
+
+	if (size < HeaderSize)
+	{
+		::close(fd);
+		return result;
+	}
+
+	void* address = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd); // mapping stays valid after the descriptor is closed
+
+	if (address == MAP_FAILED)
+		return result;
+
+	result.address = address;
+	result.size = size;
+	return result;
+}
+
+void unmapObject(Mapping& mapping)
+{
+	munmap(mapping.address, mapping.size);
+}
+
+bool unlinkObject(const char* name)
+{
+	return shm_unlink(name) == 0;
+}
+#endif
+
+}
+
+bool SharedBitHeader::isCompatible() const
+{
+	return magic == Magic
+		&& version == CurrentVersion
+		&& wordSize == sizeof(BitWordType)
+		&& numWords == bitword::getNumWordsRequired(numBits);
+}
+
+SharedBitBuffer::~SharedBitBuffer()
+{
+	close();
+}
+
+SharedBitBuffer::SharedBitBuffer(SharedBitBuffer&& other) noexcept
+	: _header(std::exchange(other._header, nullptr))
+	, _words(std::exchange(other._words, nullptr))
+	, _mappingSize(std::exchange(other._mappingSize, 0))
+	, _handle(std::exchange(other._handle, nullptr))
+	, _access(other._access)
+{
+}
+
+SharedBitBuffer& SharedBitBuffer::operator=(SharedBitBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		_header = std::exchange(other._header, nullptr);
+		_words = std::exchange(other._words, nullptr);
+		_mappingSize = std::exchange(other._mappingSize, 0);
+		_handle = std::exchange(other._handle, nullptr);
+		_access = other._access;
+	}
+	return *this;
+}
+
+SharedBitBuffer SharedBitBuffer::create(const char* name, u32 numBits)
+{
+	DD_ASSERT(numBits < 400000000); // sanity check against "-1 issues"
+
+	SharedBitBuffer result;
+
+	Mapping mapping = mapObject(name, true, true, getObjectSize(numBits));
+	if (mapping.address == nullptr)
+		return result;
+
+	result._header = static_cast<SharedBitHeader*>(mapping.address);
+	result._words = reinterpret_cast<BitWordType*>(static_cast<u8*>(mapping.address) + HeaderSize);
+	result._mappingSize = mapping.size;
+	result._handle = mapping.handle;
+	result._access = Access::ReadWrite;
+
+	// object is zero filled on creation, sequence is written last so a reader never sees a half written header as valid
+	SharedBitHeader* header = result._header;
+	header->version = SharedBitHeader::CurrentVersion;
+	header->wordSize = sizeof(BitWordType);
+	header->numBits = numBits;
+	header->numWords = bitword::getNumWordsRequired(numBits);
+	header->sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = SharedBitHeader::Magic;
+
+	return result;
+}
+
+SharedBitBuffer SharedBitBuffer::open(const char* name, Access access)
+{
+	SharedBitBuffer result;
+
+	Mapping mapping = mapObject(name, access == Access::ReadWrite, false, 0);
+	if (mapping.address == nullptr)
+		return result;
+
+	const auto* header = static_cast<const SharedBitHeader*>(mapping.address);
+	if (!header->isCompatible() || mapping.size < getObjectSize(header->numBits))
+	{
+		unmapObject(mapping);
+		return result;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	result._header = static_cast<SharedBitHeader*>(mapping.address);
+	result._words = reinterpret_cast<BitWordType*>(static_cast<u8*>(mapping.address) + HeaderSize);
+	result._mappingSize = mapping.size;
+	result._handle = mapping.handle;
+	result._access = access;
+
+	return result;
+}
+
+bool SharedBitBuffer::unlink(const char* name)
+{
+	return unlinkObject(name);
+}
+
+void SharedBitBuffer::beginWrite()
+{
+	DD_ASSERT(isWritable());
+
+	const u64 sequence = _header->sequence.load(std::memory_order_relaxed);
+	DD_ASSERT((sequence & 1) == 0); // writes do not nest and there is only one writer
+
+	// the fence keeps the word stores that follow from becoming visible before the odd sequence
+	_header->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedBitBuffer::endWrite()
+{
+	DD_ASSERT(isWritable());
+
+	const u64 sequence = _header->sequence.load(std::memory_order_relaxed);
+	DD_ASSERT((sequence & 1) == 1);
+
+	span().clearDanglingBits();
+	_header->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+u64 SharedBitBuffer::readSnapshot(BitSpan& out) const
+{
+	DD_ASSERT(out.numBits() == numBits());
+
+	const u32 numWords = bitword::getNumWordsRequired(numBits());
+	BitWordType* target = out.data();
+
+	for (;;)
+	{
+		const u64 before = _header->sequence.load(std::memory_order_acquire);
+		if ((before & 1) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (u32 i = 0; i < numWords; ++i)
+			target[i] = bitword::atomicLoad(_words + i);
+
+		// orders the word loads before the second sequence load, a changed sequence means a write overlapped the copy
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (_header->sequence.load(std::memory_order_relaxed) == before)
+		{
+			out.clearDanglingBits();
+			return before / 2;
+		}
+	}
+}
+
+void SharedBitBuffer::close()
+{
+	if (!isValid())
+		return;
+
+	Mapping mapping;
+	mapping.address = _header;
+	mapping.size = _mappingSize;
+	mapping.handle = _handle;
+	unmapObject(mapping);
+
+	_header = nullptr;
+	_words = nullptr;
+	_mappingSize = 0;
+	_handle = nullptr;
+	_access = Access::ReadOnly;
+}
+
+}
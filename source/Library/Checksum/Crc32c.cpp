@@ -0,0 +1,84 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Checksum/Crc32c.h>
+
+#include <cstring>
+
+#if defined(_MSC_VER) || defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define DD_HAS_HARDWARE_CRC32C 1
+#endif
+
+namespace ddahlkvist
+{
+
+#if defined(DD_HAS_HARDWARE_CRC32C)
+
+u32 crc32c(const void* data, usize numBytes, u32 crc)
+{
+	const u8* it = static_cast<const u8*>(data);
+	u64 value = ~crc & 0xFFFFFFFFull;
+
+	while (numBytes >= sizeof(u64))
+	{
+		u64 word;
+		memcpy(&word, it, sizeof(u64));
+		value = _mm_crc32_u64(value, word);
+		it += sizeof(u64);
+		numBytes -= sizeof(u64);
+	}
+
+	u32 tail = static_cast<u32>(value);
+	while (numBytes > 0)
+	{
+		tail = _mm_crc32_u8(tail, *it);
+		it++;
+		numBytes--;
+	}
+
+	return ~tail;
+}
+
+#else
+
+namespace
+{
+
+struct Crc32cTable
+{
+	u32 values[256];
+
+	Crc32cTable()
+	{
+		constexpr u32 Polynomial = 0x82F63B78; // reflected castagnoli
+		for (u32 i = 0; i < 256; ++i)
+		{
+			u32 value = i;
+			for (u32 bit = 0; bit < 8; ++bit)
+				value = (value >> 1) ^ ((value & 1) ? Polynomial : 0);
+			values[i] = value;
+		}
+	}
+};
+
+}
+
+u32 crc32c(const void* data, usize numBytes, u32 crc)
+{
+	static const Crc32cTable table;
+
+	const u8* it = static_cast<const u8*>(data);
+	u32 value = ~crc;
+
+	while (numBytes > 0)
+	{
+		value = table.values[(value ^ *it) & 0xFF] ^ (value >> 8);
+		it++;
+		numBytes--;
+	}
+
+	return ~value;
+}
+
+#endif
+
+}
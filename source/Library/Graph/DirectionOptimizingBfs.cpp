@@ -0,0 +1,165 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Graph/DirectionOptimizingBfs.h>
+
+#include <Library/BitUtils/AtomicBitWord.h>
+#include <Library/BitUtils/BitSpan.h>
+#include "BitUtils/ParallelRanges.h"
+
+#include <utility>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+DirectionOptimizingBfs::DirectionOptimizingBfs(const CsrGraph& outgoing, const CsrGraph& incoming, const BfsOptions& options)
+	: _outgoing(outgoing)
+	, _incoming(incoming)
+	, _options(options)
+	, _frontier(BitBuffer::NoInit, outgoing.numNodes)
+	, _next(BitBuffer::NoInit, outgoing.numNodes)
+	, _visited(BitBuffer::NoInit, outgoing.numNodes)
+{
+	DD_ASSERT(outgoing.numNodes == incoming.numNodes);
+	DD_ASSERT(outgoing.numEdges() == incoming.numEdges());
+	DD_ASSERT(options.alpha > 0 && options.beta > 0);
+}
+
+u32 DirectionOptimizingBfs::run(u32 source, u32* depths)
+{
+	const u32 numNodes = _outgoing.numNodes;
+	DD_ASSERT(source < numNodes);
+
+	for (u32 i = 0; i < numNodes; ++i)
+		depths[i] = Unreached;
+
+	_frontier.span().clearAll();
+	_visited.span().clearAll();
+	_frontier.span().setBit(source);
+	_visited.span().setBit(source);
+	depths[source] = 0;
+
+	_numTopDownSteps = 0;
+	_numBottomUpSteps = 0;
+
+	u32 numReached = 1;
+	u32 frontierSize = 1;
+	u64 frontierEdges = _outgoing.degree(source);
+	u64 unexploredEdges = _outgoing.numEdges() - frontierEdges;
+	bool bottomUp = false;
+
+	for (u32 depth = 1; frontierSize != 0; ++depth)
+	{
+		_next.span().clearAll();
+		const StepResult result = bottomUp ? bottomUpStep(depth, depths) : topDownStep(depth, depths);
+
+		std::swap(_frontier, _next);
+		const u32 nextSize = _frontier.span().countSetBits();
+		frontierEdges = result.numEdges;
+		unexploredEdges -= frontierEdges < unexploredEdges ? frontierEdges : unexploredEdges;
+
+		// direction for the next level, a growing frontier always stays bottom-up
+		if (!bottomUp)
+			bottomUp = frontierEdges > unexploredEdges / _options.alpha;
+		else
+			bottomUp = nextSize >= frontierSize || nextSize >= numNodes / _options.beta;
+
+		frontierSize = nextSize;
+		numReached += frontierSize;
+	}
+
+	return numReached;
+}
+
+DirectionOptimizingBfs::StepResult DirectionOptimizingBfs::topDownStep(u32 depth, u32* depths)
+{
+	_numTopDownSteps++;
+
+	const u32 numWords = bitword::getNumWordsRequired(_outgoing.numNodes);
+	const u32 numRanges = parallel::getNumRanges(numWords, _options.minWordsPerThread, _options.numThreads);
+	std::vector<u64> edgesPerRange(numRanges, 0);
+
+	const BitWordType* frontier = _frontier.data();
+	BitWordType* next = _next.data();
+	BitWordType* visited = _visited.data();
+
+	// any frontier node may reach any node, claims go through atomics and only the winner writes the depth
+	parallel::foreachRange(numWords, _options.minWordsPerThread, _options.numThreads, [&](u32 rangeIndex, u32 begin, u32 end) {
+		u64 numEdges = 0;
+
+		for (u32 wordIndex = begin; wordIndex < end; ++wordIndex)
+		{
+			bitword::foreachOne([&](u32 node) {
+				for (u32 edge = _outgoing.offsets[node]; edge < _outgoing.offsets[node + 1]; ++edge)
+				{
+					const u32 target = _outgoing.targets[edge];
+					if (bitword::atomicGetBit(visited, target) || !bitword::atomicSetBit(visited, target))
+						continue;
+
+					bitword::atomicSetBit(next, target);
+					depths[target] = depth;
+					numEdges += _outgoing.degree(target);
+				}
+			}, frontier[wordIndex], wordIndex * NumBitsInWord);
+		}
+
+		edgesPerRange[rangeIndex] = numEdges;
+	});
+
+	StepResult result;
+	for (u64 numEdges : edgesPerRange)
+		result.numEdges += numEdges;
+	return result;
+}
+
+DirectionOptimizingBfs::StepResult DirectionOptimizingBfs::bottomUpStep(u32 depth, u32* depths)
+{
+	_numBottomUpSteps++;
+
+	const u32 numNodes = _incoming.numNodes;
+	const u32 numWords = bitword::getNumWordsRequired(numNodes);
+	const u32 numRanges = parallel::getNumRanges(numWords, _options.minWordsPerThread, _options.numThreads);
+	std::vector<u64> edgesPerRange(numRanges, 0);
+
+	const ConstBitSpan frontier = _frontier.constSpan();
+	BitWordType* next = _next.data();
+	BitWordType* visited = _visited.data();
+	const BitWordType danglingMask = bitword::hasDanglingPart(numNodes) ? bitword::getDanglingPart(numNodes) : bitword::Ones;
+
+	// every thread owns whole words of next and visited, so no atomics are needed
+	parallel::foreachRange(numWords, _options.minWordsPerThread, _options.numThreads, [&](u32 rangeIndex, u32 begin, u32 end) {
+		u64 numEdges = 0;
+
+		for (u32 wordIndex = begin; wordIndex < end; ++wordIndex)
+		{
+			BitWordType unvisited = ~visited[wordIndex];
+			if (wordIndex == numWords - 1)
+				unvisited &= danglingMask;
+
+			BitWordType found = bitword::Zero;
+			bitword::foreachOne([&](u32 node) {
+				for (u32 edge = _incoming.offsets[node]; edge < _incoming.offsets[node + 1]; ++edge)
+				{
+					if (!frontier.getBit(_incoming.targets[edge]))
+						continue;
+
+					bitword::setBit(found, node % NumBitsInWord);
+					depths[node] = depth;
+					numEdges += _outgoing.degree(node);
+					break;
+				}
+			}, unvisited, wordIndex * NumBitsInWord);
+
+			next[wordIndex] = found;
+			visited[wordIndex] |= found;
+		}
+
+		edgesPerRange[rangeIndex] = numEdges;
+	});
+
+	StepResult result;
+	for (u64 numEdges : edgesPerRange)
+		result.numEdges += numEdges;
+	return result;
+}
+
+}
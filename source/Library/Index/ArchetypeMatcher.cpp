@@ -0,0 +1,115 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/ArchetypeMatcher.h>
+
+#include "BitUtils/RowMatch.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace ddahlkvist
+{
+
+ArchetypeMatcher::ArchetypeMatcher(u32 numComponents)
+	: _numComponents(numComponents)
+	, _wordsPerSignature(bitword::getNumWordsRequired(numComponents))
+{
+}
+
+u32 ArchetypeMatcher::addArchetype(const ConstBitSpan& signature)
+{
+	DD_ASSERT(signature.numBits() == _numComponents);
+
+	signature.foreachWord([this](BitWordType word) { _signatures.push_back(word); });
+	return _numArchetypes++;
+}
+
+u32 ArchetypeMatcher::addArchetype(const u32* components, u32 numComponents)
+{
+	const usize first = _signatures.size();
+	_signatures.resize(first + _wordsPerSignature, bitword::Zero);
+
+	for (u32 i = 0; i < numComponents; ++i)
+	{
+		DD_ASSERT(components[i] < _numComponents);
+		bitword::setBit(_signatures[first + components[i] / NumBitsInWord], components[i] % NumBitsInWord);
+	}
+	return _numArchetypes++;
+}
+
+void ArchetypeMatcher::compile(const ArchetypeQuery& query, BitWordType* masks) const
+{
+	BitWordType* require = masks;
+	BitWordType* any = masks + _wordsPerSignature;
+	BitWordType* exclude = masks + 2 * _wordsPerSignature;
+
+	for (u32 i = 0; i < 3 * _wordsPerSignature; ++i)
+		masks[i] = bitword::Zero;
+
+	auto set = [](BitWordType* mask, u32 component) { bitword::setBit(mask[component / NumBitsInWord], component % NumBitsInWord); };
+	for (u32 component : query.all)
+	{
+		DD_ASSERT(component < _numComponents);
+		set(require, component);
+	}
+	for (u32 component : query.any)
+	{
+		DD_ASSERT(component < _numComponents);
+		set(any, component);
+	}
+	for (u32 component : query.none)
+	{
+		DD_ASSERT(component < _numComponents);
+		set(exclude, component);
+	}
+}
+
+template<typename Sink>
+void ArchetypeMatcher::evaluateRange(const BitWordType* masks, bool hasAny, u32 begin, u32 end, Sink&& sink) const
+{
+	// a word of results at a time, the one word signature case runs several signatures per vector instruction
+	for (u32 archetype = begin; archetype < end; archetype += NumBitsInWord)
+	{
+		const u32 numRows = std::min(NumBitsInWord, end - archetype);
+		const BitWordType* signatures = _signatures.data() + static_cast<usize>(archetype) * _wordsPerSignature;
+		bitword::foreachOne(sink, rowmatch::matchRows(signatures, numRows, _wordsPerSignature, masks, hasAny), archetype);
+	}
+}
+
+ArchetypeMatcher::QueryId ArchetypeMatcher::addQuery(const ArchetypeQuery& query)
+{
+	Query compiled;
+	compiled.firstMaskWord = static_cast<u32>(_queryMasks.size());
+	compiled.hasAny = !query.any.empty();
+
+	_queryMasks.resize(_queryMasks.size() + 3 * _wordsPerSignature);
+	compile(query, _queryMasks.data() + compiled.firstMaskWord);
+
+	_queries.push_back(std::move(compiled));
+	return static_cast<QueryId>(_queries.size() - 1);
+}
+
+const std::vector<u32>& ArchetypeMatcher::matches(QueryId id)
+{
+	DD_ASSERT(id < _queries.size());
+
+	Query& query = _queries[id];
+	if (query.numEvaluated != _numArchetypes)
+	{
+		std::vector<u32>& out = query.matches;
+		evaluateRange(_queryMasks.data() + query.firstMaskWord, query.hasAny, query.numEvaluated, _numArchetypes, [&out](u32 archetype) { out.push_back(archetype); });
+		query.numEvaluated = _numArchetypes;
+	}
+	return query.matches;
+}
+
+u32 ArchetypeMatcher::evaluate(const ArchetypeQuery& query, u32* archetypes) const
+{
+	std::vector<BitWordType> masks(3 * _wordsPerSignature);
+	compile(query, masks.data());
+
+	u32 numMatches = 0;
+	evaluateRange(masks.data(), !query.any.empty(), 0, _numArchetypes, [archetypes, &numMatches](u32 archetype) { archetypes[numMatches++] = archetype; });
+	return numMatches;
+}
+
+}
@@ -0,0 +1,197 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/BitSlicedIndex.h>
+
+#include <Library/BitUtils/BitBuffer.h>
+
+namespace ddahlkvist
+{
+
+BitSlicedIndex::BitSlicedIndex(u32 numSlices, std::pmr::memory_resource* resource)
+	: _resource(resource)
+{
+	DD_ASSERT(numSlices > 0 && numSlices <= 64);
+
+	_slices.reserve(numSlices);
+	for (u32 i = 0; i < numSlices; ++i)
+		_slices.emplace_back(resource);
+}
+
+void BitSlicedIndex::append(u64 value)
+{
+	append(&value, 1);
+}
+
+void BitSlicedIndex::append(const u64* values, u32 numValues)
+{
+	const u32 numRows = _numRows + numValues;
+
+	for (BitVector& slice : _slices)
+		slice.resize(numRows);
+
+	for (u32 i = 0; i < numValues; ++i)
+	{
+		const u64 value = values[i];
+		DD_ASSERT(numSlices() == 64 || value >> numSlices() == 0);
+
+		bitword::foreachOne([this, row = _numRows + i](u32 bit) { _slices[bit].setBit(row); }, value);
+	}
+
+	_numRows = numRows;
+}
+
+u64 BitSlicedIndex::getValue(u32 row) const
+{
+	u64 value = 0;
+	for (u32 i = 0; i < numSlices(); ++i)
+		value |= static_cast<u64>(_slices[i].getBit(row)) << i;
+	return value;
+}
+
+void BitSlicedIndex::compare(Compare op, u64 constant, BitSpan& result) const
+{
+	DD_ASSERT(result.numBits() == _numRows);
+
+	const u32 numSlices = this->numSlices();
+	const u32 numWords = bitword::getNumWordsRequired(_numRows);
+	BitWordType* out = result.data();
+
+	// constants outside the value range compare the same against every row
+	const bool constantTooLarge = numSlices < 64 && constant >> numSlices != 0;
+
+	for (u32 word = 0; word < numWords; ++word)
+	{
+		BitWordType equal = bitword::Ones;
+		BitWordType greater = bitword::Zero;
+		BitWordType less = bitword::Zero;
+
+		if (constantTooLarge)
+		{
+			equal = bitword::Zero;
+			less = bitword::Ones;
+		}
+		else
+		{
+			for (u32 i = numSlices; i-- > 0;)
+			{
+				const BitWordType slice = _slices[i].data()[word];
+				if ((constant >> i) & 1)
+				{
+					less |= equal & ~slice;
+					equal &= slice;
+				}
+				else
+				{
+					greater |= equal & slice;
+					equal &= ~slice;
+				}
+			}
+		}
+
+		switch (op)
+		{
+		case Compare::Less: out[word] = less; break;
+		case Compare::LessOrEqual: out[word] = less | equal; break;
+		case Compare::Equal: out[word] = equal; break;
+		case Compare::NotEqual: out[word] = ~equal; break;
+		case Compare::GreaterOrEqual: out[word] = greater | equal; break;
+		case Compare::Greater: out[word] = greater; break;
+		}
+	}
+
+	result.clearDanglingBits();
+}
+
+u64 BitSlicedIndex::sum() const
+{
+	u64 total = 0;
+	for (u32 i = 0; i < numSlices(); ++i)
+		total += static_cast<u64>(_slices[i].constSpan().countSetBits()) << i;
+	return total;
+}
+
+u64 BitSlicedIndex::sum(const ConstBitSpan& filter) const
+{
+	DD_ASSERT(filter.numBits() == _numRows);
+
+	const u32 numWords = bitword::getNumWordsRequired(_numRows);
+	const BitWordType* filterWords = filter.data();
+
+	u64 total = 0;
+	for (u32 i = 0; i < numSlices(); ++i)
+	{
+		// slice bits beyond numRows are zero so the unmasked last filter word is fine
+		const BitWordType* slice = _slices[i].data();
+		u64 counter = 0;
+		for (u32 word = 0; word < numWords; ++word)
+			counter += bitword::countSetBits(slice[word] & filterWords[word]);
+
+		total += counter << i;
+	}
+	return total;
+}
+
+void BitSlicedIndex::topK(u32 k, BitSpan& result) const
+{
+	BitBuffer all(BitBuffer::OneInit, _numRows, _resource);
+	topK(k, all.constSpan(), result);
+}
+
+void BitSlicedIndex::topK(u32 k, const ConstBitSpan& filter, BitSpan& result) const
+{
+	DD_ASSERT(filter.numBits() == _numRows);
+	DD_ASSERT(result.numBits() == _numRows);
+
+	// result doubles as the set of rows that are surely in the top k
+	BitBuffer candidateBuffer(BitBuffer::NoInit, _numRows, _resource);
+	BitBuffer mergedBuffer(BitBuffer::NoInit, _numRows, _resource);
+	BitSpan candidates = candidateBuffer.span();
+	BitSpan merged = mergedBuffer.span();
+
+	result.clearAll();
+	candidates.assign(filter);
+
+	if (candidates.countSetBits() <= k)
+	{
+		result.assign(filter);
+		return;
+	}
+
+	u32 numSure = 0;
+	for (u32 i = numSlices(); i-- > 0 && numSure < k;)
+	{
+		const ConstBitSpan slice = _slices[i].constSpan();
+
+		// merged = candidates & slice, the candidates having the bit
+		merged.assign(candidates.asConst());
+		merged &= slice;
+		const u32 numWithBit = merged.countSetBits();
+
+		if (numSure + numWithBit > k)
+		{
+			// too many candidates have the bit, the ones without it can not be in the top k
+			candidates &= slice;
+		}
+		else
+		{
+			// all candidates with the bit are in, keep looking among the ones without it
+			result |= merged.asConst();
+			numSure += numWithBit;
+			candidates ^= merged.asConst();
+		}
+	}
+
+	// remaining candidates have equal values, take the lowest rows until k rows are selected
+	u32 numMissing = k - numSure;
+	BitWordType* out = result.data();
+	candidates.foreachWord([&out, &numMissing](BitWordType word) {
+		while (word != 0 && numMissing > 0)
+		{
+			*out |= word & (~word + 1);
+			word &= word - 1;
+			numMissing--;
+		}
+		out++;
+	});
+}
+
+}
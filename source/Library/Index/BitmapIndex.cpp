@@ -0,0 +1,131 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/BitmapIndex.h>
+
+namespace ddahlkvist
+{
+
+BitmapIndex::BitmapIndex(u32 cardinality, Encoding encoding, std::pmr::memory_resource* resource)
+	: _cardinality(cardinality)
+	, _encoding(encoding)
+{
+	DD_ASSERT(cardinality > 0);
+
+	const u32 numBitmaps = encoding == Encoding::Equality ? cardinality : cardinality - 1;
+	_bitmaps.reserve(numBitmaps);
+	for (u32 i = 0; i < numBitmaps; ++i)
+		_bitmaps.emplace_back(resource);
+}
+
+void BitmapIndex::append(u32 value)
+{
+	append(&value, 1);
+}
+
+void BitmapIndex::append(const u32* values, u32 numValues)
+{
+	const u32 numRows = _numRows + numValues;
+
+	// new bits are zero after resize, only ones have to be written
+	for (BitVector& bitmap : _bitmaps)
+		bitmap.resize(numRows);
+
+	for (u32 i = 0; i < numValues; ++i)
+	{
+		const u32 value = values[i];
+		DD_ASSERT(value < _cardinality);
+
+		if (_encoding == Encoding::Equality)
+		{
+			_bitmaps[value].setBit(_numRows + i);
+			continue;
+		}
+
+		for (u32 bitmap = value; bitmap < numBitmaps(); ++bitmap)
+			_bitmaps[bitmap].setBit(_numRows + i);
+	}
+
+	_numRows = numRows;
+}
+
+void BitmapIndex::copyBitmap(u32 index, BitSpan& result) const
+{
+	result.assign(_bitmaps[index].constSpan());
+}
+
+void BitmapIndex::orBitmaps(u32 first, u32 last, BitSpan& result) const
+{
+	result.clearAll();
+	for (u32 i = first; i < last; ++i)
+		result |= _bitmaps[i].constSpan();
+}
+
+void BitmapIndex::xorBitmap(u32 index, BitSpan& result) const
+{
+	result ^= _bitmaps[index].constSpan();
+}
+
+void BitmapIndex::equals(u32 value, BitSpan& result) const
+{
+	between(value, value, result);
+}
+
+void BitmapIndex::lessOrEqual(u32 value, BitSpan& result) const
+{
+	between(0, value, result);
+}
+
+void BitmapIndex::greaterOrEqual(u32 value, BitSpan& result) const
+{
+	between(value, _cardinality - 1, result);
+}
+
+void BitmapIndex::between(u32 low, u32 high, BitSpan& result) const
+{
+	DD_ASSERT(result.numBits() == _numRows);
+
+	if (high >= _cardinality)
+		high = _cardinality - 1;
+
+	if (low > high)
+	{
+		result.clearAll();
+		return;
+	}
+
+	if (_encoding == Encoding::Range)
+	{
+		// rows <= high minus rows <= low - 1, the second set is contained in the first so xor removes it
+		if (high == _cardinality - 1)
+			result.setAll();
+		else
+			copyBitmap(high, result);
+
+		if (low > 0)
+			xorBitmap(low - 1, result);
+		return;
+	}
+
+	// every row has exactly one value, so when most values are in range the complement is cheaper
+	const u32 numInside = high - low + 1;
+	const u32 numOutside = _cardinality - numInside;
+
+	if (numInside == 1)
+	{
+		copyBitmap(low, result);
+	}
+	else if (numInside <= numOutside)
+	{
+		orBitmaps(low, high + 1, result);
+	}
+	else
+	{
+		orBitmaps(0, low, result);
+		for (u32 i = high + 1; i < _cardinality; ++i)
+			result |= _bitmaps[i].constSpan();
+
+		result.foreachWord([](BitWordType& word) { word = ~word; });
+		result.clearDanglingBits();
+	}
+}
+
+}
@@ -0,0 +1,308 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Index/InvertedIndex.h>
+
+#include <algorithm>
+
+namespace ddahlkvist
+{
+
+namespace
+{
+
+// words per block of the fused kernel, operands and accumulator of a block stay in L1
+constexpr u32 BlockWords = 256;
+
+}
+
+struct InvertedIndex::Operand
+{
+	const Posting* posting;
+	const BitWordType* words; // dense words, materialized for sparse postings in the fused kernel
+};
+
+struct InvertedIndex::Plan
+{
+	std::vector<Operand> all; // ascending cardinality
+	std::vector<std::vector<Operand>> any; // ascending estimated cardinality
+	std::vector<Operand> none; // descending cardinality, the largest removes the most
+	std::vector<BitBuffer> materialized;
+	bool empty = false;
+	bool probe = false;
+};
+
+InvertedIndex::InvertedIndex(u32 numItems, u32 numTags, std::pmr::memory_resource* resource)
+	: _resource(resource)
+	, _numItems(numItems)
+{
+	_postings.reserve(numTags);
+	for (u32 i = 0; i < numTags; ++i)
+		_postings.push_back(Posting{ BitBuffer(BitBuffer::NoInit, 0, resource), {}, 0 });
+}
+
+void InvertedIndex::setTag(u32 tag, const u32* sortedItems, u32 numItems)
+{
+	Posting& posting = _postings[tag];
+	posting.cardinality = numItems;
+
+	// a sorted list costs 32 bits per item, the bitmap one bit per item of the index
+	if (static_cast<u64>(numItems) * 32 < _numItems)
+	{
+		posting.dense = BitBuffer(BitBuffer::NoInit, 0, _resource);
+		posting.sparse.assign(sortedItems, sortedItems + numItems);
+		return;
+	}
+
+	posting.sparse.clear();
+	posting.sparse.shrink_to_fit();
+	posting.dense = BitBuffer(BitBuffer::ZeroInit, _numItems, _resource);
+	BitSpan bits = posting.dense.span();
+	for (u32 i = 0; i < numItems; ++i)
+		bits.setBit(sortedItems[i]);
+}
+
+void InvertedIndex::setTag(u32 tag, const ConstBitSpan& items)
+{
+	DD_ASSERT(items.numBits() == _numItems);
+
+	std::vector<u32> sortedItems;
+	sortedItems.reserve(items.countSetBits());
+	items.foreachSetBit([&sortedItems](u32 item) { sortedItems.push_back(item); });
+	setTag(tag, sortedItems.data(), static_cast<u32>(sortedItems.size()));
+}
+
+InvertedIndex::Plan InvertedIndex::makePlan(const TagQuery& query) const
+{
+	Plan plan;
+
+	auto toOperand = [this](u32 tag) { return Operand{ &_postings[tag], _postings[tag].dense.data() }; };
+	auto byCardinality = [](const Operand& a, const Operand& b) { return a.posting->cardinality < b.posting->cardinality; };
+	auto estimate = [this](const std::vector<Operand>& group) {
+		u64 sum = 0;
+		for (const Operand& operand : group)
+			sum += operand.posting->cardinality;
+		return std::min<u64>(sum, _numItems);
+	};
+
+	for (u32 tag : query.all)
+		plan.all.push_back(toOperand(tag));
+	std::sort(plan.all.begin(), plan.all.end(), byCardinality);
+
+	for (const std::vector<u32>& tags : query.any)
+	{
+		std::vector<Operand> group;
+		for (u32 tag : tags)
+			group.push_back(toOperand(tag));
+		std::sort(group.begin(), group.end(), byCardinality);
+		plan.any.push_back(std::move(group));
+	}
+	std::sort(plan.any.begin(), plan.any.end(), [&estimate](const auto& a, const auto& b) { return estimate(a) < estimate(b); });
+
+	for (u32 tag : query.none)
+		plan.none.push_back(toOperand(tag));
+	std::sort(plan.none.begin(), plan.none.end(), [&byCardinality](const Operand& a, const Operand& b) { return byCardinality(b, a); });
+
+	// known to be empty without touching any item
+	plan.empty = _numItems == 0 || (!plan.all.empty() && plan.all.front().posting->cardinality == 0);
+	for (const std::vector<Operand>& group : plan.any)
+		plan.empty = plan.empty || estimate(group) == 0;
+
+	if (plan.empty)
+		return plan;
+
+	plan.probe = !plan.all.empty() && plan.all.front().words == nullptr;
+	if (plan.probe)
+		return plan;
+
+	// fused kernel reads words of every operand, sparse ones are scattered into a temporary bitmap once
+	auto materialize = [this, &plan](Operand& operand) {
+		if (operand.words != nullptr)
+			return;
+
+		BitBuffer& buffer = plan.materialized.emplace_back(BitBuffer::ZeroInit, _numItems, _resource);
+		BitSpan bits = buffer.span();
+		for (u32 item : operand.posting->sparse)
+			bits.setBit(item);
+		operand.words = buffer.data();
+	};
+
+	for (Operand& operand : plan.all)
+		materialize(operand);
+	for (std::vector<Operand>& group : plan.any)
+		for (Operand& operand : group)
+			materialize(operand);
+	for (Operand& operand : plan.none)
+		materialize(operand);
+
+	return plan;
+}
+
+template<typename ItemSink, typename WordSink>
+void InvertedIndex::execute(const Plan& plan, ItemSink&& itemSink, WordSink&& wordSink) const
+{
+	if (plan.empty)
+		return;
+
+	if (plan.probe)
+	{
+		// items of the driving tag are ascending, so every sparse operand keeps a forward moving cursor
+		std::vector<u32> cursors(_postings.size(), 0);
+
+		auto contains = [&cursors, this](const Operand& operand, u32 item) {
+			if (operand.words != nullptr)
+				return bitword::getBit(operand.words[item / NumBitsInWord], item % NumBitsInWord);
+
+			const std::vector<u32>& items = operand.posting->sparse;
+			u32& cursor = cursors[operand.posting - _postings.data()];
+			cursor = static_cast<u32>(std::lower_bound(items.begin() + cursor, items.end(), item) - items.begin());
+			return cursor < items.size() && items[cursor] == item;
+		};
+
+		for (u32 item : plan.all.front().posting->sparse)
+		{
+			bool match = true;
+			for (usize i = 1; i < plan.all.size() && match; ++i)
+				match = contains(plan.all[i], item);
+
+			for (usize i = 0; i < plan.any.size() && match; ++i)
+			{
+				bool anyMatch = false;
+				for (usize j = 0; j < plan.any[i].size() && !anyMatch; ++j)
+					anyMatch = contains(plan.any[i][j], item);
+				match = anyMatch;
+			}
+
+			for (usize i = 0; i < plan.none.size() && match; ++i)
+				match = !contains(plan.none[i], item);
+
+			if (match && !itemSink(item))
+				return;
+		}
+		return;
+	}
+
+	const u32 numWords = bitword::getNumWordsRequired(_numItems);
+	const BitWordType danglingMask = bitword::hasDanglingPart(_numItems) ? bitword::getDanglingPart(_numItems) : bitword::Ones;
+	BitWordType accumulator[BlockWords];
+	BitWordType group[BlockWords];
+
+	auto orGroup = [&group](const std::vector<Operand>& operands, u32 firstWord, u32 count) {
+		std::fill(group, group + count, bitword::Zero);
+		for (const Operand& operand : operands)
+			for (u32 i = 0; i < count; ++i)
+				group[i] |= operand.words[firstWord + i];
+	};
+
+	for (u32 firstWord = 0; firstWord < numWords; firstWord += BlockWords)
+	{
+		const u32 count = std::min(BlockWords, numWords - firstWord);
+		usize firstAny = 0;
+
+		if (!plan.all.empty())
+		{
+			std::copy(plan.all.front().words + firstWord, plan.all.front().words + firstWord + count, accumulator);
+		}
+		else if (!plan.any.empty())
+		{
+			orGroup(plan.any.front(), firstWord, count);
+			std::copy(group, group + count, accumulator);
+			firstAny = 1;
+		}
+		else
+		{
+			std::fill(accumulator, accumulator + count, bitword::Ones);
+		}
+
+		if (firstWord + count == numWords)
+			accumulator[count - 1] &= danglingMask;
+
+		// every operand is applied to the whole block, a block that runs empty skips the remaining operands
+		auto applyAnd = [&accumulator, count](const BitWordType* words, bool invert) {
+			const BitWordType flip = invert ? bitword::Ones : bitword::Zero;
+			BitWordType any = bitword::Zero;
+			for (u32 i = 0; i < count; ++i)
+			{
+				accumulator[i] &= words[i] ^ flip;
+				any |= accumulator[i];
+			}
+			return any != bitword::Zero;
+		};
+
+		bool nonEmpty = true;
+		for (usize i = 1; i < plan.all.size() && nonEmpty; ++i)
+			nonEmpty = applyAnd(plan.all[i].words + firstWord, false);
+
+		for (usize i = firstAny; i < plan.any.size() && nonEmpty; ++i)
+		{
+			orGroup(plan.any[i], firstWord, count);
+			nonEmpty = applyAnd(group, false);
+		}
+
+		for (usize i = 0; i < plan.none.size() && nonEmpty; ++i)
+			nonEmpty = applyAnd(plan.none[i].words + firstWord, true);
+
+		if (!nonEmpty)
+			continue;
+
+		if (!wordSink(firstWord, static_cast<const BitWordType*>(accumulator), count))
+			return;
+	}
+}
+
+u32 InvertedIndex::evaluate(const TagQuery& query, BitSpan& result) const
+{
+	DD_ASSERT(result.numBits() == _numItems);
+
+	result.clearAll();
+	const Plan plan = makePlan(query);
+
+	u32 counter = 0;
+	BitWordType* out = result.data();
+
+	execute(plan,
+		[&counter, &result](u32 item) {
+			result.setBit(item);
+			counter++;
+			return true;
+		},
+		[&counter, out](u32 firstWord, const BitWordType* words, u32 numWords) {
+			for (u32 i = 0; i < numWords; ++i)
+			{
+				out[firstWord + i] = words[i];
+				counter += bitword::countSetBits(words[i]);
+			}
+			return true;
+		});
+
+	return counter;
+}
+
+u32 InvertedIndex::evaluate(const TagQuery& query, u32* items, u32 limit) const
+{
+	if (limit == 0)
+		return 0;
+
+	const Plan plan = makePlan(query);
+	u32 counter = 0;
+
+	execute(plan,
+		[&counter, items, limit](u32 item) {
+			items[counter++] = item;
+			return counter < limit;
+		},
+		[&counter, items, limit](u32 firstWord, const BitWordType* words, u32 numWords) {
+			for (u32 i = 0; i < numWords; ++i)
+			{
+				for (BitWordType word = words[i]; word != 0; word &= word - 1)
+				{
+					items[counter++] = (firstWord + i) * NumBitsInWord + bitword::getLowestSetBit(word);
+					if (counter == limit)
+						return false;
+				}
+			}
+			return true;
+		});
+
+	return counter;
+}
+
+}
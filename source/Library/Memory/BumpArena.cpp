@@ -0,0 +1,90 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Memory/BumpArena.h>
+
+#include <algorithm>
+
+namespace ddahlkvist
+{
+
+namespace
+{
+constexpr usize BlockAlignment = 64;
+
+inline usize alignUp(usize value, usize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+}
+
+BumpArena::BumpArena(usize blockSize, std::pmr::memory_resource* upstream)
+	: _upstream(upstream)
+	, _blockSize(alignUp(blockSize, BlockAlignment))
+{
+	DD_ASSERT(blockSize > 0);
+}
+
+BumpArena::~BumpArena()
+{
+	for (const Block& block : _blocks)
+		_upstream->deallocate(block.data, block.size, BlockAlignment);
+}
+
+void BumpArena::reset()
+{
+	_currentBlock = 0;
+	_offset = 0;
+	_bytesAllocated = 0;
+}
+
+bool BumpArena::tryAllocateFrom(usize blockIndex, usize numBytes, usize alignment, void*& result)
+{
+	const Block& block = _blocks[blockIndex];
+	const usize offset = blockIndex == _currentBlock ? _offset : 0;
+
+	// blocks are 64 byte aligned so aligning the offset aligns the address for alignment <= 64
+	const usize begin = alignUp(offset, alignment);
+	if (begin + numBytes > block.size)
+		return false;
+
+	result = block.data + begin;
+	_currentBlock = blockIndex;
+	_offset = begin + numBytes;
+	return true;
+}
+
+void* BumpArena::do_allocate(std::size_t numBytes, std::size_t alignment)
+{
+	DD_ASSERT(alignment <= BlockAlignment);
+	numBytes = std::max<usize>(numBytes, 1);
+
+	void* result = nullptr;
+	for (usize i = _currentBlock; i < _blocks.size(); ++i)
+	{
+		if (tryAllocateFrom(i, numBytes, alignment, result))
+		{
+			_bytesAllocated += numBytes;
+			return result;
+		}
+	}
+
+	// oversized requests get a dedicated block, it is kept and reused after reset like any other block
+	const usize size = std::max(_blockSize, alignUp(numBytes, BlockAlignment));
+	Block block = { static_cast<u8*>(_upstream->allocate(size, BlockAlignment)), size };
+	_blocks.push_back(block);
+	_capacity += size;
+
+	tryAllocateFrom(_blocks.size() - 1, numBytes, alignment, result);
+	_bytesAllocated += numBytes;
+	return result;
+}
+
+void BumpArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+}
+
+bool BumpArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+}
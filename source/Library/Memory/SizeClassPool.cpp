@@ -0,0 +1,87 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Memory/SizeClassPool.h>
+
+namespace ddahlkvist
+{
+
+namespace
+{
+constexpr usize PoolAlignment = SizeClassPool::MinClassSize;
+}
+
+SizeClassPool::SizeClassPool(std::pmr::memory_resource* upstream)
+	: _upstream(upstream)
+{
+}
+
+SizeClassPool::~SizeClassPool()
+{
+	trim();
+}
+
+u32 SizeClassPool::getSizeClass(usize numBytes)
+{
+	u32 sizeClass = 0;
+	usize classSize = MinClassSize;
+	while (classSize < numBytes)
+	{
+		classSize <<= 1;
+		sizeClass++;
+	}
+	return sizeClass;
+}
+
+void SizeClassPool::trim()
+{
+	for (u32 i = 0; i < NumClasses; ++i)
+	{
+		const usize classSize = MinClassSize << i;
+		while (_freeLists[i] != nullptr)
+		{
+			FreeNode* node = _freeLists[i];
+			_freeLists[i] = node->next;
+			_upstream->deallocate(node, classSize, PoolAlignment);
+		}
+	}
+	_numPooled = 0;
+}
+
+void* SizeClassPool::do_allocate(std::size_t numBytes, std::size_t alignment)
+{
+	DD_ASSERT(alignment <= PoolAlignment);
+
+	if (numBytes > MaxPooledSize)
+		return _upstream->allocate(numBytes, PoolAlignment);
+
+	const u32 sizeClass = getSizeClass(numBytes);
+	if (FreeNode* node = _freeLists[sizeClass])
+	{
+		_freeLists[sizeClass] = node->next;
+		_numPooled--;
+		return node;
+	}
+
+	return _upstream->allocate(MinClassSize << sizeClass, PoolAlignment);
+}
+
+void SizeClassPool::do_deallocate(void* p, std::size_t numBytes, std::size_t)
+{
+	if (numBytes > MaxPooledSize)
+	{
+		_upstream->deallocate(p, numBytes, PoolAlignment);
+		return;
+	}
+
+	const u32 sizeClass = getSizeClass(numBytes);
+	FreeNode* node = static_cast<FreeNode*>(p);
+	node->next = _freeLists[sizeClass];
+	_freeLists[sizeClass] = node;
+	_numPooled++;
+}
+
+bool SizeClassPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+}
@@ -0,0 +1,77 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// atomic read-modify-write of single bits in plain BitWordType memory [ex the words of a BitBuffer]
+// lets several threads set bits in the same span without a separate atomic storage type,
+// all accesses to a word that is concurrently modified have to go through these functions
+// ordering is relaxed, publishing the result to other threads is left to the caller [ex thread join]
+
+namespace ddahlkvist
+{
+namespace bitword
+{
+
+inline BitWordType atomicLoad(const BitWordType* word)
+{
+#if defined(_MSC_VER)
+	return *static_cast<const volatile BitWordType*>(word);
+#else
+	return __atomic_load_n(word, __ATOMIC_RELAXED);
+#endif
+}
+
+inline void atomicStore(BitWordType* word, BitWordType value)
+{
+#if defined(_MSC_VER)
+	*static_cast<volatile BitWordType*>(word) = value;
+#else
+	__atomic_store_n(word, value, __ATOMIC_RELAXED);
+#endif
+}
+
+inline BitWordType atomicOr(BitWordType* word, BitWordType mask)
+{
+#if defined(_MSC_VER)
+	return static_cast<BitWordType>(_InterlockedOr64(reinterpret_cast<volatile long long*>(word), static_cast<long long>(mask)));
+#else
+	return __atomic_fetch_or(word, mask, __ATOMIC_RELAXED);
+#endif
+}
+
+inline BitWordType atomicAnd(BitWordType* word, BitWordType mask)
+{
+#if defined(_MSC_VER)
+	return static_cast<BitWordType>(_InterlockedAnd64(reinterpret_cast<volatile long long*>(word), static_cast<long long>(mask)));
+#else
+	return __atomic_fetch_and(word, mask, __ATOMIC_RELAXED);
+#endif
+}
+
+// returns true if this call changed the bit [it was clear before]
+inline bool atomicSetBit(BitWordType* words, u32 bit)
+{
+	const BitWordType mask = BitWordType{ 1 } << (bit % NumBitsInWord);
+	return (atomicOr(words + bit / NumBitsInWord, mask) & mask) == 0;
+}
+
+// returns true if this call changed the bit [it was set before]
+inline bool atomicClearBit(BitWordType* words, u32 bit)
+{
+	const BitWordType mask = BitWordType{ 1 } << (bit % NumBitsInWord);
+	return (atomicAnd(words + bit / NumBitsInWord, ~mask) & mask) != 0;
+}
+
+inline bool atomicGetBit(const BitWordType* words, u32 bit)
+{
+	return getBit(atomicLoad(words + bit / NumBitsInWord), bit % NumBitsInWord);
+}
+
+}
+}
@@ -0,0 +1,85 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+struct BitAccumulatorOptions
+{
+	u32 numThreads = 0; // threads used by merge, 0 uses every hardware thread
+	u32 blockWords = 64; // granularity of the dirty tracking, 64 words = 4096 bits
+	u32 maxSparseBits = 0; // set bits a local keeps as a list before it turns dense, 0 uses numBits / 256
+};
+
+// contention free parallel marking: every worker sets bits in its own Local instead of a shared mask,
+// merge then ORs all locals into a result with a parallel tree merge [pairs of locals per level, pairs run on separate threads]
+// a local starts as a list of set bits and turns into a dense buffer once the list grows past maxSparseBits
+// dense locals are never cleared as a whole, a block of words is zeroed when it is first written and remembered as dirty,
+// merging only touches dirty blocks so the cost follows the memory the workers touched and not numBits
+// merge allocates on the calling thread only, but workers turning dense allocate from resource concurrently,
+// so it has to be thread safe [not a BumpArena or SizeClassPool] when workers run in parallel
+class LIBRARY_PUBLIC BitAccumulator final
+{
+public:
+	class LIBRARY_PUBLIC Local final
+	{
+	public:
+		void setBit(u32 bit);
+
+		inline bool isDense() const { return _dense.numBits() != 0; }
+		inline u32 numDirtyBlocks() const { return static_cast<u32>(_dirtyBlocks.size()); }
+
+	private:
+		friend class BitAccumulator;
+
+		Local(u32 numBits, u32 blockWords, u32 maxSparseBits, std::pmr::memory_resource* resource);
+
+		inline bool isDirty(u32 block) const { return _dirtyMask.constSpan().getBit(block); }
+		BitWordType* touchBlock(u32 block); // zeroes a block on first use, returns its first word
+		void densify();
+		void mergeFrom(Local& other);
+		void clear();
+
+		BitBuffer _dense;
+		BitBuffer _dirtyMask; // one bit per block of the dense buffer
+		std::vector<u32> _dirtyBlocks;
+		std::vector<u32> _sparse; // may hold duplicates
+		std::pmr::memory_resource* _resource;
+		u32 _numBits;
+		u32 _numWords;
+		u32 _blockWords;
+		u32 _maxSparseBits;
+	};
+
+	explicit BitAccumulator(u32 numBits, u32 numWorkers, const BitAccumulatorOptions& options = {}, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	inline u32 numBits() const { return _numBits; }
+	inline u32 numWorkers() const { return static_cast<u32>(_locals.size()); }
+
+	// only used by one worker at a time
+	inline Local& local(u32 worker) { return _locals[worker]; }
+
+	// result |= every bit set in any local, result has numBits bits
+	// locals are empty afterwards and keep their storage for the next round
+	void merge(BitSpan& result);
+
+	void clear();
+
+private:
+	// locals that become dense during the merge tree are densified up front, the resource need not be thread safe
+	void densifyMergeTargets();
+
+	std::vector<Local> _locals;
+	BitAccumulatorOptions _options;
+	u32 _numBits;
+};
+
+}
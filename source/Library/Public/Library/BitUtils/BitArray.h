@@ -0,0 +1,179 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <initializer_list>
+#include <utility>
+
+namespace ddahlkvist
+{
+
+// fixed size range of bits with inline storage where the size is known at compile time
+// every word operation is expanded per word [no loops], dangling mask is a compile time constant
+// invariant: dangling bits are always zero, which makes comparisons a plain word compare
+// all operations except countSetBits are constexpr, can be viewed as a BitSpan/ConstBitSpan
+template<u32 NumBitsInArray>
+class BitArray final
+{
+public:
+	static constexpr u32 NumBits = NumBitsInArray;
+	static constexpr u32 NumWords = bitword::getNumWordsRequired(NumBits);
+	static constexpr BitWordType DanglingMask = bitword::hasDanglingPart(NumBits) ? bitword::getDanglingPart(NumBits) : bitword::Ones;
+
+	constexpr BitArray() : _words{} {}
+
+	constexpr BitArray(std::initializer_list<u32> bits) : _words{}
+	{
+		for (u32 bit : bits)
+			setBit(bit);
+	}
+
+	static constexpr BitArray ones()
+	{
+		BitArray result;
+		result.setAll();
+		return result;
+	}
+
+	constexpr void setBit(u32 bit)
+	{
+		DD_ASSERT(bit < NumBits);
+		bitword::setBit(_words[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+
+	constexpr void clearBit(u32 bit)
+	{
+		DD_ASSERT(bit < NumBits);
+		bitword::clearBit(_words[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+
+	constexpr bool getBit(u32 bit) const
+	{
+		DD_ASSERT(bit < NumBits);
+		return bitword::getBit(_words[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+
+	constexpr void clearAll()
+	{
+		foreachIndex([this](u32 i) { _words[i] = bitword::Zero; });
+	}
+
+	constexpr void setAll()
+	{
+		foreachIndex([this](u32 i) { _words[i] = bitword::Ones; });
+		clearDanglingBits();
+	}
+
+	constexpr bool any() const
+	{
+		BitWordType combined = bitword::Zero;
+		foreachIndex([this, &combined](u32 i) { combined |= _words[i]; });
+		return combined != bitword::Zero;
+	}
+
+	constexpr bool none() const { return !any(); }
+	constexpr bool all() const { return *this == ones(); }
+
+	inline u32 countSetBits() const
+	{
+		u64 counter = 0;
+		foreachIndex([this, &counter](u32 i) { counter += bitword::countSetBits(_words[i]); });
+		return static_cast<u32>(counter);
+	}
+
+	// true if every bit set in other is also set in this
+	constexpr bool containsAll(const BitArray& other) const
+	{
+		BitWordType missing = bitword::Zero;
+		foreachIndex([this, &other, &missing](u32 i) { missing |= other._words[i] & ~_words[i]; });
+		return missing == bitword::Zero;
+	}
+
+	constexpr bool intersects(const BitArray& other) const
+	{
+		BitWordType shared = bitword::Zero;
+		foreachIndex([this, &other, &shared](u32 i) { shared |= other._words[i] & _words[i]; });
+		return shared != bitword::Zero;
+	}
+
+	constexpr BitArray& operator|=(const BitArray& other)
+	{
+		foreachIndex([this, &other](u32 i) { _words[i] |= other._words[i]; });
+		return *this;
+	}
+
+	constexpr BitArray& operator&=(const BitArray& other)
+	{
+		foreachIndex([this, &other](u32 i) { _words[i] &= other._words[i]; });
+		return *this;
+	}
+
+	constexpr BitArray& operator^=(const BitArray& other)
+	{
+		foreachIndex([this, &other](u32 i) { _words[i] ^= other._words[i]; });
+		return *this;
+	}
+
+	constexpr BitArray operator~() const
+	{
+		BitArray result;
+		foreachIndex([this, &result](u32 i) { result._words[i] = ~_words[i]; });
+		result.clearDanglingBits();
+		return result;
+	}
+
+	constexpr BitArray operator|(const BitArray& other) const { BitArray result = *this; result |= other; return result; }
+	constexpr BitArray operator&(const BitArray& other) const { BitArray result = *this; result &= other; return result; }
+	constexpr BitArray operator^(const BitArray& other) const { BitArray result = *this; result ^= other; return result; }
+
+	constexpr bool operator==(const BitArray& other) const
+	{
+		BitWordType difference = bitword::Zero;
+		foreachIndex([this, &other, &difference](u32 i) { difference |= _words[i] ^ other._words[i]; });
+		return difference == bitword::Zero;
+	}
+
+	constexpr bool operator!=(const BitArray& other) const { return !(*this == other); }
+
+	template<typename BitAction>
+	inline void foreachSetBit(BitAction&& action) const
+	{
+		foreachIndex([this, &action](u32 i) { bitword::foreachOne(action, _words[i], i * NumBitsInWord); });
+	}
+
+	constexpr BitWordType getWord(u32 index) const { return _words[index]; }
+
+	inline BitWordType* data() { return _words; }
+	inline const BitWordType* data() const { return _words; }
+
+	// modifications through the span must leave the dangling bits cleared [BitSpan operations do]
+	inline BitSpan span() { return BitSpan(_words, NumBits); }
+	inline ConstBitSpan constSpan() const { return ConstBitSpan(_words, NumBits); }
+
+private:
+	template<typename IndexAction, std::size_t... Indices>
+	static constexpr void foreachIndexImpl(IndexAction& action, std::index_sequence<Indices...>)
+	{
+		(action(static_cast<u32>(Indices)), ...);
+	}
+
+	template<typename IndexAction>
+	static constexpr void foreachIndex(IndexAction&& action)
+	{
+		foreachIndexImpl(action, std::make_index_sequence<NumWords>{});
+	}
+
+	constexpr void clearDanglingBits()
+	{
+		if constexpr (NumWords > 0)
+			_words[NumWords - 1] &= DanglingMask;
+	}
+
+	BitWordType _words[NumWords > 0 ? NumWords : 1];
+};
+
+}
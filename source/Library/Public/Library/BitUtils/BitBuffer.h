@@ -3,44 +3,105 @@
 
 #include <Core/Platform.h>
 #include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
 #include <Library/BitUtils/BitWord.h>
-#include <memory>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <cstring>
+#include <memory_resource>
+#include <utility>
 
 namespace ddahlkvist
 {
 
-class BitBuffer final
+// owner of a range of bits, storage comes from a std::pmr::memory_resource [default resource unless provided]
+// storage is always cache line aligned, NoInit leaves the memory untouched
+template<typename Word>
+class BasicBitBuffer final
 {
 public:
 	enum NoInitType { NoInit };
 	enum ZeroInitType { ZeroInit };
 	enum OneInitType { OneInit };
 
-	explicit BitBuffer(NoInitType t, u32 numBits)
+	using WordType = Word;
+
+	static constexpr usize Alignment = alignof(Word) > 64 ? alignof(Word) : 64;
+
+	explicit BasicBitBuffer(NoInitType t, u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
 		: _numBits(numBits)
-		, _numWords(bitword::getNumWordsRequired(numBits))
-		, _data(std::make_unique<BitWordType[]>(_numWords))
+		, _numWords(bitword::getNumWordsRequired<Word>(numBits))
+		, _resource(resource)
+		, _data(_numWords > 0 ? static_cast<Word*>(resource->allocate(size(), Alignment)) : nullptr)
+	{
+	}
+
+	explicit BasicBitBuffer(ZeroInitType, u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: BasicBitBuffer(NoInitType{}, numBits, resource)
 	{
+		if (_numWords > 0)
+			memset(_data, 0, size());
 	}
 
-	explicit BitBuffer(ZeroInitType, u32 numBits) : BitBuffer(NoInitType{}, numBits) {
-		memset(_data.get(), bitword::Zero, bitword::getNumBytesRequiredToRepresentWordBasedBitBuffer(numBits));
+	explicit BasicBitBuffer(OneInitType, u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: BasicBitBuffer(NoInitType{}, numBits, resource)
+	{
+		if (_numWords > 0)
+			memset(_data, ~0, size());
 	}
 
-	explicit BitBuffer(OneInitType, u32 numBits) : BitBuffer(NoInitType{}, numBits) {
-		memset(_data.get(), ~0, bitword::getNumBytesRequiredToRepresentWordBasedBitBuffer(numBits));
+	~BasicBitBuffer()
+	{
+		release();
 	}
 
-	inline u32 size() const { return _numWords * sizeof(BitWordType); }
-	inline BitWordType* data() const { return _data.get(); }
+	BasicBitBuffer(const BasicBitBuffer&) = delete;
+	BasicBitBuffer& operator=(const BasicBitBuffer&) = delete;
 
-	BitWordType* begin() const { return data(); }
-	BitWordType* end() const { return data() + _numWords; }
+	BasicBitBuffer(BasicBitBuffer&& other) noexcept
+		: _numBits(std::exchange(other._numBits, 0))
+		, _numWords(std::exchange(other._numWords, 0))
+		, _resource(other._resource)
+		, _data(std::exchange(other._data, nullptr))
+	{
+	}
+
+	BasicBitBuffer& operator=(BasicBitBuffer&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			_numBits = std::exchange(other._numBits, 0);
+			_numWords = std::exchange(other._numWords, 0);
+			_resource = other._resource;
+			_data = std::exchange(other._data, nullptr);
+		}
+		return *this;
+	}
+
+	inline u32 size() const { return _numWords * sizeof(Word); }
+	inline u32 numBits() const { return _numBits; }
+	inline Word* data() const { return _data; }
+	inline std::pmr::memory_resource* resource() const { return _resource; }
+
+	Word* begin() const { return data(); }
+	Word* end() const { return data() + _numWords; }
+
+	inline BasicBitSpan<Word> span() const { return BasicBitSpan<Word>(_data, _numBits); }
+	inline BasicConstBitSpan<Word> constSpan() const { return BasicConstBitSpan<Word>(_data, _numBits); }
 
 private:
+	inline void release()
+	{
+		if (_data != nullptr)
+			_resource->deallocate(_data, size(), Alignment);
+	}
+
 	u32 _numBits;
 	u32 _numWords;
-	std::unique_ptr<BitWordType[]> _data;
+	std::pmr::memory_resource* _resource;
+	Word* _data;
 };
 
+using BitBuffer = BasicBitBuffer<BitWordType>;
+
 }
@@ -0,0 +1,37 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+struct BitCounterOptions
+{
+	u32 numThreads = 0; // 0 uses every hardware thread
+	u32 minWordsPerThread = 1024;
+};
+
+// per position counting across N equally sized bit ranges [ex "present in at least k of N daily masks"]
+// counters are bit sliced: plane p holds bit p of the 64 counters of a word, so one input word is added to 64 counters
+// with a handful of word ops [inputs are added in pairs through a carry-save adder, the carry ripples into the higher planes]
+// counters are kept for a block of words that stays in L1 while every input streams through it once, blocks are split across threads
+namespace bitcounter
+{
+
+constexpr u32 MaxNumInputs = 0xFFFF;
+
+// result[i] = bit i is set in at least k of the inputs, every input must have result.numBits() bits
+LIBRARY_PUBLIC void atLeast(const ConstBitSpan* inputs, u32 numInputs, u32 k, BitSpan& result, const BitCounterOptions& options = {});
+
+// atLeast that also writes counts[i] = number of inputs with bit i set, counts must hold result.numBits() entries
+LIBRARY_PUBLIC void atLeast(const ConstBitSpan* inputs, u32 numInputs, u32 k, BitSpan& result, u16* counts, const BitCounterOptions& options = {});
+
+// counts[i] = number of inputs with bit i set, counts must hold numBits entries
+LIBRARY_PUBLIC void countPerPosition(const ConstBitSpan* inputs, u32 numInputs, u32 numBits, u16* counts, const BitCounterOptions& options = {});
+
+}
+}
@@ -0,0 +1,107 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/MappedBitBuffer.h>
+#include <Library/library_module.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// one chunk of words from every file of a BitFileChunkReader, all files share firstBit/numBits
+// words are owned by the reader and are valid [and writable] until the next call to nextChunk
+struct BitFileChunk
+{
+	u32 chunkIndex;
+	u32 firstBit;
+	u32 numBits;
+	u32 numWords;
+
+	BitWordType* data; // words of file i start at data + i * stride
+	u32 stride;
+
+	inline BitWordType* words(u32 file) const { return data + file * stride; }
+};
+
+// reads one or more equally sized bitmap files [MappedBitBuffer format] front to back in fixed size chunks of words
+// a background thread reads chunk N+1 of all files while chunk N is being processed [double buffering]
+// chunks are plain word ranges so the same BitSpan kernels can be used on them as on in-memory bitmaps
+class LIBRARY_PUBLIC BitFileChunkReader final
+{
+public:
+	BitFileChunkReader() = default;
+	~BitFileChunkReader();
+
+	BitFileChunkReader(const BitFileChunkReader&) = delete;
+	BitFileChunkReader& operator=(const BitFileChunkReader&) = delete;
+
+	// fails if any file is missing/incompatible or the files differ in bit count
+	bool open(const char* const* paths, u32 numFiles, u32 wordsPerChunk);
+	void close();
+
+	inline u32 numBits() const { return _numBits; }
+	inline u32 numFiles() const { return static_cast<u32>(_files.size()); }
+	inline u32 numChunks() const { return _numChunks; }
+
+	// returns false when all chunks are consumed or when reading failed [see failed()]
+	bool nextChunk(BitFileChunk& chunk);
+	inline bool failed() const { return _failed; }
+
+private:
+	enum class SlotState { Free, Reading, Ready, InUse };
+
+	struct Slot
+	{
+		std::vector<BitWordType> words;
+		SlotState state = SlotState::Free;
+	};
+
+	void prefetchThread();
+
+	std::vector<int> _files;
+	u32 _numBits = 0;
+	u32 _wordsPerChunk = 0;
+	u32 _numChunks = 0;
+	u32 _nextChunk = 0;
+	bool _failed = false;
+	bool _stop = false;
+
+	Slot _slots[2];
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	std::thread _thread;
+};
+
+// writes a bitmap file [MappedBitBuffer format] front to back, words are appended in order
+// header [including checksum] is written last by finish, an unfinished file is never considered compatible
+class LIBRARY_PUBLIC BitFileChunkWriter final
+{
+public:
+	BitFileChunkWriter() = default;
+	~BitFileChunkWriter();
+
+	BitFileChunkWriter(const BitFileChunkWriter&) = delete;
+	BitFileChunkWriter& operator=(const BitFileChunkWriter&) = delete;
+
+	bool open(const char* path, u32 numBits);
+
+	// dangling bits of the last word are cleared in the file regardless of their value in words
+	bool append(const BitWordType* words, u32 numWords);
+
+	// fails if not all words were appended
+	bool finish();
+
+private:
+	int _file = -1;
+	u32 _numBits = 0;
+	u32 _numWordsWritten = 0;
+	BitFileChecksum _checksum;
+};
+
+}
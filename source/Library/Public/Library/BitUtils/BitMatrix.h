@@ -0,0 +1,95 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+
+namespace ddahlkvist
+{
+
+// in place transpose of a 64x64 bit block, block[row] bit col <-> block[col] bit row
+LIBRARY_PUBLIC void transposeBitBlock64(u64* block);
+
+// numRows x numCols bits stored row-major in one contiguous allocation
+// every row starts on a cache line [stride is padded to a multiple of 8 words], padding bits are always zero
+// rows are regular BitSpans so all span kernels work per row, column queries go through getColumn or a transposed copy
+class LIBRARY_PUBLIC BitMatrix final
+{
+public:
+	static constexpr usize Alignment = 64;
+	static constexpr u32 StrideAlignmentWords = Alignment / sizeof(BitWordType);
+
+	explicit BitMatrix(u32 numRows, u32 numCols, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	~BitMatrix();
+
+	BitMatrix(const BitMatrix&) = delete;
+	BitMatrix& operator=(const BitMatrix&) = delete;
+	BitMatrix(BitMatrix&& other) noexcept;
+	BitMatrix& operator=(BitMatrix&& other) noexcept;
+
+	inline u32 numRows() const { return _numRows; }
+	inline u32 numCols() const { return _numCols; }
+	inline u32 stride() const { return _stride; } // in words
+	inline BitWordType* data() const { return _data; }
+	inline std::pmr::memory_resource* resource() const { return _resource; }
+
+	inline BitWordType* rowData(u32 row) const
+	{
+		DD_ASSERT(row < _numRows);
+		return _data + static_cast<usize>(row) * _stride;
+	}
+
+	inline BitSpan row(u32 row) const { return BitSpan(rowData(row), _numCols); }
+	inline ConstBitSpan constRow(u32 row) const { return ConstBitSpan(rowData(row), _numCols); }
+
+	inline void setBit(u32 row, u32 col)
+	{
+		DD_ASSERT(col < _numCols);
+		bitword::setBit(rowData(row)[col / NumBitsInWord], col % NumBitsInWord);
+	}
+
+	inline void clearBit(u32 row, u32 col)
+	{
+		DD_ASSERT(col < _numCols);
+		bitword::clearBit(rowData(row)[col / NumBitsInWord], col % NumBitsInWord);
+	}
+
+	inline bool getBit(u32 row, u32 col) const
+	{
+		DD_ASSERT(col < _numCols);
+		return bitword::getBit(rowData(row)[col / NumBitsInWord], col % NumBitsInWord);
+	}
+
+	void clearAll();
+	u64 countSetBits() const;
+
+	// column as a bit range over rows, output has to hold numRows bits
+	void getColumn(u32 col, BitSpan& output) const;
+
+	// counts[col] = number of rows with bit col set, counts has to hold numCols entries
+	void countColumnBits(u32* counts) const;
+
+	// output has to be numCols x numRows, done in 64x64 blocks
+	void transposeInto(BitMatrix& output) const;
+	BitMatrix transposed() const;
+
+private:
+	inline usize numWords() const { return static_cast<usize>(_numRows) * _stride; }
+	void release();
+
+	// gathers block [rowBlock, colBlock] of 64x64 bits, rows outside the matrix are zero
+	void loadBlock(u32 rowBlock, u32 colBlock, u64* block) const;
+
+	BitWordType* _data = nullptr;
+	std::pmr::memory_resource* _resource;
+	u32 _numRows;
+	u32 _numCols;
+	u32 _stride;
+};
+
+}
@@ -0,0 +1,33 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitMatrix.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+struct BitMatrixMultiplyOptions
+{
+	u32 numThreads = 0; // 0 uses every hardware thread
+	u32 minRowsPerThread = 512; // each thread builds its own lookup tables, small row ranges do not pay for that
+	u32 colTileWords = 64; // output columns handled per pass, 256 table entries of this size should stay in L2
+};
+
+// boolean matrix algebra [and = multiply, or = add] on BitMatrix
+namespace bitmatrix
+{
+
+// output = a * b, output[i] = OR of b[j] for every bit j set in a[i]
+// a is n x k, b is k x m and output n x m [output must not alias a or b]
+// method of four russians: rows of b are grouped 8 at a time into 256 entry tables of OR-ed rows,
+// so each byte of a[i] costs one row accumulation instead of up to eight
+LIBRARY_PUBLIC void multiply(const BitMatrix& a, const BitMatrix& b, BitMatrix& output, const BitMatrixMultiplyOptions& options = {});
+
+// output[i] has bit j set if j is reachable from i through one or more edges of the square matrix adjacency
+// done by repeated squaring [R = R | R * R] until nothing changes, needs log2(longest path) multiplies
+LIBRARY_PUBLIC void transitiveClosure(const BitMatrix& adjacency, BitMatrix& output, const BitMatrixMultiplyOptions& options = {});
+
+}
+}
@@ -9,14 +9,17 @@ namespace ddahlkvist
 {
 
 // utility class for being able to perform actions on two different "range of bits"
-class BitRangeZipper final
+template<typename Word>
+class BasicBitRangeZipper final
 {
 public:
-	BitRangeZipper(BitWordType* __restrict lhs, BitWordType* __restrict rhs, u32 numBits)
+	using WordType = Word;
+
+	BasicBitRangeZipper(Word* __restrict lhs, Word* __restrict rhs, u32 numBits)
 		: _lhs(lhs)
 		, _rhs(rhs)
-		, _danglingMask(bitword::hasDanglingPart(numBits) ? bitword::getDanglingPart(numBits) : bitword::Ones)
-		, _numWords(bitword::getNumWordsRequired(numBits))
+		, _danglingMask(bitword::hasDanglingPart<Word>(numBits) ? bitword::getDanglingPart<Word>(numBits) : bitword::OnesOf<Word>)
+		, _numWords(bitword::getNumWordsRequired<Word>(numBits))
 		, _numBits(numBits)
 	{
 		DD_ASSERT(numBits < 400000000); // sanity check against "-1 issues"
@@ -26,7 +29,7 @@ public:
 
 	inline void clearDanglingBits()
 	{
-		if (_numWords > 0 && _danglingMask != 0) {
+		if (_numWords > 0 && _danglingMask != bitword::ZeroOf<Word>) {
 			_lhs[_numWords - 1] &= _danglingMask;
 			_rhs[_numWords - 1] &= _danglingMask;
 		}
@@ -50,12 +53,14 @@ public:
 	}
 
 private:
-	BitWordType* __restrict _lhs;
-	BitWordType* __restrict _rhs;
-	BitWordType _danglingMask;
+	Word* __restrict _lhs;
+	Word* __restrict _rhs;
+	Word _danglingMask;
 
 	u32 _numWords;
 	u32 _numBits;
 };
 
+using BitRangeZipper = BasicBitRangeZipper<BitWordType>;
+
 }
@@ -0,0 +1,33 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+enum class BitReduceOp { Or, And, Xor, Majority };
+
+struct BitReduceOptions
+{
+	u32 numThreads = 0; // 0 uses every hardware thread
+	u32 minWordsPerThread = 1024;
+	u32 tileWords = 512; // accumulator words reduced over all inputs before moving on, 4kb stays in L1
+};
+
+// reduction of many equally sized bit ranges into one [ex OR of 365 daily masks]
+// instead of one full pass per input the result is split into tiles and every input is folded into a tile before the next one,
+// so the accumulator is read and written once, inputs are combined four at a time and tiles are split across threads
+// And stops reading inputs for a tile once it is all zero
+// Majority sets the bits present in more than half of the inputs [bitcounter::atLeast]
+namespace bitreduce
+{
+
+// every input must have result.numBits() bits and none may alias result, no inputs gives all ones for And and all zeros otherwise
+LIBRARY_PUBLIC void reduce(BitReduceOp op, const ConstBitSpan* inputs, u32 numInputs, BitSpan& result, const BitReduceOptions& options = {});
+
+}
+}
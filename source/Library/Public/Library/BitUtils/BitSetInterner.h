@@ -0,0 +1,81 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// hash consing of bitsets of numBits bits: every distinct value is stored once and referred to by a 4 byte handle
+// [ex millions of objects sharing a few thousand permission masks]
+// equal values always get the same handle so equality is a handle compare, stored values are immutable and never move
+// binary operations between handles are memoized, repeating an operation on the same handles is a table lookup
+// values live in pages of PageSize sets allocated from the memory resource, not thread safe
+class LIBRARY_PUBLIC BitSetInterner final
+{
+public:
+	static constexpr usize Alignment = 64;
+	static constexpr u32 PageSize = 256; // sets per page
+
+	struct Handle
+	{
+		u32 index;
+
+		inline bool operator==(Handle other) const { return index == other.index; }
+		inline bool operator!=(Handle other) const { return index != other.index; }
+	};
+
+	explicit BitSetInterner(u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	~BitSetInterner();
+
+	BitSetInterner(const BitSetInterner&) = delete;
+	BitSetInterner& operator=(const BitSetInterner&) = delete;
+
+	inline u32 numBits() const { return _numBits; }
+	inline u32 size() const { return _numSets; }
+
+	// bits has numBits bits, returns the handle of the stored copy [stored on first use]
+	Handle intern(const ConstBitSpan& bits);
+
+	// stays valid for the lifetime of the interner
+	inline ConstBitSpan get(Handle handle) const { return ConstBitSpan(setData(handle.index), _numBits); }
+
+	// memoized, the result is interned
+	Handle intersect(Handle a, Handle b);
+	Handle unite(Handle a, Handle b);
+	Handle subtract(Handle a, Handle b); // a & ~b
+
+	inline u32 numMemoized() const { return static_cast<u32>(_memo.size()); }
+
+private:
+	enum class Op : u32 { Intersect, Unite, Subtract };
+
+	inline BitWordType* setData(u32 index) const
+	{
+		DD_ASSERT(index < _numSets);
+		return _pages[index / PageSize] + static_cast<usize>(index % PageSize) * _wordsPerSet;
+	}
+
+	Handle apply(Op op, Handle a, Handle b);
+	Handle internWords(const BitWordType* words, u64 hash);
+	void growTable();
+
+	std::pmr::memory_resource* _resource;
+	std::vector<BitWordType*> _pages;
+	std::vector<u64> _hashes; // per set, checked before comparing words
+	std::vector<u32> _table; // open addressing, set index + 1 and 0 for empty slots
+	std::unordered_map<u64, u32> _memo; // [op, a, b] -> result index
+	std::vector<BitWordType> _scratch;
+	u32 _numBits;
+	u32 _wordsPerSet;
+	u32 _numSets = 0;
+};
+
+}
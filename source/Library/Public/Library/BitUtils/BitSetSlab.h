@@ -0,0 +1,142 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+
+namespace ddahlkvist
+{
+
+// numRows equally sized bitsets of numBitsPerRow bits in one contiguous allocation [ex one component mask per entity]
+// RowMajor stores each row as its words back to back without padding, rows are regular BitSpans
+// Transposed stores one plane per bit position, plane b is a bit range over rows [bit b of every row], rows are only reachable bit by bit
+// batched kernels evaluate a query against every row and produce one result bit per row [or the matching row indices],
+// row-major slabs of one word per row are compared several rows per vector instruction, transposed slabs only read the planes of the query bits
+// bits beyond numBitsPerRow [row-major] and beyond numRows [transposed] are always zero
+class LIBRARY_PUBLIC BitSetSlab final
+{
+public:
+	enum class Layout { RowMajor, Transposed };
+
+	static constexpr usize Alignment = 64;
+
+	explicit BitSetSlab(u32 numRows, u32 numBitsPerRow, Layout layout = Layout::RowMajor, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	~BitSetSlab();
+
+	BitSetSlab(const BitSetSlab&) = delete;
+	BitSetSlab& operator=(const BitSetSlab&) = delete;
+	BitSetSlab(BitSetSlab&& other) noexcept;
+	BitSetSlab& operator=(BitSetSlab&& other) noexcept;
+
+	inline u32 numRows() const { return _numRows; }
+	inline u32 numBitsPerRow() const { return _numBitsPerRow; }
+	inline Layout layout() const { return _layout; }
+	inline BitWordType* data() const { return _data; }
+	inline std::pmr::memory_resource* resource() const { return _resource; }
+
+	// row views, RowMajor only
+	inline BitSpan row(u32 row) const { return BitSpan(rowData(row), _numBitsPerRow); }
+	inline ConstBitSpan constRow(u32 row) const { return ConstBitSpan(rowData(row), _numBitsPerRow); }
+
+	// bit position views over all rows, Transposed only
+	inline BitSpan plane(u32 bit) const { return BitSpan(planeData(bit), _numRows); }
+	inline ConstBitSpan constPlane(u32 bit) const { return ConstBitSpan(planeData(bit), _numRows); }
+
+	inline void setBit(u32 row, u32 bit)
+	{
+		u32 wordIndex;
+		u32 bitIndex;
+		locate(row, bit, wordIndex, bitIndex);
+		bitword::setBit(_data[wordIndex], bitIndex);
+	}
+
+	inline void clearBit(u32 row, u32 bit)
+	{
+		u32 wordIndex;
+		u32 bitIndex;
+		locate(row, bit, wordIndex, bitIndex);
+		bitword::clearBit(_data[wordIndex], bitIndex);
+	}
+
+	inline bool getBit(u32 row, u32 bit) const
+	{
+		u32 wordIndex;
+		u32 bitIndex;
+		locate(row, bit, wordIndex, bitIndex);
+		return bitword::getBit(_data[wordIndex], bitIndex);
+	}
+
+	void clearAll();
+
+	// query has numBitsPerRow bits, result has numRows bits
+	// matchAll: query is a subset of the row, matchAny: row and query share a bit, matchNone: row and query share no bit
+	void matchAll(const ConstBitSpan& query, BitSpan& result) const;
+	void matchAny(const ConstBitSpan& query, BitSpan& result) const;
+	void matchNone(const ConstBitSpan& query, BitSpan& result) const;
+
+	// same as above but writes the matching row indices in increasing order, rowIndices must hold numRows entries
+	// returns number of matching rows
+	u32 matchAll(const ConstBitSpan& query, u32* rowIndices) const;
+	u32 matchAny(const ConstBitSpan& query, u32* rowIndices) const;
+	u32 matchNone(const ConstBitSpan& query, u32* rowIndices) const;
+
+	// row &= query for every row
+	void intersectAll(const ConstBitSpan& query);
+
+	// counts[row] = number of set bits in row, counts has to hold numRows entries
+	void countRowBits(u32* counts) const;
+
+private:
+	enum class Match { All, Any, None };
+
+	inline BitWordType* rowData(u32 row) const
+	{
+		DD_ASSERT(_layout == Layout::RowMajor && row < _numRows);
+		return _data + static_cast<usize>(row) * _wordsPerRow;
+	}
+
+	inline BitWordType* planeData(u32 bit) const
+	{
+		DD_ASSERT(_layout == Layout::Transposed && bit < _numBitsPerRow);
+		return _data + static_cast<usize>(bit) * _wordsPerPlane;
+	}
+
+	inline void locate(u32 row, u32 bit, u32& wordIndex, u32& bitIndex) const
+	{
+		DD_ASSERT(row < _numRows && bit < _numBitsPerRow);
+		if (_layout == Layout::RowMajor)
+		{
+			wordIndex = row * _wordsPerRow + bit / NumBitsInWord;
+			bitIndex = bit % NumBitsInWord;
+		}
+		else
+		{
+			wordIndex = bit * _wordsPerPlane + row / NumBitsInWord;
+			bitIndex = row % NumBitsInWord;
+		}
+	}
+
+	inline usize numWords() const { return _layout == Layout::RowMajor ? static_cast<usize>(_numRows) * _wordsPerRow : static_cast<usize>(_numBitsPerRow) * _wordsPerPlane; }
+	void release();
+
+	// calls emit(rowBlock, word) with one result bit per row for every block of 64 rows
+	template<typename Emit>
+	void evaluate(Match match, const ConstBitSpan& query, Emit&& emit) const;
+	void match(Match match, const ConstBitSpan& query, BitSpan& result) const;
+	u32 match(Match match, const ConstBitSpan& query, u32* rowIndices) const;
+
+	BitWordType* _data = nullptr;
+	std::pmr::memory_resource* _resource;
+	u32 _numRows;
+	u32 _numBitsPerRow;
+	u32 _wordsPerRow;
+	u32 _wordsPerPlane;
+	Layout _layout;
+};
+
+}
@@ -5,6 +5,7 @@
 #include <Core/Types.h>
 #include <Library/BitUtils/BitRangeZipper.h>
 #include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
 
 namespace ddahlkvist
 {
@@ -12,18 +13,22 @@ namespace ddahlkvist
 // BitSpan provide functionality to reason about a range of bits
 // it does not own or manage any data/buffer [memory management is supposed to happen outside of this class]
 // will attempt to "zero" any eventual dangling bits [seems like the best trade-off related to usability, performance and correctness]
-class BitSpan final
+// Word is any unsigned integer or VectorWord, BitSpan is the u64 instantiation used throughout the library
+template<typename Word>
+class BasicBitSpan final
 {
 public:
-	BitSpan(const BitSpan&) = delete;
-	void operator=(const BitSpan&) = delete;
-	void operator=(BitSpan&&) = delete;
-	BitSpan() = delete;
+	using WordType = Word;
 
-	inline BitSpan(BitWordType* data, u32 numBits)
+	BasicBitSpan(const BasicBitSpan&) = delete;
+	void operator=(const BasicBitSpan&) = delete;
+	void operator=(BasicBitSpan&&) = delete;
+	BasicBitSpan() = delete;
+
+	inline BasicBitSpan(Word* data, u32 numBits)
 		: _data(data)
-		, _danglingMask(bitword::hasDanglingPart(numBits) ? bitword::getDanglingPart(numBits) : bitword::Ones)
-		, _numWords(bitword::getNumWordsRequired(numBits))
+		, _danglingMask(bitword::hasDanglingPart<Word>(numBits) ? bitword::getDanglingPart<Word>(numBits) : bitword::OnesOf<Word>)
+		, _numWords(bitword::getNumWordsRequired<Word>(numBits))
 		, _numBits(numBits)
 	{
 		DD_ASSERT(numBits < 400000000); // sanity check against "-1 issues"
@@ -33,18 +38,24 @@ public:
 
 	inline void clearDanglingBits()
 	{
-		if (_numWords > 0 && _danglingMask != 0)
+		if (_numWords > 0 && _danglingMask != bitword::ZeroOf<Word>)
 			_data[_numWords - 1] &= _danglingMask;
 	}
 
+	inline Word* data() const { return _data; }
+	inline u32 numBits() const { return _numBits; }
+	inline u32 numWords() const { return _numWords; }
+
+	inline BasicConstBitSpan<Word> asConst() const { return BasicConstBitSpan<Word>(_data, _numBits); }
+
 	inline void clearAll() noexcept
 	{
-		foreachWord([](auto& a) { a = bitword::Zero; });
+		foreachWord([](auto& a) { a = bitword::ZeroOf<Word>; });
 	}
 
 	inline void setAll() noexcept
 	{
-		foreachWord([](auto& a) { a = bitword::Ones; });
+		foreachWord([](auto& a) { a = bitword::OnesOf<Word>; });
 
 		clearDanglingBits();
 	}
@@ -61,16 +72,16 @@ public:
 	{
 		DD_ASSERT(bit < _numBits);
 
-		auto& word = _data[bit / NumBitsInWord];
-		bitword::setBit(word, bit % NumBitsInWord);
+		auto& word = _data[bit / NumBitsIn<Word>];
+		bitword::setBit(word, bit % NumBitsIn<Word>);
 	}
 
 	inline bool getBit(u32 bit) const
 	{
 		DD_ASSERT(bit < _numBits);
 
-		auto word = _data[bit / NumBitsInWord];
-		return bitword::getBit(word, bit % NumBitsInWord);
+		auto word = _data[bit / NumBitsIn<Word>];
+		return bitword::getBit(word, bit % NumBitsIn<Word>);
 	}
 
 	template<typename WordAction>
@@ -91,18 +102,19 @@ public:
 		clearDanglingBits();
 
 		foreachWord([&it, bitAction = std::forward<BitAction&&>(action)](auto word) {
-			bitword::foreachOne(bitAction, word, it * NumBitsInWord);
+			bitword::foreachOne(bitAction, word, it * NumBitsIn<Word>);
 			it++;
 		});
 	}
 
-	inline bool operator==(const BitSpan& other)
+	inline bool operator==(const BasicBitSpan& other)
 	{
 		DD_ASSERT(_numBits == other._numBits);
 
 		auto it = _data;
 		auto otherIt = other._data;
-		const auto end = _data + (_danglingMask ? _numWords - 1 : _numWords);
+		const bool hasDanglingMask = _danglingMask != bitword::ZeroOf<Word>;
+		const auto end = _data + (hasDanglingMask ? _numWords - 1 : _numWords);
 
 		while (it != end)
 		{
@@ -113,52 +125,87 @@ public:
 			otherIt++;
 		}
 
-		if (_danglingMask)
+		if (hasDanglingMask)
 		{
-			BitWordType value = *it ^ *otherIt;
+			Word value = *it ^ *otherIt;
 			value &= _danglingMask;
-			return value == 0;
+			return value == bitword::ZeroOf<Word>;
 		}
 
 		return true;
 	}
 
-	inline void operator|=(const BitSpan& other)
+	inline void operator|=(const BasicBitSpan& other)
 	{
 		DD_ASSERT(_numBits == other._numBits);
 
-		BitRangeZipper zipper(_data, other._data, _numBits);
+		BasicBitRangeZipper<Word> zipper(_data, other._data, _numBits);
 		zipper.foreachWord([](auto& a, auto b) { a |= b; });
 
 		clearDanglingBits();
 	}
 
-	inline void operator&=(const BitSpan& other)
+	inline void operator&=(const BasicBitSpan& other)
 	{
 		DD_ASSERT(_numBits == other._numBits);
 
-		BitRangeZipper zipper(_data, other._data, _numBits);
+		BasicBitRangeZipper<Word> zipper(_data, other._data, _numBits);
 		zipper.foreachWord([](auto& a, auto b) { a &= b; });
 
 		clearDanglingBits();
 	}
 
-	inline void operator^=(const BitSpan& other)
+	inline void operator^=(const BasicBitSpan& other)
 	{
 		DD_ASSERT(_numBits == other._numBits);
 
-		BitRangeZipper zipper(_data, other._data, _numBits);
+		BasicBitRangeZipper<Word> zipper(_data, other._data, _numBits);
 		zipper.foreachWord([](auto& a, auto b) { a ^= b; });
 
 		clearDanglingBits();
 	}
 
+	// read-only right hand side, the other span is never written to [dangling bits are masked on read]
+	inline void assign(const BasicConstBitSpan<Word>& other)
+	{
+		DD_ASSERT(_numBits == other.numBits());
+
+		Word* out = _data;
+		other.foreachWord([&out](Word word) { *out++ = word; });
+	}
+
+	inline void operator|=(const BasicConstBitSpan<Word>& other)
+	{
+		DD_ASSERT(_numBits == other.numBits());
+
+		Word* out = _data;
+		other.foreachWord([&out](Word word) { *out++ |= word; });
+	}
+
+	inline void operator&=(const BasicConstBitSpan<Word>& other)
+	{
+		DD_ASSERT(_numBits == other.numBits());
+
+		Word* out = _data;
+		other.foreachWord([&out](Word word) { *out++ &= word; });
+	}
+
+	inline void operator^=(const BasicConstBitSpan<Word>& other)
+	{
+		DD_ASSERT(_numBits == other.numBits());
+
+		Word* out = _data;
+		other.foreachWord([&out](Word word) { *out++ ^= word; });
+	}
+
 private:
-	BitWordType* _data;
-	BitWordType _danglingMask;
+	Word* _data;
+	Word _danglingMask;
 
 	u32 _numWords;
 	u32 _numBits;
 };
 
+using BitSpan = BasicBitSpan<BitWordType>;
+
 }
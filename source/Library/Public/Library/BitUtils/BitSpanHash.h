@@ -0,0 +1,66 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitArray.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <cstddef>
+#include <functional>
+
+namespace ddahlkvist
+{
+
+// hashing of the logical bits of a span, dangling bits are masked on read and never written
+// [spans of different numBits hash differently even when their words are equal]
+namespace bitspan
+{
+
+// content hash, words are mixed four lanes at a time [32x32 bit multiplies of the word and a per position key, avx2 when available]
+// the same value is produced with and without avx2
+LIBRARY_PUBLIC u64 hash(const ConstBitSpan& bits, u64 seed = 0);
+
+// incremental hash: XOR of bitKey(i) over every set bit i
+// flipping bit i changes the hash by bitKey(i), so a mask that mutates one bit at a time is rehashed in O(1)
+// [linear in the bits, good for hash tables but unlike hash() not suited for adversarial input]
+inline u64 bitKey(u32 bit, u64 seed = 0)
+{
+	// splitmix64 finalizer of the bit index, no table to keep in cache
+	u64 value = (bit + seed) * 0x9E3779B97F4A7C15ull + 0x632BE59BD9B4E019ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+LIBRARY_PUBLIC u64 xorHash(const ConstBitSpan& bits, u64 seed = 0);
+
+// hash after bit has been set or cleared [the same operation both ways]
+inline u64 updateXorHash(u64 hash, u32 bit, u64 seed = 0) { return hash ^ bitKey(bit, seed); }
+
+}
+}
+
+// content hash for unordered containers, keys compared with operator== must have the same numBits
+namespace std
+{
+
+template<>
+struct hash<ddahlkvist::ConstBitSpan>
+{
+	inline size_t operator()(const ddahlkvist::ConstBitSpan& bits) const noexcept { return static_cast<size_t>(ddahlkvist::bitspan::hash(bits)); }
+};
+
+template<>
+struct hash<ddahlkvist::BitSpan>
+{
+	inline size_t operator()(const ddahlkvist::BitSpan& bits) const noexcept { return static_cast<size_t>(ddahlkvist::bitspan::hash(bits.asConst())); }
+};
+
+template<ddahlkvist::u32 NumBits>
+struct hash<ddahlkvist::BitArray<NumBits>>
+{
+	inline size_t operator()(const ddahlkvist::BitArray<NumBits>& bits) const noexcept { return static_cast<size_t>(ddahlkvist::bitspan::hash(bits.constSpan())); }
+};
+
+}
@@ -0,0 +1,101 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// binary layout of a serialized range of bits:
+// [BitStreamHeader][u32 crc32c per chunk, padded to whole words][words]
+// words are a raw copy of memory so they can be streamed to/from word buffers without intermediate copies
+struct LIBRARY_PUBLIC BitStreamHeader
+{
+	static constexpr u32 Magic = 0x53424444; // "DDBS"
+	static constexpr u16 CurrentVersion = 1;
+	static constexpr u16 FlagChunkChecksums = 1 << 0;
+	static constexpr u32 ByteOrderMark = 0x01020304;
+
+	u32 magic;
+	u16 version;
+	u16 flags;
+	u32 byteOrderMark;
+	u32 numBits;
+	u32 wordsPerChunk;
+	u32 headerChecksum; // crc32c of the header with this field zeroed
+	u8 reserved[8];
+
+	inline bool hasChunkChecksums() const { return (flags & FlagChunkChecksums) != 0; }
+	inline u32 numWords() const { return bitword::getNumWordsRequired(numBits); }
+	inline u32 numChunks() const { return (numWords() + wordsPerChunk - 1) / wordsPerChunk; }
+
+	u64 getChecksumTableSize() const;
+	u64 getWordsOffset() const;
+	u32 computeHeaderChecksum() const;
+	bool isCompatible() const;
+};
+static_assert(sizeof(BitStreamHeader) == 32);
+
+struct BitStreamOptions
+{
+	u32 wordsPerChunk = 8192; // 64kb of words per checksum
+	bool chunkChecksums = true;
+};
+
+enum class BitStreamStatus
+{
+	Ok,
+	IoError,
+	IncompatibleHeader,
+	ChecksumMismatch,
+	OutOfRange,
+};
+
+class LIBRARY_PUBLIC BitStreamWriter final
+{
+public:
+	static u64 getSerializedSize(u32 numBits, const BitStreamOptions& options = {});
+
+	// words are handed to the OS straight from the span [writev], only header, checksums and the masked last word are staged
+	static BitStreamStatus write(int fd, const ConstBitSpan& bits, const BitStreamOptions& options = {});
+};
+
+// reads a stream produced by BitStreamWriter straight into caller provided word buffers
+// readAll only reads forward and works on pipes/sockets, readRange requires a seekable file descriptor
+class LIBRARY_PUBLIC BitStreamReader final
+{
+public:
+	explicit BitStreamReader(int fd);
+
+	// reads and validates header + checksum table, must be called before any other read
+	BitStreamStatus readHeader();
+
+	inline const BitStreamHeader& header() const { return _header; }
+	inline u32 numBits() const { return _header.numBits; }
+
+	// number of words the destination of readRange must be able to hold
+	static u32 getNumWordsRequiredForRange(u32 firstBit, u32 numBits);
+
+	// words must hold bitword::getNumWordsRequired(numBits()) words
+	BitStreamStatus readAll(BitWordType* words, bool verify = true);
+
+	// reads bits [firstBit, firstBit + numBits) so that firstBit ends up as bit 0 of words
+	// only the chunks overlapping the range are read [and verified]
+	BitStreamStatus readRange(u32 firstBit, u32 numBits, BitWordType* words, bool verify = true);
+
+private:
+	BitStreamStatus readChunkRange(u32 firstWord, u32 numWords, BitWordType* words, bool verify);
+
+	int _fd;
+	s64 _streamOffset = -1;
+	BitStreamHeader _header = {};
+	std::vector<u32> _checksums;
+	std::vector<BitWordType> _scratch;
+};
+
+}
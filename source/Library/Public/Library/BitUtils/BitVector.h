@@ -0,0 +1,288 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <algorithm>
+#include <cstring>
+#include <memory_resource>
+#include <utility>
+
+namespace ddahlkvist
+{
+
+// growable range of bits with amortized O(1) pushBack [geometric capacity growth]
+// invariant: every bit between numBits() and capacity() is zero, growing never has to clear memory again
+// storage comes from a std::pmr::memory_resource and is cache line aligned, same as BitBuffer
+class BitVector final
+{
+public:
+	static constexpr usize Alignment = 64;
+	static constexpr u32 MinCapacityWords = Alignment / sizeof(BitWordType);
+
+	explicit BitVector(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: _resource(resource)
+	{
+	}
+
+	explicit BitVector(u32 numBits, bool value, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: _resource(resource)
+	{
+		resize(numBits, value);
+	}
+
+	~BitVector()
+	{
+		release();
+	}
+
+	BitVector(const BitVector& other)
+		: _resource(other._resource)
+	{
+		append(other.constSpan());
+	}
+
+	BitVector& operator=(const BitVector& other)
+	{
+		if (this != &other)
+		{
+			clear();
+			append(other.constSpan());
+		}
+		return *this;
+	}
+
+	BitVector(BitVector&& other) noexcept
+		: _resource(other._resource)
+		, _data(std::exchange(other._data, nullptr))
+		, _numBits(std::exchange(other._numBits, 0))
+		, _capacityWords(std::exchange(other._capacityWords, 0))
+	{
+	}
+
+	BitVector& operator=(BitVector&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			_resource = other._resource;
+			_data = std::exchange(other._data, nullptr);
+			_numBits = std::exchange(other._numBits, 0);
+			_capacityWords = std::exchange(other._capacityWords, 0);
+		}
+		return *this;
+	}
+
+	inline u32 numBits() const { return _numBits; }
+	inline u32 numWords() const { return bitword::getNumWordsRequired(_numBits); }
+	inline u32 capacity() const { return _capacityWords * NumBitsInWord; }
+	inline bool empty() const { return _numBits == 0; }
+	inline BitWordType* data() const { return _data; }
+
+	inline BitSpan span() const { return BitSpan(_data, _numBits); }
+	inline ConstBitSpan constSpan() const { return ConstBitSpan(_data, _numBits); }
+
+	inline void setBit(u32 bit)
+	{
+		DD_ASSERT(bit < _numBits);
+		bitword::setBit(_data[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+
+	inline void clearBit(u32 bit)
+	{
+		DD_ASSERT(bit < _numBits);
+		bitword::clearBit(_data[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+
+	inline bool getBit(u32 bit) const
+	{
+		DD_ASSERT(bit < _numBits);
+		return bitword::getBit(_data[bit / NumBitsInWord], bit % NumBitsInWord);
+	}
+
+	void reserve(u32 numBits)
+	{
+		const u32 requiredWords = bitword::getNumWordsRequired(numBits);
+		if (requiredWords > _capacityWords)
+			reallocate(requiredWords);
+	}
+
+	inline void pushBack(bool value)
+	{
+		if (_numBits == capacity())
+			grow(_numBits + 1);
+
+		// bit is already zero [invariant], only ones have to be written
+		if (value)
+			bitword::setBit(_data[_numBits / NumBitsInWord], _numBits % NumBitsInWord);
+
+		_numBits++;
+	}
+
+	void popBack()
+	{
+		DD_ASSERT(_numBits > 0);
+		_numBits--;
+		bitword::clearBit(_data[_numBits / NumBitsInWord], _numBits % NumBitsInWord);
+	}
+
+	void append(const ConstBitSpan& bits)
+	{
+		// a view into this vector would be read after its words are reallocated or or-ed into, append a copy instead
+		if (aliases(bits))
+		{
+			BitVector copy(_resource);
+			copy.append(bits);
+			append(copy.constSpan());
+			return;
+		}
+
+		const u32 newNumBits = _numBits + bits.numBits();
+		if (newNumBits > capacity())
+			grow(newNumBits);
+
+		const u32 shift = _numBits % NumBitsInWord;
+		const u32 newNumWords = bitword::getNumWordsRequired(newNumBits);
+		BitWordType* out = _data + _numBits / NumBitsInWord;
+
+		if (shift == 0)
+		{
+			// word aligned, last word is provided masked by ConstBitSpan
+			bits.foreachWord([&out](BitWordType word) { *out++ = word; });
+		}
+		else
+		{
+			// bits above the current size are zero so or-ing is enough for the low part
+			BitWordType* const end = _data + newNumWords;
+			bits.foreachWord([&out, end, shift](BitWordType word) {
+				*out |= word << shift;
+				out++;
+				if (out != end)
+					*out = word >> (NumBitsInWord - shift);
+			});
+		}
+
+		_numBits = newNumBits;
+	}
+
+	// shrinking clears the removed bits in place, capacity is kept
+	void resize(u32 numBits, bool value = false)
+	{
+		if (numBits < _numBits)
+		{
+			clearRange(numBits, _numBits);
+			_numBits = numBits;
+			return;
+		}
+
+		if (numBits > capacity())
+			grow(numBits);
+
+		if (value)
+			setRange(_numBits, numBits);
+
+		_numBits = numBits;
+	}
+
+	// keeps capacity
+	void clear()
+	{
+		clearRange(0, _numBits);
+		_numBits = 0;
+	}
+
+	// reallocates to the smallest capacity able to hold numBits()
+	void shrinkToFit()
+	{
+		const u32 requiredWords = numWords();
+		if (requiredWords == _capacityWords)
+			return;
+
+		if (requiredWords == 0)
+		{
+			release();
+			_data = nullptr;
+			_capacityWords = 0;
+			return;
+		}
+
+		reallocate(requiredWords);
+	}
+
+private:
+	inline bool aliases(const ConstBitSpan& bits) const
+	{
+		return bits.numWords() != 0 && bits.data() + bits.numWords() > _data && bits.data() < _data + _capacityWords;
+	}
+
+	inline void grow(u32 minNumBits)
+	{
+		const u32 requiredWords = bitword::getNumWordsRequired(minNumBits);
+		reallocate(std::max({ requiredWords, _capacityWords * 2, MinCapacityWords }));
+	}
+
+	void reallocate(u32 numWords)
+	{
+		const u32 usedWords = this->numWords();
+		DD_ASSERT(numWords >= usedWords);
+
+		auto* data = static_cast<BitWordType*>(_resource->allocate(numWords * sizeof(BitWordType), Alignment));
+		if (usedWords > 0)
+			memcpy(data, _data, usedWords * sizeof(BitWordType));
+		memset(data + usedWords, 0, (numWords - usedWords) * sizeof(BitWordType));
+
+		release();
+		_data = data;
+		_capacityWords = numWords;
+	}
+
+	void release()
+	{
+		if (_data != nullptr)
+			_resource->deallocate(_data, _capacityWords * sizeof(BitWordType), Alignment);
+	}
+
+	// [begin, end) are within capacity
+	void setRange(u32 begin, u32 end)
+	{
+		modifyRange(begin, end, [](BitWordType& word, BitWordType mask) { word |= mask; });
+	}
+
+	void clearRange(u32 begin, u32 end)
+	{
+		modifyRange(begin, end, [](BitWordType& word, BitWordType mask) { word &= ~mask; });
+	}
+
+	template<typename WordAction>
+	void modifyRange(u32 begin, u32 end, WordAction&& action)
+	{
+		if (begin >= end)
+			return;
+
+		const u32 firstWord = begin / NumBitsInWord;
+		const u32 lastWord = (end - 1) / NumBitsInWord;
+		const BitWordType firstMask = bitword::Ones << (begin % NumBitsInWord);
+		const BitWordType lastMask = bitword::hasDanglingPart(end) ? bitword::getDanglingPart(end) : bitword::Ones;
+
+		if (firstWord == lastWord)
+		{
+			action(_data[firstWord], firstMask & lastMask);
+			return;
+		}
+
+		action(_data[firstWord], firstMask);
+		for (u32 i = firstWord + 1; i < lastWord; ++i)
+			action(_data[i], bitword::Ones);
+		action(_data[lastWord], lastMask);
+	}
+
+	std::pmr::memory_resource* _resource;
+	BitWordType* _data = nullptr;
+	u32 _numBits = 0;
+	u32 _capacityWords = 0;
+};
+
+}
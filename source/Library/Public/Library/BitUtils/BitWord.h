@@ -1,16 +1,23 @@
 // copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
 #pragma once
 
+#include <Core/Platform.h>
 #include <Core/Types.h>
 #include <intrin.h>
 #include <functional>
+#include <type_traits>
 
 namespace ddahlkvist
 {
 
+// default word used by the bit utilities, the Basic* class templates accept any unsigned integer [u8..u64]
+// or a VectorWord [128/256/512 bits] as word type
 using BitWordType = u64;
 
-constexpr u32 NumBitsInWord = sizeof(BitWordType) * 8;
+template<typename Word>
+constexpr u32 NumBitsIn = sizeof(Word) * 8;
+
+constexpr u32 NumBitsInWord = NumBitsIn<BitWordType>;
 
 namespace bitword
 {
@@ -18,67 +25,133 @@ namespace bitword
 constexpr BitWordType Zero = BitWordType{ 0 };
 constexpr BitWordType Ones = BitWordType{ ~0ull };
 
+template<typename Word>
+constexpr Word ZeroOf = Word{};
+
+template<typename Word>
+constexpr Word OnesOf = static_cast<Word>(~Word{});
+
+template<typename Word = BitWordType>
 constexpr bool hasDanglingPart(u32 numBits)
 {
-	return (numBits % NumBitsInWord != 0);
+	return (numBits % NumBitsIn<Word> != 0);
 }
 
+template<typename Word = BitWordType>
 constexpr u32 getNumWordsRequired(u32 numBits) {
-	const u32 numWords = numBits / NumBitsInWord + static_cast<u32>(hasDanglingPart(numBits));
+	const u32 numWords = numBits / NumBitsIn<Word> + static_cast<u32>(hasDanglingPart<Word>(numBits));
 	return numWords;
 }
 
+template<typename Word = BitWordType>
 constexpr u32 getNumBytesRequiredToRepresentWordBasedBitBuffer(u32 numBits) {
-	const u32 numWords = getNumWordsRequired(numBits);
-	const u32 numBytes = numWords * sizeof(BitWordType);
+	const u32 numWords = getNumWordsRequired<Word>(numBits);
+	const u32 numBytes = numWords * sizeof(Word);
 	return numBytes;
 }
 
-constexpr BitWordType getDanglingPart(u32 numBits)
+// integer words are handled here, vector words implement the same operations as members
+template<typename Word = BitWordType>
+constexpr Word getDanglingPart(u32 numBits)
 {
-	numBits = numBits % NumBitsInWord;
+	numBits = numBits % NumBitsIn<Word>;
 
-	BitWordType value = (1ull << numBits) - 1;
-	return value;
+	if constexpr (std::is_integral_v<Word>)
+	{
+		Word value = static_cast<Word>((1ull << numBits) - 1);
+		return value;
+	}
+	else
+	{
+		return Word::lowBits(numBits);
+	}
 }
 
-inline void clearBit(BitWordType& word, u32 bit)
+template<typename Word>
+constexpr void clearBit(Word& word, u32 bit)
 {
-	BitWordType mask = (1ull << bit);
-	word &= ~mask;
+	if constexpr (std::is_integral_v<Word>)
+	{
+		Word mask = static_cast<Word>(1ull << bit);
+		word &= static_cast<Word>(~mask);
+	}
+	else
+	{
+		word.clearBit(bit);
+	}
 }
 
-inline void setBit(BitWordType& word, u32 bit)
+template<typename Word>
+constexpr void setBit(Word& word, u32 bit)
 {
-	BitWordType mask = (1ull << bit);
-	word = (word & ~mask) | mask;
+	if constexpr (std::is_integral_v<Word>)
+	{
+		Word mask = static_cast<Word>(1ull << bit);
+		word = static_cast<Word>((word & ~mask) | mask);
+	}
+	else
+	{
+		word.setBit(bit);
+	}
 }
 
-inline bool getBit(BitWordType word, u32 bit)
+template<typename Word>
+constexpr bool getBit(Word word, u32 bit)
 {
-	BitWordType mask = (1ull << bit);
-	return word & mask;
+	if constexpr (std::is_integral_v<Word>)
+	{
+		Word mask = static_cast<Word>(1ull << bit);
+		return (word & mask) != 0;
+	}
+	else
+	{
+		return word.getBit(bit);
+	}
 }
 
-inline BitWordType countSetBits(BitWordType word)
+template<typename Word>
+inline u32 countSetBits(Word word)
 {
-	return __popcnt64(word);
+	if constexpr (std::is_integral_v<Word>)
+	{
+		static_assert(std::is_unsigned_v<Word>);
+		return static_cast<u32>(__popcnt64(word));
+	}
+	else
+	{
+		return word.countSetBits();
+	}
 }
 
-template<class BitAction>
-void foreachOne(BitAction&& action, BitWordType word, uint invokedBitIndexOffset = 0)
+// index of the lowest set bit, word must not be zero
+inline u32 getLowestSetBit(u64 word)
 {
-	uint i = invokedBitIndexOffset;
+	DD_ASSERT(word != 0);
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return static_cast<u32>(index);
+}
 
-	while (word != 0ull)
+template<class BitAction, typename Word>
+void foreachOne(BitAction&& action, Word word, uint invokedBitIndexOffset = 0)
+{
+	if constexpr (std::is_integral_v<Word>)
 	{
-		if (word & 1ull)
-			action(i);
-
-		i++;
-		word >>= 1;
+		static_assert(std::is_unsigned_v<Word>);
+		u64 bits = word;
+
+		// one iteration per set bit, lowest bit is cleared by bits & (bits - 1)
+		while (bits != 0u)
+		{
+			action(invokedBitIndexOffset + getLowestSetBit(bits));
+			bits &= bits - 1;
+		}
+	}
+	else
+	{
+		word.foreachOne(action, invokedBitIndexOffset);
 	}
 }
 
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,245 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitStream.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/BitUtils/VectorWord.h>
+#include <Library/library_module.h>
+#include <algorithm>
+#include <memory_resource>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) || defined(__SSE__)
+#include <xmmintrin.h>
+#define DD_BLOOM_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define DD_BLOOM_PREFETCH(address) do {} while (false)
+#endif
+
+namespace ddahlkvist
+{
+
+// stored in front of the BitStream holding the blocks
+struct LIBRARY_PUBLIC BloomFilterHeader
+{
+	static constexpr u32 Magic = 0x46424444; // "DDBF"
+	static constexpr u16 CurrentVersion = 1;
+
+	u32 magic;
+	u16 version;
+	u16 blockBits;
+	u32 numBlocks;
+	u32 reserved;
+};
+static_assert(sizeof(BloomFilterHeader) == 16);
+
+namespace bloomfilter
+{
+
+// salts for the per lane multiply-shift hashes, one per 32 bit half lane
+alignas(64) constexpr u32 Salts[16] = {
+	0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u,
+	0x9e3779b1u, 0x85ebca77u, 0xc2b2ae3du, 0x27d4eb2fu, 0x165667b1u, 0xd3a2646du, 0xfd7046c5u, 0xb55a4f09u,
+};
+
+LIBRARY_PUBLIC BitStreamStatus write(int fd, u32 blockBits, const ConstBitSpan& bits);
+
+// reads the filter header, block data follows as a BitStream on the same descriptor
+LIBRARY_PUBLIC BitStreamStatus readHeader(int fd, u32 blockBits, BloomFilterHeader& header);
+
+}
+
+// split block bloom filter, every key sets/tests one bit in each 32 bit part of a single block
+// so a query touches exactly one cache line [or half of one] instead of k random ones
+// keys are 64 bit hashes computed by the caller, high half selects the block and low half the bits
+// Block is BitWord256 [8 bits per key] or BitWord512 [16 bits per key, one full cache line]
+template<typename Block>
+class BlockBloomFilter final
+{
+public:
+	static constexpr u32 BlockBits = NumBitsIn<Block>;
+	static constexpr u32 NumLanes = BlockBits / 64;
+	static constexpr u32 PrefetchDistance = 8;
+	static constexpr u32 MaxNumBlocks = ~u32{ 0 } / BlockBits; // all bits have to be addressable with u32
+
+	static_assert(BlockBits == 256 || BlockBits == 512);
+
+	// enough blocks for numKeys keys with bitsPerKey bits of memory each [~10 gives about 1% false positives with 256 bit blocks]
+	static constexpr u32 getNumBlocks(u32 numKeys, u32 bitsPerKey)
+	{
+		const u64 numBits = static_cast<u64>(numKeys) * bitsPerKey;
+		const u64 numBlocks = (numBits + BlockBits - 1) / BlockBits;
+		return numBlocks > 0 ? static_cast<u32>(std::min<u64>(numBlocks, MaxNumBlocks)) : 1u;
+	}
+
+	explicit BlockBloomFilter(u32 numBlocks, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: _blocks(BasicBitBuffer<Block>::ZeroInit, numBlocks * BlockBits, resource)
+		, _numBlocks(numBlocks)
+	{
+		DD_ASSERT(numBlocks > 0 && numBlocks <= MaxNumBlocks);
+	}
+
+	inline u32 numBlocks() const { return _numBlocks; }
+	inline const Block* data() const { return _blocks.data(); }
+
+	// all bits of the filter as regular words, for popcounts and serialization
+	inline ConstBitSpan constSpan() const { return ConstBitSpan(reinterpret_cast<const BitWordType*>(_blocks.data()), _numBlocks * BlockBits); }
+
+	inline void clear() { _blocks.span().clearAll(); }
+
+	inline void insert(u64 hash)
+	{
+		Block& block = _blocks.data()[getBlockIndex(hash)];
+		block |= makeMask(static_cast<u32>(hash));
+	}
+
+	inline bool contains(u64 hash) const
+	{
+		const Block& block = _blocks.data()[getBlockIndex(hash)];
+		return containsMask(block, makeMask(static_cast<u32>(hash)));
+	}
+
+	// blocks of upcoming keys are prefetched so the cache misses overlap
+	void insertBatch(const u64* hashes, u32 numHashes)
+	{
+		for (u32 i = 0; i < numHashes; ++i)
+		{
+			if (i + PrefetchDistance < numHashes)
+				DD_BLOOM_PREFETCH(_blocks.data() + getBlockIndex(hashes[i + PrefetchDistance]));
+
+			insert(hashes[i]);
+		}
+	}
+
+	// results[i] = contains(hashes[i]), results must hold numHashes bits
+	void containsBatch(const u64* hashes, u32 numHashes, BitSpan& results) const
+	{
+		DD_ASSERT(results.numBits() == numHashes);
+
+		BitWordType* out = results.data();
+		BitWordType word = bitword::Zero;
+
+		for (u32 i = 0; i < numHashes; ++i)
+		{
+			if (i + PrefetchDistance < numHashes)
+				DD_BLOOM_PREFETCH(_blocks.data() + getBlockIndex(hashes[i + PrefetchDistance]));
+
+			word |= static_cast<BitWordType>(contains(hashes[i])) << (i % NumBitsInWord);
+
+			if (i % NumBitsInWord == NumBitsInWord - 1)
+			{
+				*out++ = word;
+				word = bitword::Zero;
+			}
+		}
+
+		if (bitword::hasDanglingPart(numHashes))
+			*out = word;
+	}
+
+	// filters have to be of the same size, results answer for keys in either / both filters
+	inline void unionWith(const BlockBloomFilter& other)
+	{
+		DD_ASSERT(_numBlocks == other._numBlocks);
+		_blocks.span() |= other._blocks.span();
+	}
+
+	// may report keys that were inserted in neither filter more often than a filter built from the intersection
+	inline void intersectWith(const BlockBloomFilter& other)
+	{
+		DD_ASSERT(_numBlocks == other._numBlocks);
+		_blocks.span() &= other._blocks.span();
+	}
+
+	inline BitStreamStatus write(int fd) const
+	{
+		return bloomfilter::write(fd, BlockBits, constSpan());
+	}
+
+	// output is replaced by the filter stored in fd
+	static BitStreamStatus read(int fd, BlockBloomFilter& output, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	{
+		BloomFilterHeader header;
+		BitStreamStatus status = bloomfilter::readHeader(fd, BlockBits, header);
+		if (status != BitStreamStatus::Ok)
+			return status;
+
+		BitStreamReader reader(fd);
+		status = reader.readHeader();
+		if (status != BitStreamStatus::Ok)
+			return status;
+
+		if (header.numBlocks == 0 || header.numBlocks > MaxNumBlocks || reader.numBits() != u64{ header.numBlocks } * BlockBits)
+			return BitStreamStatus::IncompatibleHeader;
+
+		BlockBloomFilter filter(header.numBlocks, resource);
+		status = reader.readAll(reinterpret_cast<BitWordType*>(filter._blocks.data()));
+		if (status != BitStreamStatus::Ok)
+			return status;
+
+		output = std::move(filter);
+		return BitStreamStatus::Ok;
+	}
+
+private:
+	// multiply-shift range reduction, avoids a modulo
+	inline u32 getBlockIndex(u64 hash) const
+	{
+		return static_cast<u32>(((hash >> 32) * _numBlocks) >> 32);
+	}
+
+	// bit (hash * salt) >> 27 in every 32 bit half of every lane
+	static inline Block makeMask(u32 hash)
+	{
+		Block mask;
+#if defined(__AVX2__)
+		const __m256i hashes = _mm256_set1_epi32(static_cast<int>(hash));
+		const __m256i ones = _mm256_set1_epi32(1);
+		for (u32 i = 0; i < NumLanes / 4; ++i)
+		{
+			const __m256i salts = _mm256_load_si256(reinterpret_cast<const __m256i*>(bloomfilter::Salts + i * 8));
+			const __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(hashes, salts), 27);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(mask.lanes + i * 4), _mm256_sllv_epi32(ones, bits));
+		}
+#else
+		for (u32 i = 0; i < NumLanes; ++i)
+		{
+			const u32 low = (hash * bloomfilter::Salts[2 * i]) >> 27;
+			const u32 high = (hash * bloomfilter::Salts[2 * i + 1]) >> 27;
+			mask.lanes[i] = (1ull << low) | (1ull << (32 + high));
+		}
+#endif
+		return mask;
+	}
+
+	static inline bool containsMask(const Block& block, const Block& mask)
+	{
+#if defined(__AVX2__)
+		int result = 1;
+		for (u32 i = 0; i < NumLanes / 4; ++i)
+		{
+			const __m256i blockLanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.lanes + i * 4));
+			const __m256i maskLanes = _mm256_load_si256(reinterpret_cast<const __m256i*>(mask.lanes + i * 4));
+			result &= _mm256_testc_si256(blockLanes, maskLanes);
+		}
+		return result != 0;
+#else
+		return (block & mask) == mask;
+#endif
+	}
+
+	BasicBitBuffer<Block> _blocks;
+	u32 _numBlocks;
+};
+
+using BloomFilter256 = BlockBloomFilter<BitWord256>;
+using BloomFilter512 = BlockBloomFilter<BitWord512>;
+
+}
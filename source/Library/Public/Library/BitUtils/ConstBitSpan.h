@@ -0,0 +1,112 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+
+namespace ddahlkvist
+{
+
+// ConstBitSpan is the read-only sibling of BitSpan
+// it never writes to the underlying words, dangling bits are masked away when read instead of being cleared
+// [makes it usable on top of memory that is not writable, ex read-only file mappings]
+template<typename Word>
+class BasicConstBitSpan final
+{
+public:
+	using WordType = Word;
+
+	BasicConstBitSpan() = delete;
+
+	inline BasicConstBitSpan(const Word* data, u32 numBits)
+		: _data(data)
+		, _danglingMask(bitword::hasDanglingPart<Word>(numBits) ? bitword::getDanglingPart<Word>(numBits) : bitword::OnesOf<Word>)
+		, _numWords(bitword::getNumWordsRequired<Word>(numBits))
+		, _numBits(numBits)
+	{
+		DD_ASSERT(numBits < 400000000); // sanity check against "-1 issues"
+	}
+
+	inline const Word* data() const { return _data; }
+	inline u32 numBits() const { return _numBits; }
+	inline u32 numWords() const { return _numWords; }
+
+	inline u32 countSetBits() const {
+		u64 counter = 0;
+		foreachWord([&counter](auto a) { counter += bitword::countSetBits(a); });
+		return static_cast<u32>(counter);
+	}
+
+	inline bool getBit(u32 bit) const
+	{
+		DD_ASSERT(bit < _numBits);
+
+		auto word = _data[bit / NumBitsIn<Word>];
+		return bitword::getBit(word, bit % NumBitsIn<Word>);
+	}
+
+	// last word is provided with its dangling bits masked away
+	template<typename WordAction>
+	inline void foreachWord(WordAction&& action) const noexcept {
+		if (_numWords == 0)
+			return;
+
+		auto it = _data;
+		auto end = it + _numWords - 1;
+
+		while (it != end)
+		{
+			action(*it);
+			it++;
+		}
+
+		action(static_cast<Word>(*it & _danglingMask));
+	}
+
+	template<typename BitAction>
+	inline void foreachSetBit(BitAction&& action) const noexcept {
+		u32 it = 0;
+
+		foreachWord([&it, bitAction = std::forward<BitAction&&>(action)](auto word) {
+			bitword::foreachOne(bitAction, word, it * NumBitsIn<Word>);
+			it++;
+		});
+	}
+
+	inline bool operator==(const BasicConstBitSpan& other) const
+	{
+		DD_ASSERT(_numBits == other._numBits);
+
+		if (_numWords == 0)
+			return true;
+
+		auto it = _data;
+		auto otherIt = other._data;
+		const auto end = _data + _numWords - 1;
+
+		while (it != end)
+		{
+			if (*it != *otherIt)
+				return false;
+
+			it++;
+			otherIt++;
+		}
+
+		Word value = *it ^ *otherIt;
+		value &= _danglingMask;
+		return value == bitword::ZeroOf<Word>;
+	}
+
+private:
+	const Word* _data;
+	Word _danglingMask;
+
+	u32 _numWords;
+	u32 _numBits;
+};
+
+using ConstBitSpan = BasicConstBitSpan<BitWordType>;
+
+}
@@ -0,0 +1,78 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitArray.h>
+#include <initializer_list>
+#include <type_traits>
+
+namespace ddahlkvist
+{
+
+// set of enum values backed by a BitArray, enum values are used as bit indices
+// NumValues defaults to Enum::Count which is the convention for enums used with this class
+template<typename Enum, u32 NumValues = static_cast<u32>(Enum::Count)>
+class EnumBitSet final
+{
+	static_assert(std::is_enum_v<Enum>);
+
+public:
+	using Bits = BitArray<NumValues>;
+
+	constexpr EnumBitSet() = default;
+
+	constexpr EnumBitSet(std::initializer_list<Enum> values)
+	{
+		for (Enum value : values)
+			set(value);
+	}
+
+	static constexpr EnumBitSet all()
+	{
+		EnumBitSet result;
+		result._bits = Bits::ones();
+		return result;
+	}
+
+	constexpr void set(Enum value) { _bits.setBit(toIndex(value)); }
+	constexpr void reset(Enum value) { _bits.clearBit(toIndex(value)); }
+	constexpr bool test(Enum value) const { return _bits.getBit(toIndex(value)); }
+
+	constexpr bool any() const { return _bits.any(); }
+	constexpr bool none() const { return _bits.none(); }
+	inline u32 count() const { return _bits.countSetBits(); }
+
+	constexpr bool containsAll(const EnumBitSet& other) const { return _bits.containsAll(other._bits); }
+	constexpr bool intersects(const EnumBitSet& other) const { return _bits.intersects(other._bits); }
+
+	constexpr EnumBitSet& operator|=(const EnumBitSet& other) { _bits |= other._bits; return *this; }
+	constexpr EnumBitSet& operator&=(const EnumBitSet& other) { _bits &= other._bits; return *this; }
+	constexpr EnumBitSet& operator^=(const EnumBitSet& other) { _bits ^= other._bits; return *this; }
+
+	constexpr EnumBitSet operator|(const EnumBitSet& other) const { EnumBitSet result = *this; result |= other; return result; }
+	constexpr EnumBitSet operator&(const EnumBitSet& other) const { EnumBitSet result = *this; result &= other; return result; }
+	constexpr EnumBitSet operator^(const EnumBitSet& other) const { EnumBitSet result = *this; result ^= other; return result; }
+	constexpr EnumBitSet operator~() const { EnumBitSet result; result._bits = ~_bits; return result; }
+
+	constexpr bool operator==(const EnumBitSet& other) const { return _bits == other._bits; }
+	constexpr bool operator!=(const EnumBitSet& other) const { return _bits != other._bits; }
+
+	template<typename ValueAction>
+	inline void foreachValue(ValueAction&& action) const
+	{
+		_bits.foreachSetBit([&action](u32 bit) { action(static_cast<Enum>(bit)); });
+	}
+
+	constexpr const Bits& bits() const { return _bits; }
+	inline ConstBitSpan constSpan() const { return _bits.constSpan(); }
+
+private:
+	static constexpr u32 toIndex(Enum value)
+	{
+		return static_cast<u32>(value);
+	}
+
+	Bits _bits;
+};
+
+}
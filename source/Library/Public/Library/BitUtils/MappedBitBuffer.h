@@ -0,0 +1,109 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+// self describing header placed first in every bitmap file, word data follows directly after it
+// size is one cache line so that the word data stays 64 byte aligned inside the mapping
+struct LIBRARY_PUBLIC BitFileHeader
+{
+	static constexpr u32 Magic = 0x4D424444; // "DDBM"
+	static constexpr u16 CurrentVersion = 1;
+	static constexpr u32 ByteOrderMark = 0x01020304;
+
+	u32 magic;
+	u16 version;
+	u16 wordSize;
+	u32 byteOrderMark;
+	u32 numBits;
+	u64 numWords;
+	u64 checksum;
+	u8 reserved[32];
+
+	static BitFileHeader create(u32 numBits); // checksum is left zeroed
+	bool isCompatible() const;
+};
+static_assert(sizeof(BitFileHeader) == 64);
+
+// word data is a raw copy of memory, a checksum of all bits is stored in the header when flushing
+LIBRARY_PUBLIC u64 computeBitFileChecksum(const BitWordType* words, u32 numBits);
+
+// incremental form of computeBitFileChecksum, words can be appended in pieces of any size
+// last word must be appended with its dangling bits cleared
+class LIBRARY_PUBLIC BitFileChecksum final
+{
+public:
+	BitFileChecksum();
+
+	void append(const BitWordType* words, u64 numWords);
+	u64 finish(u32 numBits) const;
+
+private:
+	u64 _lanes[4];
+	BitWordType _pending[4];
+	u32 _numPending = 0;
+};
+
+// BitBuffer-like owner of a file backed (memory mapped) range of bits
+// pages are only faulted in when touched, so opening a huge bitmap is close to free
+// checksum is NOT validated on open since that would touch every page, call verifyChecksum() when needed
+class LIBRARY_PUBLIC MappedBitBuffer final
+{
+public:
+	enum class Access { ReadOnly, ReadWrite };
+
+	MappedBitBuffer() = default;
+	~MappedBitBuffer();
+
+	MappedBitBuffer(const MappedBitBuffer&) = delete;
+	MappedBitBuffer& operator=(const MappedBitBuffer&) = delete;
+	MappedBitBuffer(MappedBitBuffer&& other) noexcept;
+	MappedBitBuffer& operator=(MappedBitBuffer&& other) noexcept;
+
+	// creates [or truncates] the file at path and maps it read-write with all bits cleared
+	static MappedBitBuffer create(const char* path, u32 numBits);
+
+	// maps an existing bitmap file, result is invalid if the file is missing or the header is incompatible
+	static MappedBitBuffer open(const char* path, Access access);
+
+	inline bool isValid() const { return _header != nullptr; }
+	inline bool isWritable() const { return _access == Access::ReadWrite; }
+
+	inline u32 numBits() const { return _header ? _header->numBits : 0u; }
+	inline u32 size() const { return bitword::getNumBytesRequiredToRepresentWordBasedBitBuffer(numBits()); }
+	inline BitWordType* data() const { return _words; }
+
+	BitWordType* begin() const { return data(); }
+	BitWordType* end() const { return data() + bitword::getNumWordsRequired(numBits()); }
+
+	inline BitSpan span() const {
+		DD_ASSERT(isWritable());
+		return BitSpan(_words, numBits());
+	}
+
+	inline ConstBitSpan constSpan() const { return ConstBitSpan(_words, numBits()); }
+
+	bool verifyChecksum() const;
+
+	// stores an updated checksum in the header and synchronously writes dirty pages to the file
+	bool flush();
+
+	void close();
+
+private:
+	BitFileHeader* _header = nullptr;
+	BitWordType* _words = nullptr;
+	u64 _mappingSize = 0;
+	void* _fileHandle = nullptr; // only used on platforms where the mapping does not outlive the file handle
+	Access _access = Access::ReadOnly;
+};
+
+}
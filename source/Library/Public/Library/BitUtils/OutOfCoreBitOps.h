@@ -0,0 +1,34 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+struct OutOfCoreOptions
+{
+	u32 wordsPerChunk = 128 * 1024; // 1mb per file and buffer, memory use is 2 * numFiles * chunk size
+};
+
+// streaming operations on bitmap files [MappedBitBuffer format] that do not need to fit in memory
+// files are processed chunk by chunk through BitFileChunkReader using the regular BitSpan kernels,
+// results are bit identical to running the same operation on in-memory buffers
+// all functions return false if any file could not be read/written or the files differ in bit count
+namespace outofcore
+{
+
+enum class Op { Or, And, Xor };
+
+LIBRARY_PUBLIC bool countSetBits(const char* path, u64& result, const OutOfCoreOptions& options = {});
+
+// popcount of [input & filter] without producing a result file
+LIBRARY_PUBLIC bool countSetBitsAnd(const char* input, const char* filter, u64& result, const OutOfCoreOptions& options = {});
+
+// output = inputs[0] op inputs[1] op ... op inputs[numInputs - 1]
+// output must not be one of the inputs [compared by file identity, not by path], combine returns false without touching any file then
+LIBRARY_PUBLIC bool combine(Op op, const char* const* inputs, u32 numInputs, const char* output, const OutOfCoreOptions& options = {});
+
+}
+}
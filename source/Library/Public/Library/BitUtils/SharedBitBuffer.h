@@ -0,0 +1,115 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/AtomicBitWord.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <atomic>
+
+namespace ddahlkvist
+{
+
+// header placed first in every shared bitmap, word data follows directly after it
+// sequence is the seqlock of the single writer: odd while a write is in progress, bumped by two for every finished write
+struct LIBRARY_PUBLIC SharedBitHeader
+{
+	static constexpr u32 Magic = 0x53424444; // "DDBS"
+	static constexpr u16 CurrentVersion = 1;
+
+	u32 magic;
+	u16 version;
+	u16 wordSize;
+	u32 numBits;
+	u32 padding;
+	u64 numWords;
+	std::atomic<u64> sequence;
+	u8 reserved[32];
+
+	bool isCompatible() const;
+};
+static_assert(sizeof(SharedBitHeader) == 64);
+static_assert(std::atomic<u64>::is_always_lock_free, "sequence has to be address free to work across processes");
+
+// BitBuffer-like view of a named shared memory object [shm_open / CreateFileMapping] so that several processes
+// on the same host can read one mask without copying it through a pipe
+// two ways of writing:
+// - single writer: bits are changed between beginWrite/endWrite, readers use readSnapshot to get a consistent copy
+// - multiple writers: atomicSetBit/atomicClearBit, readers see every bit change immediately but no consistency across words
+class LIBRARY_PUBLIC SharedBitBuffer final
+{
+public:
+	enum class Access { ReadOnly, ReadWrite };
+
+	SharedBitBuffer() = default;
+	~SharedBitBuffer();
+
+	SharedBitBuffer(const SharedBitBuffer&) = delete;
+	SharedBitBuffer& operator=(const SharedBitBuffer&) = delete;
+	SharedBitBuffer(SharedBitBuffer&& other) noexcept;
+	SharedBitBuffer& operator=(SharedBitBuffer&& other) noexcept;
+
+	// name follows the posix shm rules [starts with '/', no further slashes], an existing object is truncated [posix] or reused [windows]
+	// object lives until unlink is called [posix] or until the last handle is closed [windows]
+	static SharedBitBuffer create(const char* name, u32 numBits);
+
+	// result is invalid if the object is missing or the header is incompatible
+	static SharedBitBuffer open(const char* name, Access access);
+
+	static bool unlink(const char* name);
+
+	inline bool isValid() const { return _header != nullptr; }
+	inline bool isWritable() const { return _access == Access::ReadWrite; }
+
+	inline u32 numBits() const { return _header ? _header->numBits : 0u; }
+	inline u32 size() const { return bitword::getNumBytesRequiredToRepresentWordBasedBitBuffer(numBits()); }
+	inline BitWordType* data() const { return _words; }
+
+	// number of finished writes, a reader can skip taking a new snapshot while it is unchanged
+	inline u64 generation() const { return _header->sequence.load(std::memory_order_acquire) / 2; }
+
+	// single writer protocol, span is only valid for writing between beginWrite and endWrite
+	void beginWrite();
+	void endWrite();
+
+	inline BitSpan span() const {
+		DD_ASSERT(isWritable());
+		return BitSpan(_words, numBits());
+	}
+
+	// unsynchronized view, only consistent when no writer is active
+	inline ConstBitSpan constSpan() const { return ConstBitSpan(_words, numBits()); }
+
+	// copies a consistent state into out [numBits bits] and returns its generation, retries while a write overlaps the copy
+	u64 readSnapshot(BitSpan& out) const;
+
+	// multi writer protocol, does not touch the sequence
+	inline bool atomicSetBit(u32 bit) {
+		DD_ASSERT(isWritable() && bit < numBits());
+		return bitword::atomicSetBit(_words, bit);
+	}
+
+	inline bool atomicClearBit(u32 bit) {
+		DD_ASSERT(isWritable() && bit < numBits());
+		return bitword::atomicClearBit(_words, bit);
+	}
+
+	inline bool atomicGetBit(u32 bit) const {
+		DD_ASSERT(bit < numBits());
+		return bitword::atomicGetBit(_words, bit);
+	}
+
+	void close();
+
+private:
+	SharedBitHeader* _header = nullptr;
+	BitWordType* _words = nullptr;
+	u64 _mappingSize = 0;
+	void* _handle = nullptr; // mapping object, only used on platforms where the name dies with the last handle
+	Access _access = Access::ReadOnly;
+};
+
+}
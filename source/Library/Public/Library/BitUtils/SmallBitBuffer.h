@@ -0,0 +1,138 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <cstring>
+#include <memory_resource>
+#include <utility>
+
+namespace ddahlkvist
+{
+
+// BitBuffer with inline storage for up to NumInlineWords words, larger sizes spill to the memory resource
+// inline storage keeps arrays of short masks contiguous and moving an inline buffer never allocates
+// data() points at whichever storage is active so spans see no extra indirection
+template<u32 NumInlineWords = 4>
+class SmallBitBuffer final
+{
+	static_assert(NumInlineWords > 0);
+
+public:
+	enum NoInitType { NoInit };
+	enum ZeroInitType { ZeroInit };
+	enum OneInitType { OneInit };
+
+	static constexpr u32 InlineCapacityBits = NumInlineWords * NumBitsInWord;
+	static constexpr usize Alignment = 64;
+
+	explicit SmallBitBuffer(NoInitType, u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: _numBits(numBits)
+		, _numWords(bitword::getNumWordsRequired(numBits))
+		, _resource(resource)
+	{
+		_data = isInline() ? _inline : static_cast<BitWordType*>(resource->allocate(size(), Alignment));
+	}
+
+	explicit SmallBitBuffer(ZeroInitType, u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: SmallBitBuffer(NoInit, numBits, resource)
+	{
+		memset(_data, bitword::Zero, size());
+	}
+
+	explicit SmallBitBuffer(OneInitType, u32 numBits, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: SmallBitBuffer(NoInit, numBits, resource)
+	{
+		memset(_data, ~0, size());
+	}
+
+	~SmallBitBuffer()
+	{
+		release();
+	}
+
+	SmallBitBuffer(const SmallBitBuffer& other)
+		: SmallBitBuffer(NoInit, other._numBits, other._resource)
+	{
+		memcpy(_data, other._data, size());
+	}
+
+	SmallBitBuffer& operator=(const SmallBitBuffer& other)
+	{
+		if (this != &other)
+		{
+			SmallBitBuffer copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	SmallBitBuffer(SmallBitBuffer&& other) noexcept
+		: _numBits(other._numBits)
+		, _numWords(other._numWords)
+		, _resource(other._resource)
+	{
+		takeStorage(other);
+	}
+
+	SmallBitBuffer& operator=(SmallBitBuffer&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			_numBits = other._numBits;
+			_numWords = other._numWords;
+			_resource = other._resource;
+			takeStorage(other);
+		}
+		return *this;
+	}
+
+	inline bool isInline() const { return _numWords <= NumInlineWords; }
+
+	inline u32 size() const { return _numWords * sizeof(BitWordType); }
+	inline u32 numBits() const { return _numBits; }
+	inline BitWordType* data() const { return _data; }
+
+	BitWordType* begin() const { return data(); }
+	BitWordType* end() const { return data() + _numWords; }
+
+	inline BitSpan span() const { return BitSpan(_data, _numBits); }
+	inline ConstBitSpan constSpan() const { return ConstBitSpan(_data, _numBits); }
+
+private:
+	inline void takeStorage(SmallBitBuffer& other)
+	{
+		if (other.isInline())
+		{
+			memcpy(_inline, other._inline, size());
+			_data = _inline;
+		}
+		else
+		{
+			_data = other._data;
+		}
+
+		other._numBits = 0;
+		other._numWords = 0;
+		other._data = other._inline;
+	}
+
+	inline void release()
+	{
+		if (!isInline())
+			_resource->deallocate(_data, size(), Alignment);
+	}
+
+	// inline words first so they get the object alignment, small masks live next to the members without a separate allocation
+	alignas(16) BitWordType _inline[NumInlineWords];
+	BitWordType* _data;
+	u32 _numBits;
+	u32 _numWords;
+	std::pmr::memory_resource* _resource;
+};
+
+}
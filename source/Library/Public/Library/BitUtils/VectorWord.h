@@ -0,0 +1,104 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+
+namespace ddahlkvist
+{
+
+// wide word for bulk kernels, NumLanes u64 lanes with bit i stored in lane i / 64
+// operators are plain fixed size lane loops which compilers turn into sse/avx/avx512 instructions,
+// used as word type for the Basic* bit utilities [ex BasicBitSpan<BitWord256>]
+template<u32 NumLanes>
+struct alignas(NumLanes * sizeof(u64)) VectorWord
+{
+	static_assert(NumLanes == 2 || NumLanes == 4 || NumLanes == 8);
+
+	u64 lanes[NumLanes];
+
+	// mask with the numBits lowest bits set
+	static constexpr VectorWord lowBits(u32 numBits)
+	{
+		VectorWord result{};
+		for (u32 i = 0; i < NumLanes; ++i)
+		{
+			const u32 laneBegin = i * 64;
+			if (numBits >= laneBegin + 64)
+				result.lanes[i] = ~0ull;
+			else if (numBits > laneBegin)
+				result.lanes[i] = (1ull << (numBits - laneBegin)) - 1;
+		}
+		return result;
+	}
+
+	constexpr VectorWord operator~() const
+	{
+		VectorWord result{};
+		for (u32 i = 0; i < NumLanes; ++i)
+			result.lanes[i] = ~lanes[i];
+		return result;
+	}
+
+	constexpr VectorWord& operator&=(const VectorWord& other)
+	{
+		for (u32 i = 0; i < NumLanes; ++i)
+			lanes[i] &= other.lanes[i];
+		return *this;
+	}
+
+	constexpr VectorWord& operator|=(const VectorWord& other)
+	{
+		for (u32 i = 0; i < NumLanes; ++i)
+			lanes[i] |= other.lanes[i];
+		return *this;
+	}
+
+	constexpr VectorWord& operator^=(const VectorWord& other)
+	{
+		for (u32 i = 0; i < NumLanes; ++i)
+			lanes[i] ^= other.lanes[i];
+		return *this;
+	}
+
+	constexpr VectorWord operator&(const VectorWord& other) const { VectorWord result = *this; result &= other; return result; }
+	constexpr VectorWord operator|(const VectorWord& other) const { VectorWord result = *this; result |= other; return result; }
+	constexpr VectorWord operator^(const VectorWord& other) const { VectorWord result = *this; result ^= other; return result; }
+
+	constexpr bool operator==(const VectorWord& other) const
+	{
+		u64 difference = 0;
+		for (u32 i = 0; i < NumLanes; ++i)
+			difference |= lanes[i] ^ other.lanes[i];
+		return difference == 0;
+	}
+
+	constexpr bool operator!=(const VectorWord& other) const { return !(*this == other); }
+
+	constexpr void setBit(u32 bit) { bitword::setBit(lanes[bit / 64], bit % 64); }
+	constexpr void clearBit(u32 bit) { bitword::clearBit(lanes[bit / 64], bit % 64); }
+	constexpr bool getBit(u32 bit) const { return bitword::getBit(lanes[bit / 64], bit % 64); }
+
+	inline u32 countSetBits() const
+	{
+		u32 counter = 0;
+		for (u32 i = 0; i < NumLanes; ++i)
+			counter += bitword::countSetBits(lanes[i]);
+		return counter;
+	}
+
+	template<class BitAction>
+	inline void foreachOne(BitAction& action, uint invokedBitIndexOffset) const
+	{
+		for (u32 i = 0; i < NumLanes; ++i)
+			bitword::foreachOne(action, lanes[i], invokedBitIndexOffset + i * 64);
+	}
+};
+
+using BitWord128 = VectorWord<2>;
+using BitWord256 = VectorWord<4>;
+using BitWord512 = VectorWord<8>;
+
+static_assert(sizeof(BitWord256) == 32);
+
+}
@@ -0,0 +1,14 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+// crc32c [castagnoli polynomial], uses the sse4.2 crc32 instruction when the target supports it
+// can be chained, pass the result of the previous call as crc to continue a running checksum
+LIBRARY_PUBLIC u32 crc32c(const void* data, usize numBytes, u32 crc = 0);
+
+}
@@ -0,0 +1,75 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+// compressed sparse row adjacency, edges of node i are targets[offsets[i] .. offsets[i + 1])
+// memory is owned by the caller
+struct CsrGraph
+{
+	const u32* offsets; // numNodes + 1 entries
+	const u32* targets;
+	u32 numNodes;
+
+	inline u32 numEdges() const { return offsets[numNodes]; }
+	inline u32 degree(u32 node) const { return offsets[node + 1] - offsets[node]; }
+};
+
+struct BfsOptions
+{
+	u32 alpha = 15; // go bottom-up when frontier edges > unexplored edges / alpha
+	u32 beta = 18; // go back top-down when the frontier shrinks below numNodes / beta
+	u32 numThreads = 0; // 0 uses every hardware thread
+	u32 minWordsPerThread = 256; // frontier words [64 nodes each] per thread and level
+};
+
+// breadth first search where frontier, next frontier and visited are bit ranges [Beamer et al, direction optimizing bfs]
+// top-down steps expand frontier nodes and claim neighbors with atomic bit updates,
+// bottom-up steps let every unvisited node look for a parent in the frontier and stop at the first hit,
+// which wins on the large middle levels of scale-free graphs where most edges would hit visited nodes anyway
+// the direction is picked per level from frontier popcount and edge counts
+class LIBRARY_PUBLIC DirectionOptimizingBfs final
+{
+public:
+	static constexpr u32 Unreached = ~0u;
+
+	// incoming is the transposed graph used by bottom-up steps, pass the same graph twice for undirected graphs
+	DirectionOptimizingBfs(const CsrGraph& outgoing, const CsrGraph& incoming, const BfsOptions& options = {});
+
+	// depths[node] = number of edges from source or Unreached, depths must hold numNodes entries
+	// returns number of reached nodes [including source]
+	u32 run(u32 source, u32* depths);
+
+	inline ConstBitSpan visited() const { return _visited.constSpan(); }
+	inline u32 numTopDownSteps() const { return _numTopDownSteps; }
+	inline u32 numBottomUpSteps() const { return _numBottomUpSteps; }
+
+private:
+	struct StepResult
+	{
+		u64 numEdges = 0; // sum of degrees of the nodes added to next
+	};
+
+	StepResult topDownStep(u32 depth, u32* depths);
+	StepResult bottomUpStep(u32 depth, u32* depths);
+
+	CsrGraph _outgoing;
+	CsrGraph _incoming;
+	BfsOptions _options;
+
+	BitBuffer _frontier;
+	BitBuffer _next;
+	BitBuffer _visited;
+
+	u32 _numTopDownSteps = 0;
+	u32 _numBottomUpSteps = 0;
+};
+
+}
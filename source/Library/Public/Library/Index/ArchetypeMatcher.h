@@ -0,0 +1,80 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitWord.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// has every 'all' component AND (at least one 'any' component, when there are any) AND no 'none' component
+struct ArchetypeQuery
+{
+	std::vector<u32> all;
+	std::vector<u32> any;
+	std::vector<u32> none;
+};
+
+// matches ecs queries against archetype signatures [one component bit per archetype]
+// signatures are packed back to back, a query is compiled into require/any/exclude masks once
+// and evaluated several signatures per vector instruction when a signature fits in one word [avx512/avx2 and, andnot and test]
+// archetypes are only ever added, so the matches of a query are cached and extended with the archetypes added since the last call
+class LIBRARY_PUBLIC ArchetypeMatcher final
+{
+public:
+	using QueryId = u32;
+
+	explicit ArchetypeMatcher(u32 numComponents);
+
+	inline u32 numComponents() const { return _numComponents; }
+	inline u32 numArchetypes() const { return _numArchetypes; }
+	inline u32 numQueries() const { return static_cast<u32>(_queries.size()); }
+
+	inline ConstBitSpan signature(u32 archetype) const
+	{
+		DD_ASSERT(archetype < _numArchetypes);
+		return ConstBitSpan(_signatures.data() + static_cast<usize>(archetype) * _wordsPerSignature, _numComponents);
+	}
+
+	// signature has numComponents bits, returns the archetype index [archetypes are numbered in insertion order]
+	u32 addArchetype(const ConstBitSpan& signature);
+	u32 addArchetype(const u32* components, u32 numComponents);
+
+	QueryId addQuery(const ArchetypeQuery& query);
+
+	// indices of the archetypes matching the query in increasing order, only archetypes added since the previous call are evaluated
+	// the reference stays valid until the next call that adds archetypes or queries
+	const std::vector<u32>& matches(QueryId query);
+
+	// evaluates the query without caching, writes matching archetypes in increasing order and returns how many
+	// archetypes must hold numArchetypes() entries
+	u32 evaluate(const ArchetypeQuery& query, u32* archetypes) const;
+
+private:
+	struct Query
+	{
+		u32 firstMaskWord; // require, any and exclude masks back to back in _queryMasks
+		bool hasAny;
+		u32 numEvaluated = 0;
+		std::vector<u32> matches;
+	};
+
+	void compile(const ArchetypeQuery& query, BitWordType* masks) const;
+
+	// calls sink(archetype) for the matching archetypes of [begin, end) in order, masks are require, any, exclude
+	template<typename Sink>
+	void evaluateRange(const BitWordType* masks, bool hasAny, u32 begin, u32 end, Sink&& sink) const;
+
+	std::vector<BitWordType> _signatures;
+	std::vector<BitWordType> _queryMasks;
+	std::vector<Query> _queries;
+	u32 _numComponents;
+	u32 _wordsPerSignature;
+	u32 _numArchetypes = 0;
+};
+
+}
@@ -0,0 +1,55 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitVector.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// unsigned integer column stored as bit slices, slice i holds bit i of the value of every row
+// comparisons, sums and top-k run on whole words of 64 rows at a time without decoding any value
+// [O'Neil & Quass, improved query performance with variant indexes]
+class LIBRARY_PUBLIC BitSlicedIndex final
+{
+public:
+	enum class Compare { Less, LessOrEqual, Equal, NotEqual, GreaterOrEqual, Greater };
+
+	// values must be below 2^numSlices, at most 64 slices
+	explicit BitSlicedIndex(u32 numSlices, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	inline u32 numRows() const { return _numRows; }
+	inline u32 numSlices() const { return static_cast<u32>(_slices.size()); }
+	inline ConstBitSpan slice(u32 index) const { return _slices[index].constSpan(); }
+
+	void append(u64 value);
+	void append(const u64* values, u32 numValues);
+
+	u64 getValue(u32 row) const;
+
+	// result[row] = value(row) op constant, result must hold numRows() bits
+	// single pass from the most significant slice, every word of the result is finished before the next is started
+	void compare(Compare op, u64 constant, BitSpan& result) const;
+
+	// sum of the values of all rows / of the rows set in filter, weighted popcounts of every slice
+	u64 sum() const;
+	u64 sum(const ConstBitSpan& filter) const;
+
+	// result = the k rows with the largest values [among the rows set in filter], ties go to the lowest rows
+	// walks the slices from the most significant one and keeps a set of sure rows and a set of candidates
+	void topK(u32 k, BitSpan& result) const;
+	void topK(u32 k, const ConstBitSpan& filter, BitSpan& result) const;
+
+private:
+	std::vector<BitVector> _slices;
+	std::pmr::memory_resource* _resource;
+	u32 _numRows = 0;
+};
+
+}
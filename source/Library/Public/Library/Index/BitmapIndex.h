@@ -0,0 +1,55 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/BitVector.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// bitmap index over an integer column with values in [0, cardinality), one bit per row in every bitmap
+// Equality: bitmap v holds the rows where value == v, cheap appends, ranges are an OR over the values in range
+// Range: bitmap v holds the rows where value <= v, any range is at most two bitmaps, appends touch cardinality - value bitmaps
+// bitmaps grow with the column [BitVector], predicates write one result bit per row into a caller provided span
+class LIBRARY_PUBLIC BitmapIndex final
+{
+public:
+	enum class Encoding { Equality, Range };
+
+	BitmapIndex(u32 cardinality, Encoding encoding, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	inline u32 numRows() const { return _numRows; }
+	inline u32 cardinality() const { return _cardinality; }
+	inline Encoding encoding() const { return _encoding; }
+
+	// number of stored bitmaps, range encoding leaves out the last one since it would have every bit set
+	inline u32 numBitmaps() const { return static_cast<u32>(_bitmaps.size()); }
+	inline ConstBitSpan bitmap(u32 index) const { return _bitmaps[index].constSpan(); }
+
+	void append(u32 value);
+	void append(const u32* values, u32 numValues);
+
+	// result must hold numRows() bits
+	void equals(u32 value, BitSpan& result) const;
+	void lessOrEqual(u32 value, BitSpan& result) const;
+	void greaterOrEqual(u32 value, BitSpan& result) const;
+	void between(u32 low, u32 high, BitSpan& result) const; // inclusive
+
+private:
+	void copyBitmap(u32 index, BitSpan& result) const;
+	void orBitmaps(u32 first, u32 last, BitSpan& result) const; // [first, last)
+	void xorBitmap(u32 index, BitSpan& result) const;
+
+	std::vector<BitVector> _bitmaps;
+	u32 _cardinality;
+	u32 _numRows = 0;
+	Encoding _encoding;
+};
+
+}
@@ -0,0 +1,72 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/BitUtils/BitBuffer.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// all tags AND (any tag of every group) AND NOT (any none tag)
+struct TagQuery
+{
+	std::vector<u32> all;
+	std::vector<std::vector<u32>> any;
+	std::vector<u32> none;
+};
+
+// inverted index from tag to the items carrying it, items are [0, numItems)
+// each tag is stored as a bitmap when dense or as a sorted item list when the list is smaller than the bitmap
+// queries are planned by tag cardinality:
+// - a sparse smallest 'all' tag drives the query, its items are probed against the other tags
+// - otherwise every operand is combined per block of words in one fused pass, a block stops as soon as it becomes empty
+// results come out in item order so a limit ends the evaluation early
+class LIBRARY_PUBLIC InvertedIndex final
+{
+public:
+	InvertedIndex(u32 numItems, u32 numTags, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	inline u32 numItems() const { return _numItems; }
+	inline u32 numTags() const { return static_cast<u32>(_postings.size()); }
+	inline u32 cardinality(u32 tag) const { return _postings[tag].cardinality; }
+	inline bool isDense(u32 tag) const { return _postings[tag].dense.numBits() != 0; }
+
+	// replaces the items of tag, representation is picked from the cardinality
+	void setTag(u32 tag, const u32* sortedItems, u32 numItems);
+	void setTag(u32 tag, const ConstBitSpan& items);
+
+	// result must hold numItems() bits, returns number of matching items
+	u32 evaluate(const TagQuery& query, BitSpan& result) const;
+
+	// writes the first [lowest] at most limit matching items, returns number written
+	u32 evaluate(const TagQuery& query, u32* items, u32 limit) const;
+
+private:
+	struct Posting
+	{
+		BitBuffer dense;
+		std::vector<u32> sparse;
+		u32 cardinality = 0;
+	};
+
+	struct Operand;
+	struct Plan;
+
+	Plan makePlan(const TagQuery& query) const;
+
+	// itemSink(item) and wordSink(firstWord, words, numWords) return false to stop the evaluation
+	template<typename ItemSink, typename WordSink>
+	void execute(const Plan& plan, ItemSink&& itemSink, WordSink&& wordSink) const;
+
+	std::vector<Posting> _postings;
+	std::pmr::memory_resource* _resource;
+	u32 _numItems;
+};
+
+}
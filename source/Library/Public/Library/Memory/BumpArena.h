@@ -0,0 +1,54 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+#include <vector>
+
+namespace ddahlkvist
+{
+
+// bump allocator intended for short lived allocations [ex per frame temporary masks]
+// deallocate is a no-op, all memory is reclaimed at once by reset() which keeps the blocks for reuse
+// not thread safe
+class LIBRARY_PUBLIC BumpArena final : public std::pmr::memory_resource
+{
+public:
+	explicit BumpArena(usize blockSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+	~BumpArena() override;
+
+	BumpArena(const BumpArena&) = delete;
+	BumpArena& operator=(const BumpArena&) = delete;
+
+	// makes all memory available again, every allocation made before becomes invalid
+	void reset();
+
+	inline usize bytesAllocated() const { return _bytesAllocated; }
+	inline usize capacity() const { return _capacity; }
+
+protected:
+	void* do_allocate(std::size_t numBytes, std::size_t alignment) override;
+	void do_deallocate(void* p, std::size_t numBytes, std::size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+	struct Block
+	{
+		u8* data;
+		usize size;
+	};
+
+	bool tryAllocateFrom(usize blockIndex, usize numBytes, usize alignment, void*& result);
+
+	std::pmr::memory_resource* _upstream;
+	std::vector<Block> _blocks;
+	usize _blockSize;
+	usize _currentBlock = 0;
+	usize _offset = 0;
+	usize _bytesAllocated = 0;
+	usize _capacity = 0;
+};
+
+}
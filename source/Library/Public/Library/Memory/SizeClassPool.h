@@ -0,0 +1,51 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Platform.h>
+#include <Core/Types.h>
+#include <Library/library_module.h>
+#include <memory_resource>
+
+namespace ddahlkvist
+{
+
+// recycles allocations through free lists of power of two size classes [64 bytes .. MaxPooledSize]
+// released memory is kept for the next allocation of the same class instead of going back upstream
+// larger requests are forwarded to upstream directly, not thread safe
+class LIBRARY_PUBLIC SizeClassPool final : public std::pmr::memory_resource
+{
+public:
+	static constexpr usize MinClassSize = 64;
+	static constexpr u32 NumClasses = 15;
+	static constexpr usize MaxPooledSize = MinClassSize << (NumClasses - 1); // 1mb
+
+	explicit SizeClassPool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+	~SizeClassPool() override;
+
+	SizeClassPool(const SizeClassPool&) = delete;
+	SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+	// returns all free listed memory to upstream
+	void trim();
+
+	inline usize numPooled() const { return _numPooled; }
+
+	static u32 getSizeClass(usize numBytes);
+
+protected:
+	void* do_allocate(std::size_t numBytes, std::size_t alignment) override;
+	void do_deallocate(void* p, std::size_t numBytes, std::size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+	struct FreeNode
+	{
+		FreeNode* next;
+	};
+
+	std::pmr::memory_resource* _upstream;
+	FreeNode* _freeLists[NumClasses] = {};
+	usize _numPooled = 0;
+};
+
+}
@@ -0,0 +1,46 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/BitSpan.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+// comparisons of a column of numbers against constants, one result bit per value written straight into a BitSpan
+// number of values is result.numBits(), values are compared 64 at a time and every result word is written once
+// [avx512 mask compares or avx2 compare + movemask when the build targets them, plain loops otherwise]
+// Combine::And merges into an existing selection in the same pass instead of producing a separate mask
+// floating point compares are ordered, NaN only matches NotEqual
+namespace predicate
+{
+
+enum class Compare { Equal, NotEqual, Less, LessOrEqual, Greater, GreaterOrEqual };
+enum class Combine { Replace, And };
+
+LIBRARY_PUBLIC void compare(const u8* values, Compare op, u8 constant, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void compare(const u16* values, Compare op, u16 constant, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void compare(const u32* values, Compare op, u32 constant, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void compare(const u64* values, Compare op, u64 constant, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void compare(const float* values, Compare op, float constant, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void compare(const double* values, Compare op, double constant, BitSpan& result, Combine combine = Combine::Replace);
+
+// low <= value && value <= high
+LIBRARY_PUBLIC void between(const u8* values, u8 low, u8 high, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void between(const u16* values, u16 low, u16 high, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void between(const u32* values, u32 low, u32 high, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void between(const u64* values, u64 low, u64 high, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void between(const float* values, float low, float high, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void between(const double* values, double low, double high, BitSpan& result, Combine combine = Combine::Replace);
+
+// value equals any of the set values, meant for small sets [one compare per set value and vector]
+LIBRARY_PUBLIC void inSet(const u8* values, const u8* set, u32 setSize, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void inSet(const u16* values, const u16* set, u32 setSize, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void inSet(const u32* values, const u32* set, u32 setSize, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void inSet(const u64* values, const u64* set, u32 setSize, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void inSet(const float* values, const float* set, u32 setSize, BitSpan& result, Combine combine = Combine::Replace);
+LIBRARY_PUBLIC void inSet(const double* values, const double* set, u32 setSize, BitSpan& result, Combine combine = Combine::Replace);
+
+}
+}
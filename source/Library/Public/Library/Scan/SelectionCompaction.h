@@ -0,0 +1,38 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#pragma once
+
+#include <Core/Types.h>
+#include <Library/BitUtils/ConstBitSpan.h>
+#include <Library/library_module.h>
+
+namespace ddahlkvist
+{
+
+// compaction of arrays to the rows selected by a BitSpan [the counterpart of the predicate namespace]
+// values[i] is written to out for every set bit i in order, number of values is selection.numBits()
+// returns the number of values written, out needs room for selection.countSetBits() values and nothing is written past them
+// empty selection words are skipped and full words are copied as a block
+// [avx512 compress stores or avx2 permutes from a shuffle table when the build targets them, a set bit loop otherwise]
+namespace selection
+{
+
+LIBRARY_PUBLIC u32 compact(const ConstBitSpan& selection, const u8* values, u8* out);
+LIBRARY_PUBLIC u32 compact(const ConstBitSpan& selection, const u16* values, u16* out);
+LIBRARY_PUBLIC u32 compact(const ConstBitSpan& selection, const u32* values, u32* out);
+LIBRARY_PUBLIC u32 compact(const ConstBitSpan& selection, const u64* values, u64* out);
+LIBRARY_PUBLIC u32 compact(const ConstBitSpan& selection, const float* values, float* out);
+LIBRARY_PUBLIC u32 compact(const ConstBitSpan& selection, const double* values, double* out);
+
+// one column of a compactColumns call, valueSize is 1, 2, 4 or 8 bytes
+struct Column
+{
+	const void* values;
+	void* out;
+	u32 valueSize;
+};
+
+// compacts several columns with the same selection in one pass, every selection word is loaded and decoded once for all columns
+LIBRARY_PUBLIC u32 compactColumns(const ConstBitSpan& selection, const Column* columns, u32 numColumns);
+
+}
+}
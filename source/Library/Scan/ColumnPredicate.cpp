@@ -0,0 +1,350 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Scan/ColumnPredicate.h>
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#define DD_PREDICATE_AVX512 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define DD_PREDICATE_AVX2 1
+#endif
+
+namespace ddahlkvist
+{
+namespace predicate
+{
+namespace
+{
+
+// Lanes<T> compares Count values at a time and returns one bit per value [bit i = value i]
+// less/lessOrEqual/equal are the primitives, every Compare is expressed through them
+
+template<typename T>
+struct ScalarLanes
+{
+	using Vector = T;
+	static constexpr u32 Count = 1;
+
+	static inline Vector load(const T* values) { return *values; }
+	static inline Vector broadcast(T value) { return value; }
+	static inline u64 equal(Vector a, Vector b) { return a == b; }
+	static inline u64 less(Vector a, Vector b) { return a < b; }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return a <= b; }
+};
+
+#if defined(DD_PREDICATE_AVX512)
+
+template<typename T>
+struct Lanes;
+
+template<>
+struct Lanes<u8>
+{
+	using Vector = __m512i;
+	static constexpr u32 Count = 64;
+	static inline Vector load(const u8* values) { return _mm512_loadu_si512(values); }
+	static inline Vector broadcast(u8 value) { return _mm512_set1_epi8(static_cast<char>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return _mm512_cmpeq_epu8_mask(a, b); }
+	static inline u64 less(Vector a, Vector b) { return _mm512_cmplt_epu8_mask(a, b); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return _mm512_cmple_epu8_mask(a, b); }
+};
+
+template<>
+struct Lanes<u16>
+{
+	using Vector = __m512i;
+	static constexpr u32 Count = 32;
+	static inline Vector load(const u16* values) { return _mm512_loadu_si512(values); }
+	static inline Vector broadcast(u16 value) { return _mm512_set1_epi16(static_cast<short>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return _mm512_cmpeq_epu16_mask(a, b); }
+	static inline u64 less(Vector a, Vector b) { return _mm512_cmplt_epu16_mask(a, b); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return _mm512_cmple_epu16_mask(a, b); }
+};
+
+template<>
+struct Lanes<u32>
+{
+	using Vector = __m512i;
+	static constexpr u32 Count = 16;
+	static inline Vector load(const u32* values) { return _mm512_loadu_si512(values); }
+	static inline Vector broadcast(u32 value) { return _mm512_set1_epi32(static_cast<int>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return _mm512_cmpeq_epu32_mask(a, b); }
+	static inline u64 less(Vector a, Vector b) { return _mm512_cmplt_epu32_mask(a, b); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return _mm512_cmple_epu32_mask(a, b); }
+};
+
+template<>
+struct Lanes<u64>
+{
+	using Vector = __m512i;
+	static constexpr u32 Count = 8;
+	static inline Vector load(const u64* values) { return _mm512_loadu_si512(values); }
+	static inline Vector broadcast(u64 value) { return _mm512_set1_epi64(static_cast<long long>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return _mm512_cmpeq_epu64_mask(a, b); }
+	static inline u64 less(Vector a, Vector b) { return _mm512_cmplt_epu64_mask(a, b); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return _mm512_cmple_epu64_mask(a, b); }
+};
+
+template<>
+struct Lanes<float>
+{
+	using Vector = __m512;
+	static constexpr u32 Count = 16;
+	static inline Vector load(const float* values) { return _mm512_loadu_ps(values); }
+	static inline Vector broadcast(float value) { return _mm512_set1_ps(value); }
+	static inline u64 equal(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+	static inline u64 less(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+};
+
+template<>
+struct Lanes<double>
+{
+	using Vector = __m512d;
+	static constexpr u32 Count = 8;
+	static inline Vector load(const double* values) { return _mm512_loadu_pd(values); }
+	static inline Vector broadcast(double value) { return _mm512_set1_pd(value); }
+	static inline u64 equal(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+	static inline u64 less(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+};
+
+#elif defined(DD_PREDICATE_AVX2)
+
+// avx2 has no unsigned compares, a >= b is max(a, b) == a [u8/u16/u32] or a signed compare with flipped sign bits [u64]
+inline u64 byteMask(__m256i lanes) { return static_cast<u32>(_mm256_movemask_epi8(lanes)); }
+inline u64 floatMask(__m256i lanes) { return static_cast<u32>(_mm256_movemask_ps(_mm256_castsi256_ps(lanes))); }
+inline u64 doubleMask(__m256i lanes) { return static_cast<u32>(_mm256_movemask_pd(_mm256_castsi256_pd(lanes))); }
+
+template<typename T>
+struct Lanes;
+
+template<>
+struct Lanes<u8>
+{
+	using Vector = __m256i;
+	static constexpr u32 Count = 32;
+	static constexpr u64 AllLanes = 0xFFFFFFFFull;
+	static inline Vector load(const u8* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+	static inline Vector broadcast(u8 value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return byteMask(_mm256_cmpeq_epi8(a, b)); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return byteMask(_mm256_cmpeq_epi8(_mm256_max_epu8(a, b), b)); }
+	static inline u64 less(Vector a, Vector b) { return ~lessOrEqual(b, a) & AllLanes; }
+};
+
+// two registers per vector so that the 16 bit lane masks can be packed into one byte mask of 32 values
+struct U16Pair
+{
+	__m256i low;
+	__m256i high;
+};
+
+template<>
+struct Lanes<u16>
+{
+	using Vector = U16Pair;
+	static constexpr u32 Count = 32;
+	static constexpr u64 AllLanes = 0xFFFFFFFFull;
+
+	static inline u64 pack(__m256i low, __m256i high)
+	{
+		// packs interleaves 128 bit halves, the permute restores value order
+		return byteMask(_mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0xD8));
+	}
+
+	static inline Vector load(const u16* values)
+	{
+		return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 16)) };
+	}
+
+	static inline Vector broadcast(u16 value)
+	{
+		const __m256i lanes = _mm256_set1_epi16(static_cast<short>(value));
+		return { lanes, lanes };
+	}
+
+	static inline u64 equal(Vector a, Vector b) { return pack(_mm256_cmpeq_epi16(a.low, b.low), _mm256_cmpeq_epi16(a.high, b.high)); }
+
+	static inline u64 lessOrEqual(Vector a, Vector b)
+	{
+		return pack(_mm256_cmpeq_epi16(_mm256_max_epu16(a.low, b.low), b.low), _mm256_cmpeq_epi16(_mm256_max_epu16(a.high, b.high), b.high));
+	}
+
+	static inline u64 less(Vector a, Vector b) { return ~lessOrEqual(b, a) & AllLanes; }
+};
+
+template<>
+struct Lanes<u32>
+{
+	using Vector = __m256i;
+	static constexpr u32 Count = 8;
+	static constexpr u64 AllLanes = 0xFFull;
+	static inline Vector load(const u32* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+	static inline Vector broadcast(u32 value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return floatMask(_mm256_cmpeq_epi32(a, b)); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return floatMask(_mm256_cmpeq_epi32(_mm256_max_epu32(a, b), b)); }
+	static inline u64 less(Vector a, Vector b) { return ~lessOrEqual(b, a) & AllLanes; }
+};
+
+template<>
+struct Lanes<u64>
+{
+	using Vector = __m256i;
+	static constexpr u32 Count = 4;
+	static constexpr u64 AllLanes = 0xFull;
+
+	static inline __m256i flipSign(__m256i lanes) { return _mm256_xor_si256(lanes, _mm256_set1_epi64x(static_cast<long long>(1ull << 63))); }
+
+	static inline Vector load(const u64* values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)); }
+	static inline Vector broadcast(u64 value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+	static inline u64 equal(Vector a, Vector b) { return doubleMask(_mm256_cmpeq_epi64(a, b)); }
+	static inline u64 less(Vector a, Vector b) { return doubleMask(_mm256_cmpgt_epi64(flipSign(b), flipSign(a))); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return ~less(b, a) & AllLanes; }
+};
+
+template<>
+struct Lanes<float>
+{
+	using Vector = __m256;
+	static constexpr u32 Count = 8;
+	static inline Vector load(const float* values) { return _mm256_loadu_ps(values); }
+	static inline Vector broadcast(float value) { return _mm256_set1_ps(value); }
+	static inline u64 equal(Vector a, Vector b) { return static_cast<u32>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+	static inline u64 less(Vector a, Vector b) { return static_cast<u32>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ))); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return static_cast<u32>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ))); }
+};
+
+template<>
+struct Lanes<double>
+{
+	using Vector = __m256d;
+	static constexpr u32 Count = 4;
+	static inline Vector load(const double* values) { return _mm256_loadu_pd(values); }
+	static inline Vector broadcast(double value) { return _mm256_set1_pd(value); }
+	static inline u64 equal(Vector a, Vector b) { return static_cast<u32>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+	static inline u64 less(Vector a, Vector b) { return static_cast<u32>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ))); }
+	static inline u64 lessOrEqual(Vector a, Vector b) { return static_cast<u32>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ))); }
+};
+
+#else
+
+template<typename T>
+struct Lanes : ScalarLanes<T>
+{
+};
+
+#endif
+
+// predicate is a generic lambda taking the lane type, called with Lanes<T> for whole words and ScalarLanes<T> for the tail
+template<typename T, typename Predicate>
+void evaluate(const T* values, BitSpan& result, Combine combine, Predicate&& predicate)
+{
+	using VectorLanes = Lanes<T>;
+	static_assert(NumBitsInWord % VectorLanes::Count == 0);
+
+	const u32 numValues = result.numBits();
+	const u32 numFullWords = numValues / NumBitsInWord;
+	BitWordType* out = result.data();
+
+	for (u32 word = 0; word < numFullWords; ++word)
+	{
+		const T* it = values + word * NumBitsInWord;
+		BitWordType bits = bitword::Zero;
+
+		for (u32 i = 0; i < NumBitsInWord; i += VectorLanes::Count)
+			bits |= static_cast<BitWordType>(predicate(VectorLanes{}, VectorLanes::load(it + i))) << i;
+
+		out[word] = combine == Combine::And ? out[word] & bits : bits;
+	}
+
+	if (!bitword::hasDanglingPart(numValues))
+		return;
+
+	// bits above numValues stay zero which also clears any dangling bits of an And selection
+	const T* it = values + numFullWords * NumBitsInWord;
+	BitWordType bits = bitword::Zero;
+	for (u32 i = 0; i < numValues % NumBitsInWord; ++i)
+		bits |= static_cast<BitWordType>(predicate(ScalarLanes<T>{}, ScalarLanes<T>::load(it + i))) << i;
+
+	out[numFullWords] = combine == Combine::And ? out[numFullWords] & bits : bits;
+}
+
+template<typename T>
+void compareImpl(const T* values, Compare op, T constant, BitSpan& result, Combine combine)
+{
+	// lane masks are always built from less/lessOrEqual/equal, NotEqual complements within the lane count
+	auto run = [&](auto&& predicate) { evaluate(values, result, combine, predicate); };
+
+	switch (op)
+	{
+	case Compare::Equal:
+		run([constant](auto lanes, auto value) { return decltype(lanes)::equal(value, decltype(lanes)::broadcast(constant)); });
+		break;
+	case Compare::NotEqual:
+		run([constant](auto lanes, auto value) {
+			using L = decltype(lanes);
+			const u64 allLanes = L::Count == 64 ? ~0ull : (1ull << L::Count) - 1;
+			return ~L::equal(value, L::broadcast(constant)) & allLanes;
+		});
+		break;
+	case Compare::Less:
+		run([constant](auto lanes, auto value) { return decltype(lanes)::less(value, decltype(lanes)::broadcast(constant)); });
+		break;
+	case Compare::LessOrEqual:
+		run([constant](auto lanes, auto value) { return decltype(lanes)::lessOrEqual(value, decltype(lanes)::broadcast(constant)); });
+		break;
+	case Compare::Greater:
+		run([constant](auto lanes, auto value) { return decltype(lanes)::less(decltype(lanes)::broadcast(constant), value); });
+		break;
+	case Compare::GreaterOrEqual:
+		run([constant](auto lanes, auto value) { return decltype(lanes)::lessOrEqual(decltype(lanes)::broadcast(constant), value); });
+		break;
+	}
+}
+
+template<typename T>
+void betweenImpl(const T* values, T low, T high, BitSpan& result, Combine combine)
+{
+	evaluate(values, result, combine, [low, high](auto lanes, auto value) {
+		using L = decltype(lanes);
+		return L::lessOrEqual(L::broadcast(low), value) & L::lessOrEqual(value, L::broadcast(high));
+	});
+}
+
+template<typename T>
+void inSetImpl(const T* values, const T* set, u32 setSize, BitSpan& result, Combine combine)
+{
+	evaluate(values, result, combine, [set, setSize](auto lanes, auto value) {
+		using L = decltype(lanes);
+		u64 bits = 0;
+		for (u32 i = 0; i < setSize; ++i)
+			bits |= L::equal(value, L::broadcast(set[i]));
+		return bits;
+	});
+}
+
+}
+
+void compare(const u8* values, Compare op, u8 constant, BitSpan& result, Combine combine) { compareImpl(values, op, constant, result, combine); }
+void compare(const u16* values, Compare op, u16 constant, BitSpan& result, Combine combine) { compareImpl(values, op, constant, result, combine); }
+void compare(const u32* values, Compare op, u32 constant, BitSpan& result, Combine combine) { compareImpl(values, op, constant, result, combine); }
+void compare(const u64* values, Compare op, u64 constant, BitSpan& result, Combine combine) { compareImpl(values, op, constant, result, combine); }
+void compare(const float* values, Compare op, float constant, BitSpan& result, Combine combine) { compareImpl(values, op, constant, result, combine); }
+void compare(const double* values, Compare op, double constant, BitSpan& result, Combine combine) { compareImpl(values, op, constant, result, combine); }
+
+void between(const u8* values, u8 low, u8 high, BitSpan& result, Combine combine) { betweenImpl(values, low, high, result, combine); }
+void between(const u16* values, u16 low, u16 high, BitSpan& result, Combine combine) { betweenImpl(values, low, high, result, combine); }
+void between(const u32* values, u32 low, u32 high, BitSpan& result, Combine combine) { betweenImpl(values, low, high, result, combine); }
+void between(const u64* values, u64 low, u64 high, BitSpan& result, Combine combine) { betweenImpl(values, low, high, result, combine); }
+void between(const float* values, float low, float high, BitSpan& result, Combine combine) { betweenImpl(values, low, high, result, combine); }
+void between(const double* values, double low, double high, BitSpan& result, Combine combine) { betweenImpl(values, low, high, result, combine); }
+
+void inSet(const u8* values, const u8* set, u32 setSize, BitSpan& result, Combine combine) { inSetImpl(values, set, setSize, result, combine); }
+void inSet(const u16* values, const u16* set, u32 setSize, BitSpan& result, Combine combine) { inSetImpl(values, set, setSize, result, combine); }
+void inSet(const u32* values, const u32* set, u32 setSize, BitSpan& result, Combine combine) { inSetImpl(values, set, setSize, result, combine); }
+void inSet(const u64* values, const u64* set, u32 setSize, BitSpan& result, Combine combine) { inSetImpl(values, set, setSize, result, combine); }
+void inSet(const float* values, const float* set, u32 setSize, BitSpan& result, Combine combine) { inSetImpl(values, set, setSize, result, combine); }
+void inSet(const double* values, const double* set, u32 setSize, BitSpan& result, Combine combine) { inSetImpl(values, set, setSize, result, combine); }
+
+}
+}
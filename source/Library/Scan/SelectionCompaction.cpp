@@ -0,0 +1,394 @@
+// copyright Daniel Dahlkvist (c) 2020 [github.com/messer1024]
+#include <Library/Scan/SelectionCompaction.h>
+
+#include <cstring>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define DD_COMPACTION_AVX512 1
+#if defined(__AVX512VBMI2__)
+#define DD_COMPACTION_AVX512_VBMI2 1
+#endif
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define DD_COMPACTION_AVX2 1
+#endif
+
+namespace ddahlkvist
+{
+namespace selection
+{
+namespace
+{
+
+// positions of the set bits of one selection word, decoded once and shared by every column that gathers through it
+struct DecodedWord
+{
+	u8 indices[NumBitsInWord];
+	u32 count;
+};
+
+void decode(BitWordType mask, DecodedWord& decoded)
+{
+	decoded.count = bitword::countSetBits(mask);
+
+#if defined(DD_COMPACTION_AVX512_VBMI2)
+	alignas(64) static const u8 positions[NumBitsInWord] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63 };
+	_mm512_mask_compressstoreu_epi8(decoded.indices, mask, _mm512_load_si512(positions));
+#else
+	u8* it = decoded.indices;
+	while (mask != bitword::Zero)
+	{
+		*it++ = static_cast<u8>(bitword::getLowestSetBit(mask));
+		mask &= mask - 1;
+	}
+#endif
+}
+
+template<typename T>
+inline T* gather(const DecodedWord& decoded, const T* in, T* out)
+{
+	for (u32 i = 0; i < decoded.count; ++i)
+		out[i] = in[decoded.indices[i]];
+
+	return out + decoded.count;
+}
+
+template<typename T>
+inline T* compactScalar(BitWordType mask, const T* in, T* out)
+{
+	while (mask != bitword::Zero)
+	{
+		*out++ = in[bitword::getLowestSetBit(mask)];
+		mask &= mask - 1;
+	}
+	return out;
+}
+
+// Compress<T> compacts the 64 values of one partially selected word straight from the mask
+// Native is false when there is no vector compress for the value size, those go through compactScalar/gather instead
+// Bounded compresses store whole vectors and need the end of the output so that the last stores stay inside it
+template<typename T>
+struct Compress
+{
+	static constexpr bool Native = false;
+	static constexpr bool Bounded = false;
+	static inline T* word(BitWordType mask, const T* in, T* out, const T* /*outEnd*/) { return compactScalar(mask, in, out); }
+};
+
+#if defined(DD_COMPACTION_AVX512)
+
+template<>
+struct Compress<u32>
+{
+	static constexpr bool Native = true;
+	static constexpr bool Bounded = false;
+
+	static inline u32* word(BitWordType mask, const u32* in, u32* out, const u32* /*outEnd*/)
+	{
+		for (u32 i = 0; i < NumBitsInWord; i += 16)
+		{
+			const __mmask16 lanes = static_cast<__mmask16>(mask >> i);
+			_mm512_mask_compressstoreu_epi32(out, lanes, _mm512_loadu_si512(in + i));
+			out += bitword::countSetBits(static_cast<u16>(lanes));
+		}
+		return out;
+	}
+};
+
+template<>
+struct Compress<u64>
+{
+	static constexpr bool Native = true;
+	static constexpr bool Bounded = false;
+
+	static inline u64* word(BitWordType mask, const u64* in, u64* out, const u64* /*outEnd*/)
+	{
+		for (u32 i = 0; i < NumBitsInWord; i += 8)
+		{
+			const __mmask8 lanes = static_cast<__mmask8>(mask >> i);
+			_mm512_mask_compressstoreu_epi64(out, lanes, _mm512_loadu_si512(in + i));
+			out += bitword::countSetBits(static_cast<u8>(lanes));
+		}
+		return out;
+	}
+};
+
+#if defined(DD_COMPACTION_AVX512_VBMI2)
+
+template<>
+struct Compress<u8>
+{
+	static constexpr bool Native = true;
+	static constexpr bool Bounded = false;
+
+	static inline u8* word(BitWordType mask, const u8* in, u8* out, const u8* /*outEnd*/)
+	{
+		_mm512_mask_compressstoreu_epi8(out, mask, _mm512_loadu_si512(in));
+		return out + bitword::countSetBits(mask);
+	}
+};
+
+template<>
+struct Compress<u16>
+{
+	static constexpr bool Native = true;
+	static constexpr bool Bounded = false;
+
+	static inline u16* word(BitWordType mask, const u16* in, u16* out, const u16* /*outEnd*/)
+	{
+		for (u32 i = 0; i < NumBitsInWord; i += 32)
+		{
+			const __mmask32 lanes = static_cast<__mmask32>(mask >> i);
+			_mm512_mask_compressstoreu_epi16(out, lanes, _mm512_loadu_si512(in + i));
+			out += bitword::countSetBits(static_cast<u32>(lanes));
+		}
+		return out;
+	}
+};
+
+#endif
+
+#elif defined(DD_COMPACTION_AVX2)
+
+// byte k of an entry is the lane of the k:th set bit of the entry index, unused bytes are zero
+struct ShuffleTables
+{
+	u64 lanesOf8[256];
+	u64 dwordsOf4[16]; // the same for 4 u64 lanes expressed as pairs of u32 lanes for permutevar8x32
+};
+
+constexpr ShuffleTables makeShuffleTables()
+{
+	ShuffleTables tables{};
+	for (u32 mask = 0; mask < 256; ++mask)
+	{
+		u32 count = 0;
+		for (u32 lane = 0; lane < 8; ++lane)
+		{
+			if ((mask >> lane) & 1)
+				tables.lanesOf8[mask] |= static_cast<u64>(lane) << (8 * count++);
+		}
+	}
+
+	for (u32 mask = 0; mask < 16; ++mask)
+	{
+		u32 count = 0;
+		for (u32 lane = 0; lane < 4; ++lane)
+		{
+			if ((mask >> lane) & 1)
+			{
+				tables.dwordsOf4[mask] |= static_cast<u64>(2 * lane) << (8 * count++);
+				tables.dwordsOf4[mask] |= static_cast<u64>(2 * lane + 1) << (8 * count++);
+			}
+		}
+	}
+	return tables;
+}
+
+constexpr ShuffleTables Shuffle = makeShuffleTables();
+
+inline __m256i loadPermutation(u64 entry)
+{
+	return _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(entry)));
+}
+
+// every group of 8 u32 lanes is permuted to the front and stored as a whole vector, the pointer then advances by the selected count
+// the unselected tail of the store is overwritten by the next group, close to outEnd the group is written value by value instead
+template<>
+struct Compress<u32>
+{
+	static constexpr bool Native = true;
+	static constexpr bool Bounded = true;
+
+	static inline u32* word(BitWordType mask, const u32* in, u32* out, const u32* outEnd)
+	{
+		for (u32 i = 0; i < NumBitsInWord; i += 8)
+		{
+			const u32 lanes = static_cast<u32>(mask >> i) & 0xFF;
+			if (out + 8 <= outEnd)
+			{
+				const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(values, loadPermutation(Shuffle.lanesOf8[lanes])));
+				out += bitword::countSetBits(lanes);
+			}
+			else
+			{
+				out = compactScalar<u32>(lanes, in + i, out);
+			}
+		}
+		return out;
+	}
+};
+
+template<>
+struct Compress<u64>
+{
+	static constexpr bool Native = true;
+	static constexpr bool Bounded = true;
+
+	static inline u64* word(BitWordType mask, const u64* in, u64* out, const u64* outEnd)
+	{
+		for (u32 i = 0; i < NumBitsInWord; i += 4)
+		{
+			const u32 lanes = static_cast<u32>(mask >> i) & 0xF;
+			if (out + 4 <= outEnd)
+			{
+				const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(values, loadPermutation(Shuffle.dwordsOf4[lanes])));
+				out += bitword::countSetBits(lanes);
+			}
+			else
+			{
+				out = compactScalar<u64>(lanes, in + i, out);
+			}
+		}
+		return out;
+	}
+};
+
+#endif
+
+template<typename Action>
+void visitValueType(u32 valueSize, Action&& action)
+{
+	switch (valueSize)
+	{
+	case 1: action(u8{}); break;
+	case 2: action(u16{}); break;
+	case 4: action(u32{}); break;
+	case 8: action(u64{}); break;
+	default: DD_ASSERT(false); break;
+	}
+}
+
+inline BitWordType getTailMask(const ConstBitSpan& selection)
+{
+	const u32 numValues = selection.numBits();
+	return selection.data()[numValues / NumBitsInWord] & bitword::getDanglingPart(numValues);
+}
+
+template<typename T>
+u32 compactImpl(const ConstBitSpan& selection, const T* values, T* out)
+{
+	const u32 numFullWords = selection.numBits() / NumBitsInWord;
+	const BitWordType* words = selection.data();
+	const T* outEnd = Compress<T>::Bounded ? out + selection.countSetBits() : nullptr;
+	T* it = out;
+
+	for (u32 word = 0; word < numFullWords; ++word)
+	{
+		const BitWordType mask = words[word];
+		const T* in = values + word * NumBitsInWord;
+
+		if (mask == bitword::Zero)
+			continue;
+
+		if (mask == bitword::Ones)
+		{
+			std::memcpy(it, in, sizeof(T) * NumBitsInWord);
+			it += NumBitsInWord;
+			continue;
+		}
+
+		it = Compress<T>::word(mask, in, it, outEnd);
+	}
+
+	// vector loads of the last word would read past the values
+	if (bitword::hasDanglingPart(selection.numBits()))
+		it = compactScalar(getTailMask(selection), values + numFullWords * NumBitsInWord, it);
+
+	return static_cast<u32>(it - out);
+}
+
+template<typename T, typename Source>
+inline u32 compactAs(const ConstBitSpan& selection, const Source* values, Source* out)
+{
+	static_assert(sizeof(T) == sizeof(Source));
+	return compactImpl(selection, reinterpret_cast<const T*>(values), reinterpret_cast<T*>(out));
+}
+
+}
+
+u32 compact(const ConstBitSpan& selection, const u8* values, u8* out) { return compactImpl(selection, values, out); }
+u32 compact(const ConstBitSpan& selection, const u16* values, u16* out) { return compactImpl(selection, values, out); }
+u32 compact(const ConstBitSpan& selection, const u32* values, u32* out) { return compactImpl(selection, values, out); }
+u32 compact(const ConstBitSpan& selection, const u64* values, u64* out) { return compactImpl(selection, values, out); }
+u32 compact(const ConstBitSpan& selection, const float* values, float* out) { return compactAs<u32>(selection, values, out); }
+u32 compact(const ConstBitSpan& selection, const double* values, double* out) { return compactAs<u64>(selection, values, out); }
+
+u32 compactColumns(const ConstBitSpan& selection, const Column* columns, u32 numColumns)
+{
+	const u32 numFullWords = selection.numBits() / NumBitsInWord;
+	const BitWordType* words = selection.data();
+	const u32 numSelected = selection.countSetBits();
+	u32 numWritten = 0;
+	DecodedWord decoded;
+
+	for (u32 word = 0; word < numFullWords; ++word)
+	{
+		const BitWordType mask = words[word];
+		const u32 first = word * NumBitsInWord;
+
+		if (mask == bitword::Zero)
+			continue;
+
+		if (mask == bitword::Ones)
+		{
+			for (u32 c = 0; c < numColumns; ++c)
+			{
+				const Column& column = columns[c];
+				std::memcpy(static_cast<u8*>(column.out) + numWritten * column.valueSize, static_cast<const u8*>(column.values) + first * column.valueSize, column.valueSize * NumBitsInWord);
+			}
+			numWritten += NumBitsInWord;
+			continue;
+		}
+
+		bool isDecoded = false;
+		for (u32 c = 0; c < numColumns; ++c)
+		{
+			const Column& column = columns[c];
+			visitValueType(column.valueSize, [&](auto type) {
+				using T = decltype(type);
+				const T* in = static_cast<const T*>(column.values) + first;
+				T* out = static_cast<T*>(column.out) + numWritten;
+
+				if constexpr (Compress<T>::Native)
+				{
+					Compress<T>::word(mask, in, out, static_cast<T*>(column.out) + numSelected);
+				}
+				else
+				{
+					if (!isDecoded)
+						decode(mask, decoded);
+					isDecoded = true;
+					gather(decoded, in, out);
+				}
+			});
+		}
+		numWritten += bitword::countSetBits(mask);
+	}
+
+	if (bitword::hasDanglingPart(selection.numBits()))
+	{
+		decode(getTailMask(selection), decoded);
+		const u32 first = numFullWords * NumBitsInWord;
+
+		for (u32 c = 0; c < numColumns; ++c)
+		{
+			const Column& column = columns[c];
+			visitValueType(column.valueSize, [&](auto type) {
+				using T = decltype(type);
+				gather(decoded, static_cast<const T*>(column.values) + first, static_cast<T*>(column.out) + numWritten);
+			});
+		}
+		numWritten += decoded.count;
+	}
+
+	return numWritten;
+}
+
+}
+}